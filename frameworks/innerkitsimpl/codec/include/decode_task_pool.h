@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DECODE_TASK_POOL_H
+#define DECODE_TASK_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "image_type.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+struct DecodeTask {
+    std::function<void()> run;
+    // called instead of run if the task is removed before running.
+    std::function<void()> cancel;
+    DecodePriority priority = DecodePriority::NORMAL;
+    const void *owner = nullptr;
+    uint64_t id = 0;  // assigned by DecodeTaskPool::Submit.
+};
+
+// process wide decode threads shared by all image sources, which bounds the decoding concurrency.
+// tasks of higher priority run first, tasks of the same priority run in submitting order.
+class DecodeTaskPool {
+public:
+    static DecodeTaskPool &GetInstance();
+    // return the id of the task.
+    uint64_t Submit(DecodeTask &&task);
+    // cancel a pending task, return false if it is running or done.
+    bool CancelTask(uint64_t taskId);
+    // cancel the pending tasks of the owner, the running ones are not affected.
+    void CancelTasks(const void *owner);
+    // the number of tasks running at the same time, the running tasks are not affected when it is reduced.
+    void SetMaxWorkers(uint32_t count);
+    uint32_t GetMaxWorkers();
+
+private:
+    DecodeTaskPool();
+    ~DecodeTaskPool();
+    DISALLOW_COPY_AND_MOVE(DecodeTaskPool);
+    void WorkerLoop();
+    size_t GetPendingCount() const;
+    bool PopTask(DecodeTask &task);
+    void CancelIf(const std::function<bool(const DecodeTask &)> &predicate);
+
+    std::mutex mutex_;
+    std::condition_variable taskCond_;
+    std::vector<std::deque<DecodeTask>> queues_;  // indexed by priority.
+    std::vector<std::thread> workers_;
+    size_t maxWorkers_ = 1;
+    size_t idleWorkers_ = 0;
+    size_t runningTasks_ = 0;
+    uint64_t nextTaskId_ = 1;
+    bool isStopped_ = false;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // DECODE_TASK_POOL_H
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DECODER_POOL_H
+#define DECODER_POOL_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "image/abs_image_decoder.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+// process wide idle decoders by encoded format, which are handed over from destroyed image sources to the new
+// ones, so a short-lived source skips creating the decoder and its scratch buffers through the plugin server.
+class DecoderPool {
+public:
+    static DecoderPool &GetInstance();
+    // take an idle decoder of the format, nullptr if there is none.
+    std::unique_ptr<ImagePlugin::AbsImageDecoder> Acquire(const std::string &format);
+    // reset a reusable decoder and keep it if the decoders of the format are not full, otherwise it is destroyed.
+    void Release(const std::string &format, std::unique_ptr<ImagePlugin::AbsImageDecoder> decoder);
+    // the max idle decoders of each format, the extra ones are destroyed. 0 disables the pool.
+    void SetCapacity(uint32_t count);
+    uint32_t GetCapacity();
+    uint32_t GetIdleCount();
+    // destroy all idle decoders, such as on memory pressure.
+    void Clear();
+
+private:
+    using DecoderList = std::vector<std::unique_ptr<ImagePlugin::AbsImageDecoder>>;
+    DecoderPool() = default;
+    ~DecoderPool() = default;
+    DISALLOW_COPY_AND_MOVE(DecoderPool);
+
+    std::mutex mutex_;
+    uint32_t capacity_ = 2;
+    std::map<std::string, DecoderList> idleDecoders_;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // DECODER_POOL_H
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "decode_task_pool.h"
+#include <algorithm>
+#include "image_log.h"
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+
+static constexpr uint32_t MAX_DECODE_THREADS = 4;
+static constexpr uint32_t DECODE_THREADS_LIMIT = 16;
+static constexpr size_t PRIORITY_COUNT = static_cast<size_t>(DecodePriority::HIGH) + 1;
+
+DecodeTaskPool &DecodeTaskPool::GetInstance()
+{
+    static DecodeTaskPool instance;
+    return instance;
+}
+
+DecodeTaskPool::DecodeTaskPool() : queues_(PRIORITY_COUNT)
+{
+    // leave a core to the caller threads.
+    uint32_t cores = thread::hardware_concurrency();
+    maxWorkers_ = max(1u, min(cores > 1 ? cores - 1 : 1u, MAX_DECODE_THREADS));
+}
+
+DecodeTaskPool::~DecodeTaskPool()
+{
+    vector<DecodeTask> canceledTasks;
+    {
+        lock_guard<mutex> guard(mutex_);
+        isStopped_ = true;
+        for (auto &queue : queues_) {
+            move(queue.begin(), queue.end(), back_inserter(canceledTasks));
+            queue.clear();
+        }
+    }
+    taskCond_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    // the pending tasks are never run, their owners may be waiting for them.
+    for (auto &task : canceledTasks) {
+        if (task.cancel != nullptr) {
+            task.cancel();
+        }
+    }
+}
+
+uint64_t DecodeTaskPool::Submit(DecodeTask &&task)
+{
+    size_t priority = min(static_cast<size_t>(max(static_cast<int32_t>(task.priority), 0)), PRIORITY_COUNT - 1);
+    uint64_t taskId = 0;
+    {
+        lock_guard<mutex> guard(mutex_);
+        taskId = nextTaskId_++;
+        task.id = taskId;
+        queues_[priority].push_back(move(task));
+        // threads are created on demand up to the limit.
+        if (GetPendingCount() > idleWorkers_ && workers_.size() < maxWorkers_) {
+            workers_.emplace_back(&DecodeTaskPool::WorkerLoop, this);
+            IMAGE_LOGD("[DecodeTaskPool]start decode thread %{public}zu.", workers_.size());
+        }
+    }
+    taskCond_.notify_one();
+    return taskId;
+}
+
+bool DecodeTaskPool::CancelTask(uint64_t taskId)
+{
+    bool isFound = false;
+    CancelIf([taskId, &isFound](const DecodeTask &task) {
+        if (task.id == taskId) {
+            isFound = true;
+            return true;
+        }
+        return false;
+    });
+    return isFound;
+}
+
+void DecodeTaskPool::CancelTasks(const void *owner)
+{
+    CancelIf([owner](const DecodeTask &task) { return task.owner == owner; });
+}
+
+void DecodeTaskPool::CancelIf(const function<bool(const DecodeTask &)> &predicate)
+{
+    vector<DecodeTask> canceledTasks;
+    {
+        lock_guard<mutex> guard(mutex_);
+        for (auto &queue : queues_) {
+            auto iter = stable_partition(queue.begin(), queue.end(),
+                [&predicate](const DecodeTask &task) { return !predicate(task); });
+            move(iter, queue.end(), back_inserter(canceledTasks));
+            queue.erase(iter, queue.end());
+        }
+    }
+    for (auto &task : canceledTasks) {
+        if (task.cancel != nullptr) {
+            task.cancel();
+        }
+    }
+}
+
+void DecodeTaskPool::SetMaxWorkers(uint32_t count)
+{
+    {
+        lock_guard<mutex> guard(mutex_);
+        maxWorkers_ = min(max(count, 1u), DECODE_THREADS_LIMIT);
+        // each new thread takes one of the pending tasks which the idle threads can't take.
+        size_t pendingCount = GetPendingCount();
+        while (pendingCount > idleWorkers_ && workers_.size() < maxWorkers_) {
+            workers_.emplace_back(&DecodeTaskPool::WorkerLoop, this);
+            pendingCount--;
+        }
+    }
+    taskCond_.notify_all();
+}
+
+uint32_t DecodeTaskPool::GetMaxWorkers()
+{
+    lock_guard<mutex> guard(mutex_);
+    return static_cast<uint32_t>(maxWorkers_);
+}
+
+size_t DecodeTaskPool::GetPendingCount() const
+{
+    size_t count = 0;
+    for (const auto &queue : queues_) {
+        count += queue.size();
+    }
+    return count;
+}
+
+bool DecodeTaskPool::PopTask(DecodeTask &task)
+{
+    for (auto queue = queues_.rbegin(); queue != queues_.rend(); ++queue) {
+        if (!queue->empty()) {
+            task = move(queue->front());
+            queue->pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void DecodeTaskPool::WorkerLoop()
+{
+    while (true) {
+        DecodeTask task;
+        {
+            unique_lock<mutex> guard(mutex_);
+            idleWorkers_++;
+            taskCond_.wait(guard, [this, &task] {
+                return isStopped_ || (runningTasks_ < maxWorkers_ && PopTask(task));
+            });
+            idleWorkers_--;
+            if (isStopped_ && task.run == nullptr) {
+                return;
+            }
+            runningTasks_++;
+        }
+        task.run();
+        {
+            lock_guard<mutex> guard(mutex_);
+            runningTasks_--;
+        }
+        // a worker waiting for the running limit may go on.
+        taskCond_.notify_one();
+    }
+}
+} // namespace Media
+} // namespace OHOS
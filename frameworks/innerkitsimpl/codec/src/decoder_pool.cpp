@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "decoder_pool.h"
+#include "image_log.h"
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+using namespace ImagePlugin;
+
+DecoderPool &DecoderPool::GetInstance()
+{
+    static DecoderPool instance;
+    return instance;
+}
+
+unique_ptr<AbsImageDecoder> DecoderPool::Acquire(const string &format)
+{
+    lock_guard<mutex> guard(mutex_);
+    auto iter = idleDecoders_.find(format);
+    if (iter == idleDecoders_.end() || iter->second.empty()) {
+        return nullptr;
+    }
+    unique_ptr<AbsImageDecoder> decoder = move(iter->second.back());
+    iter->second.pop_back();
+    return decoder;
+}
+
+void DecoderPool::Release(const string &format, unique_ptr<AbsImageDecoder> decoder)
+{
+    if (decoder == nullptr || format.empty() || !decoder->IsReusable()) {
+        return;
+    }
+    // the decoder drops the source stream here, which is destroyed with its image source.
+    decoder->Reset();
+    lock_guard<mutex> guard(mutex_);
+    DecoderList &decoders = idleDecoders_[format];
+    if (decoders.size() < capacity_) {
+        decoders.push_back(move(decoder));
+        return;
+    }
+    IMAGE_LOGD("[DecoderPool]idle decoders of %{public}s are full, destroy the decoder.", format.c_str());
+}
+
+void DecoderPool::SetCapacity(uint32_t count)
+{
+    // the decoders are destroyed out of the lock.
+    DecoderList extraDecoders;
+    {
+        lock_guard<mutex> guard(mutex_);
+        capacity_ = count;
+        for (auto &item : idleDecoders_) {
+            DecoderList &decoders = item.second;
+            while (decoders.size() > capacity_) {
+                extraDecoders.push_back(move(decoders.back()));
+                decoders.pop_back();
+            }
+        }
+    }
+}
+
+uint32_t DecoderPool::GetCapacity()
+{
+    lock_guard<mutex> guard(mutex_);
+    return capacity_;
+}
+
+uint32_t DecoderPool::GetIdleCount()
+{
+    lock_guard<mutex> guard(mutex_);
+    size_t count = 0;
+    for (const auto &item : idleDecoders_) {
+        count += item.second.size();
+    }
+    return static_cast<uint32_t>(count);
+}
+
+void DecoderPool::Clear()
+{
+    map<string, DecoderList> idleDecoders;
+    {
+        lock_guard<mutex> guard(mutex_);
+        idleDecoders.swap(idleDecoders_);
+    }
+    IMAGE_LOGD("[DecoderPool]clear idle decoders of %{public}zu formats.", idleDecoders.size());
+}
+} // namespace Media
+} // namespace OHOS
@@ -101,11 +101,12 @@ uint32_t ImagePacker::StartPacking(const std::string &filePath, const PackOption
                      option.quality);
         return ERR_IMAGE_INVALID_PARAMETER;
     }
-    FilePackerStream *stream = new (std::nothrow) FilePackerStream(filePath);
+    FilePackerStream *stream = new (std::nothrow) FilePackerStream(filePath, option.isAtomic);
     if (stream == nullptr) {
         HiLog::Error(LABEL, "make file packer stream failed.");
         return ERR_IMAGE_DATA_ABNORMAL;
     }
+    stream->SetBufferSize(option.bufferSize);
     FreeOldPackerStream();
     packerStream_ = std::unique_ptr<FilePackerStream>(stream);
     return StartPackingImpl(option);
@@ -123,6 +124,7 @@ uint32_t ImagePacker::StartPacking(const int &fd, const PackOption &option)
         HiLog::Error(LABEL, "make file packer stream failed.");
         return ERR_IMAGE_DATA_ABNORMAL;
     }
+    stream->SetBufferSize(option.bufferSize);
     FreeOldPackerStream();
     packerStream_ = std::unique_ptr<FilePackerStream>(stream);
     return StartPackingImpl(option);
@@ -205,7 +207,13 @@ uint32_t ImagePacker::FinalizePacking()
         HiLog::Error(LABEL, "FinalizePacking get encoder plugin failed.");
         return ERR_IMAGE_MISMATCHED_FORMAT;
     }
-    return encoder_->FinalizeEncode();
+    uint32_t ret = encoder_->FinalizeEncode();
+    // not every encoder flushes the stream, the buffered data is written and the atomic file is replaced here.
+    // a failed packing is not flushed, so its atomic file is removed with the stream.
+    if (ret == SUCCESS && packerStream_ != nullptr) {
+        packerStream_->Flush();
+    }
+    return ret;
 }
 
 uint32_t ImagePacker::FinalizePacking(int64_t &packedSize)
@@ -0,0 +1,815 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_probe.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "image_log.h"
+#include "image_utils.h"
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+
+namespace {
+constexpr size_t READ_WINDOW_SIZE = 4096;
+constexpr int32_t ORIENTATION_MIN = 1;
+constexpr int32_t ORIENTATION_MAX = 8;
+constexpr int32_t ORIENTATION_ROTATE_90 = 6;
+constexpr int32_t ORIENTATION_ROTATE_180 = 3;
+constexpr int32_t ORIENTATION_ROTATE_270 = 8;
+
+// jpeg
+constexpr uint8_t JPEG_MARKER_PREFIX = 0xFF;
+constexpr uint8_t JPEG_SOI = 0xD8;
+constexpr uint8_t JPEG_EOI = 0xD9;
+constexpr uint8_t JPEG_SOS = 0xDA;
+constexpr uint8_t JPEG_APP1 = 0xE1;
+constexpr uint8_t JPEG_SOF0 = 0xC0;
+constexpr uint8_t JPEG_SOF15 = 0xCF;
+constexpr uint8_t JPEG_DHT = 0xC4;
+constexpr uint8_t JPEG_JPG = 0xC8;
+constexpr uint8_t JPEG_DAC = 0xCC;
+constexpr uint8_t JPEG_TEM = 0x01;
+constexpr uint8_t JPEG_RST0 = 0xD0;
+constexpr uint8_t JPEG_RST7 = 0xD7;
+constexpr uint32_t JPEG_SOF_SIZE = 5;  // precision, height and width.
+constexpr uint8_t EXIF_HEADER[] = { 'E', 'x', 'i', 'f', 0, 0 };
+
+// tiff structure of exif data
+constexpr uint32_t TIFF_HEADER_SIZE = 8;
+constexpr uint32_t TIFF_ENTRY_SIZE = 12;
+constexpr uint16_t TIFF_MAGIC = 42;
+constexpr uint16_t TIFF_TAG_ORIENTATION = 0x0112;
+constexpr uint16_t TIFF_TYPE_SHORT = 3;
+
+// png
+constexpr uint8_t PNG_SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+constexpr uint32_t PNG_CHUNK_HEADER_SIZE = 8;
+constexpr uint32_t PNG_CHUNK_CRC_SIZE = 4;
+constexpr uint32_t PNG_IHDR_SIZE = 8;  // width and height.
+constexpr uint32_t PNG_ACTL_SIZE = 4;  // number of frames.
+
+// gif
+constexpr uint32_t GIF_HEADER_SIZE = 13;
+constexpr uint8_t GIF_IMAGE_SEPARATOR = 0x2C;
+constexpr uint8_t GIF_EXTENSION_INTRODUCER = 0x21;
+constexpr uint8_t GIF_TRAILER = 0x3B;
+constexpr uint32_t GIF_IMAGE_DESCRIPTOR_SIZE = 10;  // separator, position, size and flags.
+constexpr uint8_t GIF_COLOR_TABLE_FLAG = 0x80;
+constexpr uint8_t GIF_COLOR_TABLE_SIZE_MASK = 0x07;
+constexpr uint32_t GIF_COLOR_SIZE = 3;
+
+// webp
+constexpr uint32_t RIFF_HEADER_SIZE = 12;
+constexpr uint32_t RIFF_CHUNK_HEADER_SIZE = 8;
+constexpr uint32_t VP8_FRAME_HEADER_SIZE = 10;
+constexpr uint8_t VP8_START_CODE[] = { 0x9D, 0x01, 0x2A };
+constexpr uint32_t VP8_START_CODE_OFFSET = 3;
+constexpr uint16_t VP8_SIZE_MASK = 0x3FFF;
+constexpr uint32_t VP8L_HEADER_SIZE = 5;
+constexpr uint8_t VP8L_SIGNATURE = 0x2F;
+constexpr uint32_t VP8L_SIZE_BITS = 14;
+constexpr uint32_t VP8X_HEADER_SIZE = 10;
+constexpr uint8_t VP8X_ANIMATION_FLAG = 0x02;
+constexpr uint32_t VP8X_CANVAS_WIDTH_OFFSET = 4;
+constexpr uint32_t VP8X_CANVAS_HEIGHT_OFFSET = 7;
+
+// bmp
+constexpr uint32_t BMP_FILE_HEADER_SIZE = 14;
+constexpr uint32_t BMP_CORE_HEADER_SIZE = 12;
+constexpr uint32_t BMP_INFO_HEADER_MIN_SIZE = 12;  // size, width and height of BITMAPINFOHEADER.
+
+// wbmp
+constexpr uint32_t WBMP_MAX_INT_BYTES = 4;
+constexpr uint8_t WBMP_CONTINUE_FLAG = 0x80;
+constexpr uint8_t WBMP_VALUE_MASK = 0x7F;
+constexpr uint32_t WBMP_VALUE_BITS = 7;
+
+// heif
+constexpr uint32_t BOX_HEADER_SIZE = 8;
+constexpr uint32_t BOX_LARGE_SIZE_SIZE = 8;
+constexpr uint32_t FULL_BOX_HEADER_SIZE = 4;  // version and flags.
+constexpr uint32_t ISPE_SIZE = 8;
+constexpr uint8_t IROT_ANGLE_MASK = 0x03;
+constexpr uint16_t IPMA_LARGE_INDEX_MASK = 0x7FFF;
+constexpr uint8_t IPMA_SMALL_INDEX_MASK = 0x7F;
+const vector<string> HEIF_BRANDS = { "heic", "heix", "hevc", "hevx", "heim", "heis", "mif1", "msf1" };
+
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint32_t SHORT_BYTES = 2;
+constexpr uint32_t INT_BYTES = 4;
+
+const string FORMAT_JPEG = "image/jpeg";
+const string FORMAT_PNG = "image/png";
+const string FORMAT_GIF = "image/gif";
+const string FORMAT_WEBP = "image/webp";
+const string FORMAT_BMP = "image/bmp";
+const string FORMAT_WBMP = "image/vnd.wap.wbmp";
+const string FORMAT_HEIF = "image/heif";
+
+uint16_t GetBigEndian16(const uint8_t *data)
+{
+    return static_cast<uint16_t>((data[0] << BYTE_BITS) | data[1]);
+}
+
+uint32_t GetBigEndian32(const uint8_t *data)
+{
+    return (static_cast<uint32_t>(GetBigEndian16(data)) << (SHORT_BYTES * BYTE_BITS)) |
+           GetBigEndian16(data + SHORT_BYTES);
+}
+
+uint16_t GetLittleEndian16(const uint8_t *data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << BYTE_BITS));
+}
+
+uint32_t GetLittleEndian24(const uint8_t *data)
+{
+    return static_cast<uint32_t>(GetLittleEndian16(data)) | (static_cast<uint32_t>(data[SHORT_BYTES]) <<
+        (SHORT_BYTES * BYTE_BITS));
+}
+
+uint32_t GetLittleEndian32(const uint8_t *data)
+{
+    return static_cast<uint32_t>(GetLittleEndian16(data)) |
+           (static_cast<uint32_t>(GetLittleEndian16(data + SHORT_BYTES)) << (SHORT_BYTES * BYTE_BITS));
+}
+
+// random access to the source, file sources are read through a small window so that skipping over segments
+// doesn't read them.
+class ProbeReader {
+public:
+    ProbeReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+    ProbeReader(FILE *file, size_t offset, size_t size) : file_(file), fileOffset_(offset), size_(size) {}
+    ~ProbeReader() = default;
+    size_t GetSize() const
+    {
+        return size_;
+    }
+    // the returned bytes are valid until the next call, nullptr if they are beyond the end of the source.
+    const uint8_t *Read(size_t offset, size_t length);
+    bool Match(size_t offset, const uint8_t *expected, size_t length)
+    {
+        const uint8_t *data = Read(offset, length);
+        return data != nullptr && memcmp(data, expected, length) == 0;
+    }
+
+private:
+    const uint8_t *data_ = nullptr;
+    FILE *file_ = nullptr;
+    size_t fileOffset_ = 0;
+    size_t size_ = 0;
+    vector<uint8_t> window_;
+    size_t windowOffset_ = 0;
+};
+
+const uint8_t *ProbeReader::Read(size_t offset, size_t length)
+{
+    if (length == 0 || offset > size_ || length > size_ - offset) {
+        return nullptr;
+    }
+    if (data_ != nullptr) {
+        return data_ + offset;
+    }
+    if (offset >= windowOffset_ && offset - windowOffset_ + length <= window_.size()) {
+        return window_.data() + (offset - windowOffset_);
+    }
+    size_t readSize = min(max(length, READ_WINDOW_SIZE), size_ - offset);
+    window_.resize(readSize);
+    if (fseek(file_, static_cast<long>(fileOffset_ + offset), SEEK_SET) != 0 ||
+        fread(window_.data(), 1, readSize, file_) != readSize) {
+        IMAGE_LOGE("[ImageProbe]read %{public}zu bytes at %{public}zu fail.", readSize, offset);
+        window_.clear();
+        return nullptr;
+    }
+    windowOffset_ = offset;
+    return window_.data();
+}
+
+int32_t GetTiffOrientation(const uint8_t *tiff, uint32_t size)
+{
+    if (tiff == nullptr || size < TIFF_HEADER_SIZE) {
+        return ORIENTATION_MIN;
+    }
+    bool isBigEndian = (tiff[0] == 'M' && tiff[1] == 'M');
+    if (!isBigEndian && !(tiff[0] == 'I' && tiff[1] == 'I')) {
+        return ORIENTATION_MIN;
+    }
+    auto get16 = [isBigEndian](const uint8_t *data) {
+        return isBigEndian ? GetBigEndian16(data) : GetLittleEndian16(data);
+    };
+    auto get32 = [isBigEndian](const uint8_t *data) {
+        return isBigEndian ? GetBigEndian32(data) : GetLittleEndian32(data);
+    };
+    uint32_t ifdOffset = get32(tiff + INT_BYTES);
+    if (get16(tiff + SHORT_BYTES) != TIFF_MAGIC || ifdOffset > size - SHORT_BYTES) {
+        return ORIENTATION_MIN;
+    }
+    uint32_t entryCount = get16(tiff + ifdOffset);
+    uint32_t entryOffset = ifdOffset + SHORT_BYTES;
+    for (uint32_t i = 0; i < entryCount && entryOffset <= size - TIFF_ENTRY_SIZE; i++) {
+        const uint8_t *entry = tiff + entryOffset;
+        if (get16(entry) == TIFF_TAG_ORIENTATION && get16(entry + SHORT_BYTES) == TIFF_TYPE_SHORT) {
+            int32_t orientation = get16(entry + SHORT_BYTES + SHORT_BYTES + INT_BYTES);
+            return (orientation >= ORIENTATION_MIN && orientation <= ORIENTATION_MAX) ? orientation :
+                ORIENTATION_MIN;
+        }
+        entryOffset += TIFF_ENTRY_SIZE;
+    }
+    return ORIENTATION_MIN;
+}
+
+bool IsJpegSofMarker(uint8_t marker)
+{
+    return marker >= JPEG_SOF0 && marker <= JPEG_SOF15 && marker != JPEG_DHT && marker != JPEG_JPG &&
+           marker != JPEG_DAC;
+}
+
+uint32_t ProbeJpeg(ProbeReader &reader, ImageProbeInfo &info)
+{
+    size_t offset = SHORT_BYTES;  // after SOI.
+    while (true) {
+        const uint8_t *marker = reader.Read(offset, SHORT_BYTES);
+        if (marker == nullptr || marker[0] != JPEG_MARKER_PREFIX) {
+            return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+        }
+        uint8_t code = marker[1];
+        if (code == JPEG_MARKER_PREFIX) {
+            offset++;  // fill byte.
+            continue;
+        }
+        offset += SHORT_BYTES;
+        if (code == JPEG_SOI || code == JPEG_TEM || (code >= JPEG_RST0 && code <= JPEG_RST7)) {
+            continue;
+        }
+        if (code == JPEG_EOI || code == JPEG_SOS) {
+            return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+        }
+        const uint8_t *length = reader.Read(offset, SHORT_BYTES);
+        if (length == nullptr || GetBigEndian16(length) < SHORT_BYTES) {
+            return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+        }
+        uint32_t segmentSize = GetBigEndian16(length) - SHORT_BYTES;
+        size_t segmentOffset = offset + SHORT_BYTES;
+        if (IsJpegSofMarker(code)) {
+            const uint8_t *sof = reader.Read(segmentOffset, JPEG_SOF_SIZE);
+            if (segmentSize < JPEG_SOF_SIZE || sof == nullptr) {
+                return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+            }
+            info.size.height = GetBigEndian16(sof + 1);
+            info.size.width = GetBigEndian16(sof + 1 + SHORT_BYTES);
+            return SUCCESS;
+        }
+        if (code == JPEG_APP1 && segmentSize > sizeof(EXIF_HEADER) &&
+            reader.Match(segmentOffset, EXIF_HEADER, sizeof(EXIF_HEADER))) {
+            uint32_t tiffSize = segmentSize - sizeof(EXIF_HEADER);
+            info.orientation = GetTiffOrientation(reader.Read(segmentOffset + sizeof(EXIF_HEADER), tiffSize),
+                                                  tiffSize);
+        }
+        offset = segmentOffset + segmentSize;
+    }
+}
+
+uint32_t ProbePng(ProbeReader &reader, ImageProbeInfo &info)
+{
+    size_t offset = sizeof(PNG_SIGNATURE);
+    const uint8_t *chunk = reader.Read(offset, PNG_CHUNK_HEADER_SIZE + PNG_IHDR_SIZE);
+    if (chunk == nullptr || memcmp(chunk + INT_BYTES, "IHDR", INT_BYTES) != 0) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    info.size.width = static_cast<int32_t>(GetBigEndian32(chunk + PNG_CHUNK_HEADER_SIZE));
+    info.size.height = static_cast<int32_t>(GetBigEndian32(chunk + PNG_CHUNK_HEADER_SIZE + INT_BYTES));
+    // frame count of apng and exif are before the image data.
+    while ((chunk = reader.Read(offset, PNG_CHUNK_HEADER_SIZE)) != nullptr) {
+        uint32_t chunkSize = GetBigEndian32(chunk);
+        const uint8_t *type = chunk + INT_BYTES;
+        if (memcmp(type, "IDAT", INT_BYTES) == 0 || memcmp(type, "IEND", INT_BYTES) == 0) {
+            break;
+        }
+        size_t dataOffset = offset + PNG_CHUNK_HEADER_SIZE;
+        if (memcmp(type, "acTL", INT_BYTES) == 0 && chunkSize >= PNG_ACTL_SIZE) {
+            const uint8_t *frames = reader.Read(dataOffset, PNG_ACTL_SIZE);
+            if (frames != nullptr && GetBigEndian32(frames) > 0) {
+                info.frameCount = GetBigEndian32(frames);
+            }
+        } else if (memcmp(type, "eXIf", INT_BYTES) == 0) {
+            info.orientation = GetTiffOrientation(reader.Read(dataOffset, chunkSize), chunkSize);
+        }
+        offset = dataOffset + chunkSize + PNG_CHUNK_CRC_SIZE;
+    }
+    return SUCCESS;
+}
+
+bool SkipGifSubBlocks(ProbeReader &reader, size_t &offset)
+{
+    const uint8_t *blockSize = nullptr;
+    while ((blockSize = reader.Read(offset, 1)) != nullptr) {
+        offset += 1 + *blockSize;
+        if (*blockSize == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t ProbeGif(ProbeReader &reader, ImageProbeInfo &info)
+{
+    const uint8_t *header = reader.Read(0, GIF_HEADER_SIZE);
+    if (header == nullptr) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    const uint32_t screenOffset = 6;  // after "GIF89a".
+    info.size.width = GetLittleEndian16(header + screenOffset);
+    info.size.height = GetLittleEndian16(header + screenOffset + SHORT_BYTES);
+    uint8_t flags = header[screenOffset + INT_BYTES];
+    size_t offset = GIF_HEADER_SIZE;
+    if ((flags & GIF_COLOR_TABLE_FLAG) != 0) {
+        offset += GIF_COLOR_SIZE << ((flags & GIF_COLOR_TABLE_SIZE_MASK) + 1);
+    }
+    // frames of a truncated gif are counted until the data ends.
+    uint32_t frameCount = 0;
+    const uint8_t *block = nullptr;
+    while ((block = reader.Read(offset, 1)) != nullptr && *block != GIF_TRAILER) {
+        if (*block == GIF_IMAGE_SEPARATOR) {
+            const uint8_t *descriptor = reader.Read(offset, GIF_IMAGE_DESCRIPTOR_SIZE);
+            if (descriptor == nullptr) {
+                break;
+            }
+            uint8_t imageFlags = descriptor[GIF_IMAGE_DESCRIPTOR_SIZE - 1];
+            offset += GIF_IMAGE_DESCRIPTOR_SIZE;
+            if ((imageFlags & GIF_COLOR_TABLE_FLAG) != 0) {
+                offset += GIF_COLOR_SIZE << ((imageFlags & GIF_COLOR_TABLE_SIZE_MASK) + 1);
+            }
+            offset++;  // lzw minimum code size.
+            if (!SkipGifSubBlocks(reader, offset)) {
+                break;
+            }
+            frameCount++;
+        } else if (*block == GIF_EXTENSION_INTRODUCER) {
+            offset += SHORT_BYTES;  // introducer and label.
+            if (!SkipGifSubBlocks(reader, offset)) {
+                break;
+            }
+        } else {
+            break;
+        }
+    }
+    info.frameCount = max(frameCount, 1u);
+    return SUCCESS;
+}
+
+uint32_t ProbeVp8(const uint8_t *data, ImageProbeInfo &info)
+{
+    if (memcmp(data + VP8_START_CODE_OFFSET, VP8_START_CODE, sizeof(VP8_START_CODE)) != 0) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    const uint32_t sizeOffset = VP8_START_CODE_OFFSET + sizeof(VP8_START_CODE);
+    info.size.width = GetLittleEndian16(data + sizeOffset) & VP8_SIZE_MASK;
+    info.size.height = GetLittleEndian16(data + sizeOffset + SHORT_BYTES) & VP8_SIZE_MASK;
+    return SUCCESS;
+}
+
+uint32_t ProbeVp8l(const uint8_t *data, ImageProbeInfo &info)
+{
+    if (data[0] != VP8L_SIGNATURE) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    const uint32_t sizeMask = (1u << VP8L_SIZE_BITS) - 1;
+    uint32_t bits = GetLittleEndian32(data + 1);
+    info.size.width = static_cast<int32_t>((bits & sizeMask) + 1);
+    info.size.height = static_cast<int32_t>(((bits >> VP8L_SIZE_BITS) & sizeMask) + 1);
+    return SUCCESS;
+}
+
+uint32_t ProbeWebp(ProbeReader &reader, ImageProbeInfo &info)
+{
+    size_t offset = RIFF_HEADER_SIZE;
+    const uint8_t *chunk = reader.Read(offset, RIFF_CHUNK_HEADER_SIZE);
+    if (chunk == nullptr) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    size_t payloadOffset = offset + RIFF_CHUNK_HEADER_SIZE;
+    const uint8_t *payload = nullptr;
+    if (memcmp(chunk, "VP8 ", INT_BYTES) == 0) {
+        payload = reader.Read(payloadOffset, VP8_FRAME_HEADER_SIZE);
+        return (payload == nullptr) ? ERR_IMAGE_DECODE_HEAD_ABNORMAL : ProbeVp8(payload, info);
+    }
+    if (memcmp(chunk, "VP8L", INT_BYTES) == 0) {
+        payload = reader.Read(payloadOffset, VP8L_HEADER_SIZE);
+        return (payload == nullptr) ? ERR_IMAGE_DECODE_HEAD_ABNORMAL : ProbeVp8l(payload, info);
+    }
+    if (memcmp(chunk, "VP8X", INT_BYTES) != 0 || (payload = reader.Read(payloadOffset, VP8X_HEADER_SIZE)) == nullptr) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    bool isAnimated = (payload[0] & VP8X_ANIMATION_FLAG) != 0;
+    info.size.width = static_cast<int32_t>(GetLittleEndian24(payload + VP8X_CANVAS_WIDTH_OFFSET) + 1);
+    info.size.height = static_cast<int32_t>(GetLittleEndian24(payload + VP8X_CANVAS_HEIGHT_OFFSET) + 1);
+    uint32_t frameCount = 0;
+    while ((chunk = reader.Read(offset, RIFF_CHUNK_HEADER_SIZE)) != nullptr) {
+        uint32_t chunkSize = GetLittleEndian32(chunk + INT_BYTES);
+        size_t dataOffset = offset + RIFF_CHUNK_HEADER_SIZE;
+        if (memcmp(chunk, "ANMF", INT_BYTES) == 0) {
+            frameCount++;
+        } else if (memcmp(chunk, "EXIF", INT_BYTES) == 0) {
+            // some writers keep the jpeg exif header in the chunk.
+            if (chunkSize > sizeof(EXIF_HEADER) && reader.Match(dataOffset, EXIF_HEADER, sizeof(EXIF_HEADER))) {
+                dataOffset += sizeof(EXIF_HEADER);
+                chunkSize -= sizeof(EXIF_HEADER);
+            }
+            info.orientation = GetTiffOrientation(reader.Read(dataOffset, chunkSize), chunkSize);
+        }
+        offset = dataOffset + chunkSize + (chunkSize & 1);  // chunks are padded to even size.
+    }
+    info.frameCount = (isAnimated && frameCount > 0) ? frameCount : 1;
+    return SUCCESS;
+}
+
+uint32_t ProbeBmp(ProbeReader &reader, ImageProbeInfo &info)
+{
+    const uint8_t *header = reader.Read(BMP_FILE_HEADER_SIZE, BMP_INFO_HEADER_MIN_SIZE);
+    if (header == nullptr) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    if (GetLittleEndian32(header) == BMP_CORE_HEADER_SIZE) {
+        info.size.width = GetLittleEndian16(header + INT_BYTES);
+        info.size.height = GetLittleEndian16(header + INT_BYTES + SHORT_BYTES);
+        return SUCCESS;
+    }
+    info.size.width = static_cast<int32_t>(GetLittleEndian32(header + INT_BYTES));
+    // the height of top-down bitmaps is negative.
+    int32_t height = static_cast<int32_t>(GetLittleEndian32(header + INT_BYTES + INT_BYTES));
+    info.size.height = (height < 0 && height != INT32_MIN) ? -height : height;
+    return SUCCESS;
+}
+
+bool ReadWbmpInt(ProbeReader &reader, size_t &offset, uint32_t &value)
+{
+    value = 0;
+    for (uint32_t i = 0; i < WBMP_MAX_INT_BYTES; i++) {
+        const uint8_t *data = reader.Read(offset++, 1);
+        if (data == nullptr) {
+            return false;
+        }
+        value = (value << WBMP_VALUE_BITS) | (*data & WBMP_VALUE_MASK);
+        if ((*data & WBMP_CONTINUE_FLAG) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// wbmp has no signature, the header is accepted if the image data fits the source exactly.
+uint32_t ProbeWbmp(ProbeReader &reader, ImageProbeInfo &info)
+{
+    size_t offset = 0;
+    uint32_t type = 0;
+    uint32_t fixedHeader = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (!ReadWbmpInt(reader, offset, type) || !ReadWbmpInt(reader, offset, fixedHeader) ||
+        !ReadWbmpInt(reader, offset, width) || !ReadWbmpInt(reader, offset, height)) {
+        return ERR_IMAGE_UNKNOWN_FORMAT;
+    }
+    uint64_t dataSize = static_cast<uint64_t>((width + BYTE_BITS - 1) / BYTE_BITS) * height;
+    if (type != 0 || fixedHeader != 0 || width == 0 || height == 0 || offset + dataSize != reader.GetSize()) {
+        return ERR_IMAGE_UNKNOWN_FORMAT;
+    }
+    info.size.width = static_cast<int32_t>(width);
+    info.size.height = static_cast<int32_t>(height);
+    return SUCCESS;
+}
+
+struct HeifBox {
+    string type;
+    size_t offset = 0;      // start of the box.
+    size_t dataOffset = 0;  // start of the box payload.
+    size_t end = 0;
+};
+
+bool ReadHeifBox(ProbeReader &reader, size_t offset, size_t end, HeifBox &box)
+{
+    if (offset > end || end - offset < BOX_HEADER_SIZE) {
+        return false;
+    }
+    const uint8_t *header = reader.Read(offset, BOX_HEADER_SIZE);
+    if (header == nullptr) {
+        return false;
+    }
+    uint64_t boxSize = GetBigEndian32(header);
+    box.type.assign(reinterpret_cast<const char *>(header + INT_BYTES), INT_BYTES);
+    box.offset = offset;
+    box.dataOffset = offset + BOX_HEADER_SIZE;
+    if (boxSize == 1) {
+        const uint8_t *largeSize = reader.Read(box.dataOffset, BOX_LARGE_SIZE_SIZE);
+        if (largeSize == nullptr) {
+            return false;
+        }
+        boxSize = (static_cast<uint64_t>(GetBigEndian32(largeSize)) << (INT_BYTES * BYTE_BITS)) |
+                  GetBigEndian32(largeSize + INT_BYTES);
+        box.dataOffset += BOX_LARGE_SIZE_SIZE;
+    } else if (boxSize == 0) {
+        boxSize = end - offset;  // the box extends to the end of its parent.
+    }
+    if (boxSize < box.dataOffset - offset || boxSize > end - offset) {
+        return false;
+    }
+    box.end = offset + boxSize;
+    return true;
+}
+
+bool FindHeifBox(ProbeReader &reader, size_t offset, size_t end, const string &type, HeifBox &box)
+{
+    while (offset < end && ReadHeifBox(reader, offset, end, box)) {
+        if (box.type == type) {
+            return true;
+        }
+        offset = box.end;
+    }
+    return false;
+}
+
+bool IsHeifBrand(ProbeReader &reader, const HeifBox &ftyp)
+{
+    // major brand, minor version, then compatible brands.
+    for (size_t offset = ftyp.dataOffset; offset + INT_BYTES <= ftyp.end; offset += INT_BYTES) {
+        if (offset == ftyp.dataOffset + INT_BYTES) {
+            continue;
+        }
+        const uint8_t *brand = reader.Read(offset, INT_BYTES);
+        if (brand == nullptr) {
+            return false;
+        }
+        string brandName(reinterpret_cast<const char *>(brand), INT_BYTES);
+        if (find(HEIF_BRANDS.begin(), HEIF_BRANDS.end(), brandName) != HEIF_BRANDS.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// get the 1-based indexes in ipco of the properties associated with the item.
+bool GetHeifItemProperties(ProbeReader &reader, const HeifBox &ipma, uint32_t itemId, vector<uint32_t> &indexes)
+{
+    const uint8_t *header = reader.Read(ipma.dataOffset, FULL_BOX_HEADER_SIZE + INT_BYTES);
+    if (header == nullptr) {
+        return false;
+    }
+    uint8_t version = header[0];
+    bool isLargeIndex = (header[FULL_BOX_HEADER_SIZE - 1] & 1) != 0;
+    uint32_t entryCount = GetBigEndian32(header + FULL_BOX_HEADER_SIZE);
+    size_t offset = ipma.dataOffset + FULL_BOX_HEADER_SIZE + INT_BYTES;
+    uint32_t idSize = (version < 1) ? SHORT_BYTES : INT_BYTES;
+    uint32_t associationSize = isLargeIndex ? SHORT_BYTES : 1;
+    for (uint32_t i = 0; i < entryCount && offset < ipma.end; i++) {
+        const uint8_t *entry = reader.Read(offset, idSize + 1);
+        if (entry == nullptr) {
+            return false;
+        }
+        uint32_t entryItemId = (idSize == SHORT_BYTES) ? GetBigEndian16(entry) : GetBigEndian32(entry);
+        uint32_t associationCount = entry[idSize];
+        offset += idSize + 1;
+        if (entryItemId != itemId) {
+            offset += associationCount * associationSize;
+            continue;
+        }
+        const uint8_t *associations = reader.Read(offset, associationCount * associationSize);
+        if (associationCount > 0 && associations == nullptr) {
+            return false;
+        }
+        for (uint32_t j = 0; j < associationCount; j++) {
+            indexes.push_back(isLargeIndex ? (GetBigEndian16(associations + j * SHORT_BYTES) & IPMA_LARGE_INDEX_MASK) :
+                (associations[j] & IPMA_SMALL_INDEX_MASK));
+        }
+        return true;
+    }
+    return false;
+}
+
+void ApplyHeifProperty(ProbeReader &reader, const HeifBox &property, ImageProbeInfo &info)
+{
+    if (property.type == "ispe") {
+        const uint8_t *size = reader.Read(property.dataOffset + FULL_BOX_HEADER_SIZE, ISPE_SIZE);
+        if (size != nullptr) {
+            info.size.width = static_cast<int32_t>(GetBigEndian32(size));
+            info.size.height = static_cast<int32_t>(GetBigEndian32(size + INT_BYTES));
+        }
+    } else if (property.type == "irot") {
+        // the angle is anti-clockwise in units of 90 degrees.
+        const uint8_t *angle = reader.Read(property.dataOffset, 1);
+        static const int32_t ORIENTATIONS[] = { ORIENTATION_MIN, ORIENTATION_ROTATE_270, ORIENTATION_ROTATE_180,
+                                                ORIENTATION_ROTATE_90 };
+        if (angle != nullptr) {
+            info.orientation = ORIENTATIONS[*angle & IROT_ANGLE_MASK];
+        }
+    }
+}
+
+uint32_t ProbeHeif(ProbeReader &reader, ImageProbeInfo &info)
+{
+    size_t end = reader.GetSize();
+    HeifBox ftyp;
+    HeifBox meta;
+    if (!ReadHeifBox(reader, 0, end, ftyp) || ftyp.type != "ftyp" || !IsHeifBrand(reader, ftyp)) {
+        return ERR_IMAGE_UNKNOWN_FORMAT;
+    }
+    if (!FindHeifBox(reader, ftyp.end, end, "meta", meta)) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    size_t metaChildren = meta.dataOffset + FULL_BOX_HEADER_SIZE;
+    HeifBox pitm;
+    HeifBox iprp;
+    HeifBox ipco;
+    HeifBox ipma;
+    if (!FindHeifBox(reader, metaChildren, meta.end, "pitm", pitm) ||
+        !FindHeifBox(reader, metaChildren, meta.end, "iprp", iprp) ||
+        !FindHeifBox(reader, iprp.dataOffset, iprp.end, "ipco", ipco) ||
+        !FindHeifBox(reader, iprp.dataOffset, iprp.end, "ipma", ipma)) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    const uint8_t *pitmData = reader.Read(pitm.dataOffset, FULL_BOX_HEADER_SIZE + INT_BYTES);
+    if (pitmData == nullptr) {
+        pitmData = reader.Read(pitm.dataOffset, FULL_BOX_HEADER_SIZE + SHORT_BYTES);
+    }
+    if (pitmData == nullptr) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    uint32_t primaryItemId = (pitmData[0] == 0) ? GetBigEndian16(pitmData + FULL_BOX_HEADER_SIZE) :
+        GetBigEndian32(pitmData + FULL_BOX_HEADER_SIZE);
+    vector<uint32_t> indexes;
+    if (!GetHeifItemProperties(reader, ipma, primaryItemId, indexes)) {
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    // walk the properties once, apply those associated with the primary item.
+    HeifBox property;
+    uint32_t propertyIndex = 0;
+    size_t offset = ipco.dataOffset;
+    while (offset < ipco.end && ReadHeifBox(reader, offset, ipco.end, property)) {
+        propertyIndex++;
+        if (find(indexes.begin(), indexes.end(), propertyIndex) != indexes.end()) {
+            ApplyHeifProperty(reader, property, info);
+        }
+        offset = property.end;
+    }
+    return (info.size.width > 0 && info.size.height > 0) ? SUCCESS : ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+}
+
+uint32_t ProbeSource(ProbeReader &reader, ImageProbeInfo &info)
+{
+    static const uint8_t JPEG_SIGNATURE[] = { JPEG_MARKER_PREFIX, JPEG_SOI };
+    static const uint8_t GIF87_SIGNATURE[] = { 'G', 'I', 'F', '8', '7', 'a' };
+    static const uint8_t GIF89_SIGNATURE[] = { 'G', 'I', 'F', '8', '9', 'a' };
+    static const uint8_t BMP_SIGNATURE[] = { 'B', 'M' };
+    static const uint8_t RIFF_SIGNATURE[] = { 'R', 'I', 'F', 'F' };
+    static const uint8_t WEBP_SIGNATURE[] = { 'W', 'E', 'B', 'P' };
+    static const uint8_t FTYP_SIGNATURE[] = { 'f', 't', 'y', 'p' };
+    info = ImageProbeInfo();
+    uint32_t errorCode = ERR_IMAGE_UNKNOWN_FORMAT;
+    if (reader.Match(0, JPEG_SIGNATURE, sizeof(JPEG_SIGNATURE))) {
+        info.encodedFormat = FORMAT_JPEG;
+        errorCode = ProbeJpeg(reader, info);
+    } else if (reader.Match(0, PNG_SIGNATURE, sizeof(PNG_SIGNATURE))) {
+        info.encodedFormat = FORMAT_PNG;
+        errorCode = ProbePng(reader, info);
+    } else if (reader.Match(0, GIF87_SIGNATURE, sizeof(GIF87_SIGNATURE)) ||
+               reader.Match(0, GIF89_SIGNATURE, sizeof(GIF89_SIGNATURE))) {
+        info.encodedFormat = FORMAT_GIF;
+        errorCode = ProbeGif(reader, info);
+    } else if (reader.Match(0, RIFF_SIGNATURE, sizeof(RIFF_SIGNATURE)) &&
+               reader.Match(RIFF_HEADER_SIZE - INT_BYTES, WEBP_SIGNATURE, sizeof(WEBP_SIGNATURE))) {
+        info.encodedFormat = FORMAT_WEBP;
+        errorCode = ProbeWebp(reader, info);
+    } else if (reader.Match(0, BMP_SIGNATURE, sizeof(BMP_SIGNATURE))) {
+        info.encodedFormat = FORMAT_BMP;
+        errorCode = ProbeBmp(reader, info);
+    } else if (reader.Match(INT_BYTES, FTYP_SIGNATURE, sizeof(FTYP_SIGNATURE))) {
+        info.encodedFormat = FORMAT_HEIF;
+        errorCode = ProbeHeif(reader, info);
+    } else {
+        info.encodedFormat = FORMAT_WBMP;
+        errorCode = ProbeWbmp(reader, info);
+    }
+    if (errorCode == SUCCESS && (info.size.width <= 0 || info.size.height <= 0)) {
+        errorCode = ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    if (errorCode == ERR_IMAGE_UNKNOWN_FORMAT) {
+        info.encodedFormat.clear();
+    }
+    info.errorCode = errorCode;
+    return errorCode;
+}
+
+uint32_t ProbeFile(FILE *file, size_t size, ImageProbeInfo &info)
+{
+    long offset = ftell(file);
+    if (offset < 0 || static_cast<size_t>(offset) > size) {
+        IMAGE_LOGE("[ImageProbe]get the file position fail.");
+        info = ImageProbeInfo();
+        info.errorCode = ERR_IMAGE_SOURCE_DATA;
+        return info.errorCode;
+    }
+    ProbeReader reader(file, static_cast<size_t>(offset), size - static_cast<size_t>(offset));
+    return ProbeSource(reader, info);
+}
+} // namespace
+
+uint32_t ImageProbe::Probe(const uint8_t *data, uint32_t size, ImageProbeInfo &info)
+{
+    if (data == nullptr || size == 0) {
+        IMAGE_LOGE("[ImageProbe]parameter error.");
+        info = ImageProbeInfo();
+        info.errorCode = ERR_IMAGE_DATA_ABNORMAL;
+        return info.errorCode;
+    }
+    ProbeReader reader(data, size);
+    return ProbeSource(reader, info);
+}
+
+uint32_t ImageProbe::Probe(const std::string &pathName, ImageProbeInfo &info)
+{
+    info = ImageProbeInfo();
+    info.errorCode = ERR_IMAGE_SOURCE_DATA;
+    string realPath;
+    size_t size = 0;
+    if (!ImageUtils::PathToRealPath(pathName, realPath) || !ImageUtils::GetFileSize(realPath, size)) {
+        IMAGE_LOGE("[ImageProbe]input the file path exception.");
+        return info.errorCode;
+    }
+    FILE *file = fopen(realPath.c_str(), "rb");
+    if (file == nullptr) {
+        IMAGE_LOGE("[ImageProbe]open file fail.");
+        return info.errorCode;
+    }
+    uint32_t errorCode = ProbeFile(file, size, info);
+    fclose(file);
+    return errorCode;
+}
+
+uint32_t ImageProbe::Probe(const int fd, ImageProbeInfo &info)
+{
+    info = ImageProbeInfo();
+    info.errorCode = ERR_IMAGE_SOURCE_DATA;
+    size_t size = 0;
+    if (!ImageUtils::GetFileSize(fd, size)) {
+        IMAGE_LOGE("[ImageProbe]get the file size fail.");
+        return info.errorCode;
+    }
+    // the duplicated fd shares the position with the caller's fd, restore it after probing.
+    off_t position = lseek(fd, 0, SEEK_CUR);
+    int dupFd = (position < 0) ? -1 : dup(fd);
+    FILE *file = (dupFd < 0) ? nullptr : fdopen(dupFd, "rb");
+    if (file == nullptr) {
+        IMAGE_LOGE("[ImageProbe]open file fail.");
+        if (dupFd >= 0) {
+            close(dupFd);
+        }
+        return info.errorCode;
+    }
+    uint32_t errorCode = ProbeFile(file, size, info);
+    fclose(file);
+    lseek(fd, position, SEEK_SET);
+    return errorCode;
+}
+
+std::vector<ImageProbeInfo> ImageProbe::Probe(const std::vector<std::string> &pathNames)
+{
+    vector<ImageProbeInfo> infos(pathNames.size());
+    for (size_t i = 0; i < pathNames.size(); i++) {
+        Probe(pathNames[i], infos[i]);
+    }
+    return infos;
+}
+
+std::vector<ImageProbeInfo> ImageProbe::Probe(const std::vector<int> &fds)
+{
+    vector<ImageProbeInfo> infos(fds.size());
+    for (size_t i = 0; i < fds.size(); i++) {
+        Probe(fds[i], infos[i]);
+    }
+    return infos;
+}
+
+std::vector<ImageProbeInfo> ImageProbe::Probe(const std::vector<ImageProbeBuffer> &buffers)
+{
+    vector<ImageProbeInfo> infos(buffers.size());
+    for (size_t i = 0; i < buffers.size(); i++) {
+        Probe(buffers[i].data, buffers[i].size, infos[i]);
+    }
+    return infos;
+}
+} // namespace Media
+} // namespace OHOS
@@ -16,8 +16,12 @@
 #include "image_source.h"
 
 #include <algorithm>
+#include <cmath>
+#include <sys/stat.h>
 #include <vector>
 #include "buffer_source_stream.h"
+#include "decode_task_pool.h"
+#include "decoder_pool.h"
 #if !defined(_WIN32) && !defined(_APPLE)
 #include "bytrace.h"
 #endif
@@ -31,8 +35,10 @@
 #include "istream_source_stream.h"
 #include "media_errors.h"
 #include "pixel_map.h"
+#include "pixel_map_cache.h"
 #include "plugin_server.h"
 #include "post_proc.h"
+#include "securec.h"
 #include "source_stream.h"
 
 namespace OHOS {
@@ -42,6 +48,11 @@ using namespace std;
 using namespace ImagePlugin;
 using namespace MultimediaPlugin;
 
+static constexpr size_t MAX_POOLED_DECODERS = 4;
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+static constexpr float FULL_ANGLE = 360.0f;
+
 static const map<PixelFormat, PlPixelFormat> PIXEL_FORMAT_MAP = {
     { PixelFormat::UNKNOWN, PlPixelFormat::UNKNOWN },     { PixelFormat::ARGB_8888, PlPixelFormat::ARGB_8888 },
     { PixelFormat::ALPHA_8, PlPixelFormat::ALPHA_8 },     { PixelFormat::RGB_565, PlPixelFormat::RGB_565 },
@@ -86,10 +97,25 @@ namespace InnerFormat {
         "image/x-pentax-pef",
         "image/x-samsung-srw",
     };
+    // decoders of these formats subsample by sampleSize themselves, no need to transfer to skia codec.
+    const string NATIVE_SAMPLE_FORMATS[] = {
+        "image/bmp",
+        "image/vnd.wap.wbmp",
+    };
+    // the first byte of the formats with a fixed signature, agents of other formats check every source.
+    const map<string, uint8_t> SIGNATURE_LEADING_BYTES = {
+        { "image/bmp", 'B' },
+        { "image/gif", 'G' },
+        { "image/jpeg", 0xFF },
+        { "image/png", 0x89 },
+        { "image/webp", 'R' },
+    };
 } // namespace InnerFormat
 
 PluginServer &ImageSource::pluginServer_ = ImageUtils::GetPluginServer();
 ImageSource::FormatAgentMap ImageSource::formatAgentMap_ = InitClass();
+ImageSource::FormatDispatchTable ImageSource::formatDispatchTable_ = InitDispatchTable();
+uint32_t ImageSource::maxHeaderSize_ = InitMaxHeaderSize();
 
 uint32_t ImageSource::GetSupportedFormats(set<string> &formats)
 {
@@ -127,6 +153,35 @@ uint32_t ImageSource::GetSupportedFormats(set<string> &formats)
     return SUCCESS;
 }
 
+// the same file opened by path or by fd gets the same identity, and a modified file gets a new one.
+// a file rewritten within the same second is told apart by the nanoseconds of its modification time, without them
+// the file gets no identity and its pixel maps are not cached.
+static string GetFileSourceId(const struct stat &fileStat)
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    return "file:" + to_string(fileStat.st_dev) + ":" + to_string(fileStat.st_ino) + ":" +
+           to_string(fileStat.st_mtim.tv_sec) + "." + to_string(fileStat.st_mtim.tv_nsec) + ":" +
+           to_string(fileStat.st_size);
+#else
+    return "";
+#endif
+}
+
+static string GetBufferSourceId(const uint8_t *data, size_t size)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return "buffer:" + to_string(hash) + ":" + to_string(size);
+}
+
+static void AppendRect(string &key, const Rect &rect)
+{
+    key += ":" + to_string(rect.left) + "," + to_string(rect.top) + "," + to_string(rect.width) + "," +
+           to_string(rect.height);
+}
+
 unique_ptr<ImageSource> ImageSource::CreateImageSource(unique_ptr<istream> is, const SourceOptions &opts,
                                                        uint32_t &errorCode)
 {
@@ -135,12 +190,13 @@ unique_ptr<ImageSource> ImageSource::CreateImageSource(unique_ptr<istream> is, c
 #endif
     IMAGE_LOGD("[ImageSource]create Imagesource with stream.");
 
-    unique_ptr<SourceStream> streamPtr = IstreamSourceStream::CreateSourceStream(move(is));
+    unique_ptr<IstreamSourceStream> streamPtr = IstreamSourceStream::CreateSourceStream(move(is));
     if (streamPtr == nullptr) {
         IMAGE_LOGE("[ImageSource]failed to create istream source stream.");
         errorCode = ERR_IMAGE_SOURCE_DATA;
         return nullptr;
     }
+    streamPtr->SetReadAheadSize(opts.readAheadSize);
 
     ImageSource *sourcePtr = new (std::nothrow) ImageSource(std::move(streamPtr), opts);
     if (sourcePtr == nullptr) {
@@ -197,12 +253,13 @@ unique_ptr<ImageSource> ImageSource::CreateImageSource(const std::string &pathNa
 #endif
     IMAGE_LOGD("[ImageSource]create Imagesource with pathName.");
 
-    unique_ptr<SourceStream> streamPtr = FileSourceStream::CreateSourceStream(pathName);
+    unique_ptr<FileSourceStream> streamPtr = FileSourceStream::CreateSourceStream(pathName);
     if (streamPtr == nullptr) {
         IMAGE_LOGE("[ImageSource]failed to create file source stream.");
         errorCode = ERR_IMAGE_SOURCE_DATA;
         return nullptr;
     }
+    streamPtr->SetPrefetchSize(opts.prefetchSize);
 
     ImageSource *sourcePtr = new (std::nothrow) ImageSource(std::move(streamPtr), opts);
     if (sourcePtr == nullptr) {
@@ -210,6 +267,10 @@ unique_ptr<ImageSource> ImageSource::CreateImageSource(const std::string &pathNa
         errorCode = ERR_IMAGE_SOURCE_DATA;
         return nullptr;
     }
+    struct stat fileStat;
+    if (stat(pathName.c_str(), &fileStat) == 0) {
+        sourcePtr->sourceId_ = GetFileSourceId(fileStat);
+    }
     errorCode = SUCCESS;
 #if !defined(_WIN32) && !defined(_APPLE)
     FinishTrace(BYTRACE_TAG_ZIMAGE);
@@ -223,18 +284,23 @@ unique_ptr<ImageSource> ImageSource::CreateImageSource(const int fd, const Sourc
 #if !defined(_WIN32) && !defined(_APPLE)
     StartTrace(BYTRACE_TAG_ZIMAGE, "CreateImageSource by fd");
 #endif
-    unique_ptr<SourceStream> streamPtr = FileSourceStream::CreateSourceStream(fd);
+    unique_ptr<FileSourceStream> streamPtr = FileSourceStream::CreateSourceStream(fd);
     if (streamPtr == nullptr) {
         IMAGE_LOGE("[ImageSource]failed to create file source stream.");
         errorCode = ERR_IMAGE_SOURCE_DATA;
         return nullptr;
     }
+    streamPtr->SetPrefetchSize(opts.prefetchSize);
     ImageSource *sourcePtr = new (std::nothrow) ImageSource(std::move(streamPtr), opts);
     if (sourcePtr == nullptr) {
         IMAGE_LOGE("[ImageSource]failed to create ImageSource by fd.");
         errorCode = ERR_IMAGE_SOURCE_DATA;
         return nullptr;
     }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0) {
+        sourcePtr->sourceId_ = GetFileSourceId(fileStat);
+    }
     errorCode = SUCCESS;
 #if !defined(_WIN32) && !defined(_APPLE)
     FinishTrace(BYTRACE_TAG_ZIMAGE);
@@ -246,7 +312,8 @@ unique_ptr<ImageSource> ImageSource::CreateIncrementalImageSource(const Incremen
 {
     IMAGE_LOGD("[ImageSource]create incremental ImageSource.");
 
-    unique_ptr<SourceStream> streamPtr = IncrementalSourceStream::CreateSourceStream(opts.incrementalMode);
+    unique_ptr<SourceStream> streamPtr = IncrementalSourceStream::CreateSourceStream(opts.incrementalMode,
+                                                                                     opts.expectedSize);
     if (streamPtr == nullptr) {
         IMAGE_LOGE("[ImageSource]failed to create incremental source stream.");
         errorCode = ERR_IMAGE_SOURCE_DATA;
@@ -273,7 +340,7 @@ void ImageSource::Reset()
     imageStatusMap_.clear();
     decodeState_ = SourceDecodingState::UNRESOLVED;
     sourceStreamPtr_->Seek(0);
-    mainDecoder_ = nullptr;
+    RecycleDecoders();
 }
 
 unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOptions &opts, uint32_t &errorCode)
@@ -281,9 +348,31 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
 #if !defined(_WIN32) && !defined(_APPLE)
     StartTrace(BYTRACE_TAG_ZIMAGE, "CreatePixelMap");
 #endif
+    if (opts.cancelToken != nullptr && opts.cancelToken->IsCanceled()) {
+        IMAGE_LOGI("[ImageSource]decoding is canceled before start.");
+        errorCode = ERR_IMAGE_DECODE_CANCELED;
+        return nullptr;
+    }
     std::unique_lock<std::mutex> guard(decodingMutex_);
     opts_ = opts;
-    bool useSkia = opts_.sampleSize != 1;
+    string cacheKey;
+    bool isCacheable = BuildCacheKey(index, opts, cacheKey);
+    if (isCacheable) {
+        unique_ptr<PixelMap> cachedPixelMap = CreatePixelMapFromCache(cacheKey, opts);
+        if (cachedPixelMap != nullptr) {
+            guard.unlock();
+            for (auto listener : decodeListeners_) {
+                listener->OnEvent((int)DecodeEvent::EVENT_HEADER_DECODE);
+                listener->OnEvent((int)DecodeEvent::EVENT_COMPLETE_DECODE);
+            }
+            errorCode = SUCCESS;
+#if !defined(_WIN32) && !defined(_APPLE)
+            FinishTrace(BYTRACE_TAG_ZIMAGE);
+#endif
+            return cachedPixelMap;
+        }
+    }
+    bool useSkia = IsSkiaSampleDecode();
     if (useSkia) {
         // we need reset to initial state to choose correct decoder
         Reset();
@@ -293,6 +382,8 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         IMAGE_LOGE("[ImageSource]get valid image status fail on create pixel map, ret:%{public}u.", errorCode);
         return nullptr;
     }
+    // the encoded format may be recognized just now.
+    useSkia = IsSkiaSampleDecode();
     // the mainDecoder_ may be borrowed by Incremental decoding, so needs to be checked.
     if (InitMainDecoder() != SUCCESS) {
         IMAGE_LOGE("[ImageSource]image decode plugin is null.");
@@ -305,9 +396,13 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         errorCode = ERR_IMAGE_MALLOC_ABNORMAL;
         return nullptr;
     }
+    // decode with a pooled decoder if possible, then the lock is not held during decoding.
+    PooledDecoder pooledDecoder;
+    bool isPooled = !useSkia && AcquirePooledDecoder(pooledDecoder);
+    unique_ptr<AbsImageDecoder> &decoder = isPooled ? pooledDecoder.decoder : mainDecoder_;
 
     ImagePlugin::PlImageInfo plInfo;
-    errorCode = SetDecodeOptions(mainDecoder_, index, opts, plInfo);
+    errorCode = SetDecodeOptions(decoder, index, opts, plInfo);
     if (errorCode != SUCCESS) {
         IMAGE_LOGE("[ImageSource]set decode options error (index:%{public}u), ret:%{public}u.", index, errorCode);
         return nullptr;
@@ -328,7 +423,7 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
     DecodeContext context;
     FinalOutputStep finalOutputStep;
     if (!useSkia) {
-        bool hasNinePatch = mainDecoder_->HasProperty(NINE_PATCH);
+        bool hasNinePatch = decoder->HasProperty(NINE_PATCH);
         finalOutputStep = GetFinalOutputStep(opts, *(pixelMap.get()), hasNinePatch);
         IMAGE_LOGD("[ImageSource]finalOutputStep:%{public}d. opts.allocatorType %{public}d",
             finalOutputStep, opts.allocatorType);
@@ -340,7 +435,18 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         }
     }
 
-    errorCode = mainDecoder_->Decode(index, context);
+    // the decoder reads its stream from here on.
+    (isPooled ? pooledDecoder.stream : sourceStreamPtr_)->PrepareSequentialRead();
+    if (isPooled) {
+        guard.unlock();
+        errorCode = decoder->Decode(index, context);
+        guard.lock();
+        if (errorCode == SUCCESS) {
+            ReleasePooledDecoder(pooledDecoder);
+        }
+    } else {
+        errorCode = mainDecoder_->Decode(index, context);
+    }
     if (context.ifPartialOutput) {
         for (auto listener : decodeListeners_) {
             guard.unlock();
@@ -352,6 +458,8 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         ninePatchInfo_.ninePatch = context.ninePatchContext.ninePatch;
         ninePatchInfo_.patchSize = context.ninePatchContext.patchSize;
     }
+    // partial images and nine patch images are not cached, the cached copy has no nine patch info.
+    isCacheable = isCacheable && !context.ifPartialOutput && context.ninePatchContext.ninePatch == nullptr;
     guard.unlock();
     if (errorCode != SUCCESS) {
         IMAGE_LOGE("[ImageSource]decode source fail, ret:%{public}u.", errorCode);
@@ -368,6 +476,12 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
     }
     pixelMap->SetPixelsAddr(context.pixelsBuffer.buffer, context.pixelsBuffer.context, context.pixelsBuffer.bufferSize,
                             context.allocatorType, context.freeFunc);
+    if (opts.cancelToken != nullptr && opts.cancelToken->IsCanceled()) {
+        // the decoded pixels are released with the pixel map.
+        IMAGE_LOGI("[ImageSource]decoding is canceled before post processing.");
+        errorCode = ERR_IMAGE_DECODE_CANCELED;
+        return nullptr;
+    }
     DecodeOptions procOpts;
     CopyOptionsToProcOpts(opts, procOpts, *(pixelMap.get()));
     PostProc postProc;
@@ -375,6 +489,9 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
     if (errorCode != SUCCESS) {
         return nullptr;
     }
+    if (isCacheable) {
+        AddPixelMapToCache(cacheKey, *(pixelMap.get()));
+    }
 
     if (!context.ifPartialOutput) {
         for (auto listener : decodeListeners_) {
@@ -387,6 +504,260 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
     return pixelMap;
 }
 
+bool ImageSource::BuildCacheKey(uint32_t index, const DecodeOptions &opts, std::string &key)
+{
+    // the copies taken from the cache are always on the heap.
+    if (isIncrementalSource_ || (opts.allocatorType != AllocatorType::DEFAULT &&
+        opts.allocatorType != AllocatorType::HEAP_ALLOC)) {
+        return false;
+    }
+    if (!PixelMapCache::GetInstance().IsEnabled()) {
+        return false;
+    }
+    if (sourceId_.empty() && sourceStreamPtr_->GetStreamType() == ImagePlugin::BUFFER_SOURCE_TYPE &&
+        sourceStreamPtr_->GetDataPtr() != nullptr) {
+        sourceId_ = GetBufferSourceId(sourceStreamPtr_->GetDataPtr(), sourceStreamPtr_->GetStreamSize());
+    }
+    if (sourceId_.empty()) {
+        return false;
+    }
+    // the options are normalized so that equivalent requests share one entry.
+    Rect cropRect = opts.CropRect;
+    if (cropRect.width <= 0 || cropRect.height <= 0) {
+        cropRect = Rect();
+    }
+    float rotateDegrees = fmod(opts.rotateDegrees, FULL_ANGLE);
+    if (rotateDegrees < 0) {
+        rotateDegrees += FULL_ANGLE;
+    }
+    key = sourceId_ + "|" + to_string(index) + "|" + to_string(opts.desiredSize.width) + "x" +
+          to_string(opts.desiredSize.height);
+    AppendRect(key, cropRect);
+    AppendRect(key, opts.desiredRegion);
+    key += ":" + to_string(rotateDegrees) + ":" + to_string(opts.rotateNewDegrees) + ":" +
+           to_string(opts.sampleSize) + ":" + to_string(static_cast<int32_t>(opts.desiredPixelFormat)) + ":" +
+           to_string(static_cast<int32_t>(opts.desiredColorSpace)) + ":" + to_string(opts.fitDensity) + ":" +
+           to_string(static_cast<int32_t>(preference_));
+    return true;
+}
+
+unique_ptr<PixelMap> ImageSource::CreatePixelMapFromCache(const std::string &key, const DecodeOptions &opts)
+{
+    shared_ptr<const CachedPixels> entry = PixelMapCache::GetInstance().Get(key);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+    unique_ptr<PixelMap> pixelMap = make_unique<PixelMap>();
+    ImageInfo info = entry->info;
+    if (pixelMap->SetImageInfo(info) != SUCCESS) {
+        IMAGE_LOGE("[ImageSource]set cached image info fail.");
+        return nullptr;
+    }
+    uint32_t bufferSize = static_cast<uint32_t>(entry->pixels.size());
+    if (pixelMap->GetByteCount() <= 0 || static_cast<uint32_t>(pixelMap->GetByteCount()) != bufferSize) {
+        IMAGE_LOGE("[ImageSource]cached pixels size %{public}u mismatch.", bufferSize);
+        return nullptr;
+    }
+    void *buffer = malloc(bufferSize);
+    if (buffer == nullptr) {
+        IMAGE_LOGE("[ImageSource]alloc cached pixels copy fail, size:%{public}u.", bufferSize);
+        return nullptr;
+    }
+    if (memcpy_s(buffer, bufferSize, entry->pixels.data(), bufferSize) != EOK) {
+        IMAGE_LOGE("[ImageSource]copy cached pixels fail.");
+        free(buffer);
+        return nullptr;
+    }
+    pixelMap->SetPixelsAddr(buffer, nullptr, bufferSize, AllocatorType::HEAP_ALLOC, nullptr);
+    pixelMap->SetEditable(opts.editable);
+    return pixelMap;
+}
+
+void ImageSource::AddPixelMapToCache(const std::string &key, PixelMap &pixelMap)
+{
+    const uint8_t *pixels = pixelMap.GetPixels();
+    int32_t byteCount = pixelMap.GetByteCount();
+    if (pixels == nullptr || byteCount <= 0) {
+        return;
+    }
+    auto entry = make_shared<CachedPixels>();
+    pixelMap.GetImageInfo(entry->info);
+    entry->pixels.assign(pixels, pixels + byteCount);
+    PixelMapCache::GetInstance().Put(key, move(entry), preference_);
+}
+
+shared_ptr<PixelMapFuture> ImageSource::CreatePixelMapAsync(uint32_t index, const DecodeOptions &opts,
+                                                            DecodePriority priority, DecodeCompleteCallback callback)
+{
+    // the task has its own token, so the future and the destructor never cancel the token of the caller,
+    // which may be shared by other decodings.
+    DecodeOptions taskOpts = opts;
+    taskOpts.cancelToken = make_shared<DecodeCancelToken>(opts.cancelToken);
+    shared_ptr<PixelMapFuture> future(new (std::nothrow) PixelMapFuture(move(callback), taskOpts.cancelToken));
+    if (future == nullptr) {
+        IMAGE_LOGE("[ImageSource]create the pixel map future fail.");
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> guard(asyncTaskMutex_);
+        asyncTaskTokens_.insert(taskOpts.cancelToken);
+    }
+    DecodeTask task;
+    task.owner = this;
+    task.priority = priority;
+    // the source may be destroyed once the task is done, so the result is set at last.
+    task.run = [this, index, taskOpts, future]() {
+        uint32_t errorCode = ERR_IMAGE_DECODE_CANCELED;
+        unique_ptr<PixelMap> pixelMap;
+        if (!taskOpts.cancelToken->IsCanceled()) {
+            pixelMap = CreatePixelMap(index, taskOpts, errorCode);
+        }
+        OnAsyncTaskDone(taskOpts.cancelToken);
+        future->SetResult(move(pixelMap), errorCode);
+    };
+    task.cancel = [this, cancelToken = taskOpts.cancelToken, future]() {
+        OnAsyncTaskDone(cancelToken);
+        future->SetResult(nullptr, ERR_IMAGE_DECODE_CANCELED);
+    };
+    DecodeTaskPool::GetInstance().Submit(move(task));
+    return future;
+}
+
+vector<unique_ptr<PixelMap>> ImageSource::CreatePixelMaps(const vector<uint32_t> &indices, const DecodeOptions &opts,
+                                                          vector<uint32_t> &errorCodes)
+{
+    vector<unique_ptr<PixelMap>> pixelMaps(indices.size());
+    errorCodes.assign(indices.size(), ERR_IMAGE_DECODE_ABNORMAL);
+    // the source info is decoded and the decoder is created once for all the images.
+    uint32_t errorCode = SUCCESS;
+    GetSourceInfo(errorCode);
+    if (errorCode != SUCCESS) {
+        IMAGE_LOGE("[ImageSource]get source info fail on create pixel maps, ret:%{public}u.", errorCode);
+        errorCodes.assign(indices.size(), errorCode);
+        return pixelMaps;
+    }
+    // the decoder of an animated image goes on from the last decoded frame if the index is not smaller.
+    vector<size_t> order(indices.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [&indices](size_t lhs, size_t rhs) {
+        return indices[lhs] < indices[rhs];
+    });
+    for (size_t i : order) {
+        pixelMaps[i] = CreatePixelMap(indices[i], opts, errorCodes[i]);
+    }
+    return pixelMaps;
+}
+
+vector<unique_ptr<PixelMap>> ImageSource::CreatePixelMaps(const vector<ImageSource *> &sources,
+                                                          const DecodeOptions &opts, vector<uint32_t> &errorCodes)
+{
+    vector<unique_ptr<PixelMap>> pixelMaps(sources.size());
+    errorCodes.assign(sources.size(), ERR_IMAGE_DECODE_ABNORMAL);
+    auto decodeSource = [&sources, &opts, &pixelMaps, &errorCodes](size_t i) {
+        if (sources[i] == nullptr) {
+            errorCodes[i] = ERR_IMAGE_INVALID_PARAMETER;
+            return;
+        }
+        pixelMaps[i] = sources[i]->CreatePixelMap(0, opts, errorCodes[i]);
+    };
+    // the tasks refer to the locals, so all of them are done or taken back before return.
+    std::mutex doneMutex;
+    std::condition_variable doneCond;
+    size_t runningCount = 0;
+    vector<uint64_t> taskIds(sources.size(), 0);
+    DecodeTaskPool &pool = DecodeTaskPool::GetInstance();
+    for (size_t i = 1; i < sources.size(); i++) {
+        {
+            std::lock_guard<std::mutex> guard(doneMutex);
+            runningCount++;
+        }
+        DecodeTask task;
+        task.owner = sources[i];
+        task.run = [i, &decodeSource, &doneMutex, &doneCond, &runningCount]() {
+            decodeSource(i);
+            {
+                std::lock_guard<std::mutex> guard(doneMutex);
+                runningCount--;
+            }
+            doneCond.notify_all();
+        };
+        // the task is taken back below or dropped by the pool, e.g. by DecodeTaskPool::CancelTasks of its source.
+        task.cancel = [i, &errorCodes, &doneMutex, &doneCond, &runningCount]() {
+            {
+                std::lock_guard<std::mutex> guard(doneMutex);
+                errorCodes[i] = ERR_IMAGE_DECODE_CANCELED;
+                runningCount--;
+            }
+            doneCond.notify_all();
+        };
+        taskIds[i] = pool.Submit(move(task));
+    }
+    if (!sources.empty()) {
+        decodeSource(0);
+    }
+    // the pending tasks are taken back and decoded on the caller thread, which also avoids waiting for itself
+    // when the caller is a decode thread.
+    for (size_t i = 1; i < sources.size(); i++) {
+        if (pool.CancelTask(taskIds[i])) {
+            decodeSource(i);
+        }
+    }
+    std::unique_lock<std::mutex> guard(doneMutex);
+    doneCond.wait(guard, [&runningCount] { return runningCount == 0; });
+    return pixelMaps;
+}
+
+void ImageSource::SetDecoderPoolSize(uint32_t count)
+{
+    DecoderPool::GetInstance().SetCapacity(count);
+}
+
+void ImageSource::ReleaseIdleDecoders()
+{
+    DecoderPool::GetInstance().Clear();
+}
+
+uint32_t ImageSource::WarmUpDecoders(const vector<string> &formats)
+{
+    if (formats.empty()) {
+        IMAGE_LOGE("[ImageSource]no format to warm up.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    vector<map<string, AttrData>> capabilitiesList;
+    for (const string &format : formats) {
+        capabilitiesList.push_back({ { IMAGE_ENCODE_FORMAT, AttrData(format) } });
+    }
+    uint32_t ret = pluginServer_.WarmUp<AbsImageDecoder>(AbsImageDecoder::SERVICE_DEFAULT, capabilitiesList);
+    if (ret != SUCCESS) {
+        IMAGE_LOGE("[ImageSource]failed to warm up decoders, ret:%{public}u.", ret);
+        return ERR_IMAGE_PLUGIN_CREATE_FAILED;
+    }
+    return SUCCESS;
+}
+
+bool ImageSource::WaitDecodersReady(uint32_t timeoutMs)
+{
+    return pluginServer_.WaitWarmUp(timeoutMs);
+}
+
+void ImageSource::SetAsyncDecodeThreads(uint32_t count)
+{
+    DecodeTaskPool::GetInstance().SetMaxWorkers(count);
+}
+
+void ImageSource::OnAsyncTaskDone(const shared_ptr<DecodeCancelToken> &cancelToken)
+{
+    // notified with the lock held, otherwise the destructor may see no task and free the condition before it.
+    std::lock_guard<std::mutex> guard(asyncTaskMutex_);
+    auto iter = asyncTaskTokens_.find(cancelToken);
+    if (iter != asyncTaskTokens_.end()) {
+        asyncTaskTokens_.erase(iter);
+    }
+    asyncTaskCond_.notify_all();
+}
+
 unique_ptr<IncrementalPixelMap> ImageSource::CreateIncrementalPixelMap(uint32_t index, const DecodeOptions &opts,
                                                                        uint32_t &errorCode)
 {
@@ -401,10 +772,11 @@ unique_ptr<IncrementalPixelMap> ImageSource::CreateIncrementalPixelMap(uint32_t
 }
 
 uint32_t ImageSource::PromoteDecoding(uint32_t index, const DecodeOptions &opts, PixelMap &pixelMap,
-                                      ImageDecodingState &state, uint8_t &decodeProgress)
+                                      ImageDecodingState &state, uint8_t &decodeProgress, uint32_t &renderedScans)
 {
     state = ImageDecodingState::UNRESOLVED;
     decodeProgress = 0;
+    renderedScans = 0;
     uint32_t ret = SUCCESS;
     std::unique_lock<std::mutex> guard(decodingMutex_);
     auto imageStatusIter = GetValidImageStatus(index, ret);
@@ -448,6 +820,7 @@ uint32_t ImageSource::PromoteDecoding(uint32_t index, const DecodeOptions &opts,
     if (incrementalRecordIter->second.IncrementalState == ImageDecodingState::IMAGE_DECODING) {
         ret = DoIncrementalDecoding(index, opts, pixelMap, incrementalRecordIter->second);
         decodeProgress = incrementalRecordIter->second.decodingProgress;
+        renderedScans = incrementalRecordIter->second.renderedScans;
         state = incrementalRecordIter->second.IncrementalState;
         if (isIncrementalCompleted_) {
             PostProc postProc;
@@ -470,6 +843,7 @@ uint32_t ImageSource::PromoteDecoding(uint32_t index, const DecodeOptions &opts,
     // IMAGE_ERROR or IMAGE_DECODED.
     state = incrementalRecordIter->second.IncrementalState;
     decodeProgress = incrementalRecordIter->second.decodingProgress;
+    renderedScans = incrementalRecordIter->second.renderedScans;
     if (incrementalRecordIter->second.IncrementalState == ImageDecodingState::IMAGE_ERROR) {
         IMAGE_LOGE("[ImageSource]invalid imageState %{public}d on incremental decoding.",
                    incrementalRecordIter->second.IncrementalState);
@@ -675,6 +1049,16 @@ void ImageSource::RemoveDecodeListener(DecodeListener *listener)
 
 ImageSource::~ImageSource()
 {
+    DecodeTaskPool::GetInstance().CancelTasks(this);
+    {
+        // the running decodings stop at their next cancellation check, the tokens are created by the source.
+        std::unique_lock<std::mutex> guard(asyncTaskMutex_);
+        for (const auto &cancelToken : asyncTaskTokens_) {
+            cancelToken->Cancel();
+        }
+        asyncTaskCond_.wait(guard, [this] { return asyncTaskTokens_.empty(); });
+    }
+    RecycleDecoders();
     std::lock_guard<std::mutex> guard(listenerMutex_);
     for (const auto &listener : listeners_) {
         listener->OnPeerDestory();
@@ -730,32 +1114,72 @@ ImageSource::FormatAgentMap ImageSource::InitClass()
     return tempAgentMap;
 }
 
-uint32_t ImageSource::CheckEncodedFormat(AbsImageFormatAgent &agent)
+ImageSource::FormatDispatchTable ImageSource::InitDispatchTable()
+{
+    // keep the order of formatAgentMap_ in every entry, so the first matched format is the same as checking all.
+    FormatDispatchTable table(UINT8_MAX + 1);
+    for (auto iter = formatAgentMap_.begin(); iter != formatAgentMap_.end(); ++iter) {
+        if (iter->first == InnerFormat::RAW_FORMAT) {
+            continue;  // the fallback, checked at last.
+        }
+        auto signature = InnerFormat::SIGNATURE_LEADING_BYTES.find(iter->first);
+        if (signature != InnerFormat::SIGNATURE_LEADING_BYTES.end()) {
+            table[signature->second].push_back(iter);
+            continue;
+        }
+        for (auto &agents : table) {
+            agents.push_back(iter);
+        }
+    }
+    return table;
+}
+
+uint32_t ImageSource::InitMaxHeaderSize()
+{
+    uint32_t maxSize = 0;
+    for (auto &agent : formatAgentMap_) {
+        maxSize = std::max(maxSize, agent.second->GetHeaderSize());
+    }
+    return maxSize;
+}
+
+uint32_t ImageSource::PeekFormatHeader(ImagePlugin::DataStreamBuffer &header)
 {
-    uint32_t size = agent.GetHeaderSize();
-    ImagePlugin::DataStreamBuffer outData;
     if (sourceStreamPtr_ == nullptr) {
         IMAGE_LOGE("[ImageSource]check image format, source stream is null.");
         return ERR_IMAGE_INVALID_PARAMETER;
     }
-    if (!sourceStreamPtr_->Peek(size, outData)) {
+    // some streams fail to peek beyond the end, only peek the remaining data of a small source.
+    uint32_t size = maxHeaderSize_;
+    size_t streamSize = sourceStreamPtr_->GetStreamSize();
+    uint32_t position = sourceStreamPtr_->Tell();
+    if (streamSize > position && streamSize - position < size) {
+        size = static_cast<uint32_t>(streamSize - position);
+    }
+    if (size == 0 || !sourceStreamPtr_->Peek(size, header)) {
         IMAGE_LOGE("[ImageSource]stream peek the data fail.");
         return ERR_IMAGE_SOURCE_DATA;
     }
+    return SUCCESS;
+}
 
-    if (outData.inputStreamBuffer == nullptr || outData.dataSize < size) {
+uint32_t ImageSource::CheckEncodedFormat(AbsImageFormatAgent &agent, const ImagePlugin::DataStreamBuffer &header)
+{
+    uint32_t size = agent.GetHeaderSize();
+    if (header.inputStreamBuffer == nullptr || header.dataSize < size) {
         IMAGE_LOGE("[ImageSource]the ouData is incomplete.");
         return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
     }
 
-    if (!agent.CheckFormat(outData.inputStreamBuffer, size)) {
+    if (!agent.CheckFormat(header.inputStreamBuffer, size)) {
         IMAGE_LOGE("[ImageSource]check mismatched format :%{public}s.", agent.GetFormatType().c_str());
         return ERR_IMAGE_MISMATCHED_FORMAT;
     }
     return SUCCESS;
 }
 
-uint32_t ImageSource::CheckFormatHint(const string &formatHint, FormatAgentMap::iterator &formatIter)
+uint32_t ImageSource::CheckFormatHint(const string &formatHint, const ImagePlugin::DataStreamBuffer &header,
+                                      FormatAgentMap::iterator &formatIter)
 {
     uint32_t ret = ERROR;
     formatIter = formatAgentMap_.find(formatHint);
@@ -764,7 +1188,7 @@ uint32_t ImageSource::CheckFormatHint(const string &formatHint, FormatAgentMap::
         return ret;
     }
     AbsImageFormatAgent *agent = formatIter->second;
-    ret = CheckEncodedFormat(*agent);
+    ret = CheckEncodedFormat(*agent, header);
     if (ret != SUCCESS) {
         if (ret == ERR_IMAGE_SOURCE_DATA_INCOMPLETE) {
             IMAGE_LOGE("[ImageSource]image source incomplete.");
@@ -777,9 +1201,16 @@ uint32_t ImageSource::CheckFormatHint(const string &formatHint, FormatAgentMap::
 uint32_t ImageSource::GetEncodedFormat(const string &formatHint, string &format)
 {
     bool streamIncomplete = false;
+    // peek the header once for all the format agents.
+    ImagePlugin::DataStreamBuffer header;
+    uint32_t peekRet = PeekFormatHeader(header);
+    if (peekRet == ERR_IMAGE_SOURCE_DATA && formatAgentMap_.find(formatHint) != formatAgentMap_.end()) {
+        IMAGE_LOGE("[ImageSource]image source data error.");
+        return peekRet;
+    }
     auto hintIter = formatAgentMap_.end();
     if (!formatHint.empty()) {
-        uint32_t ret = CheckFormatHint(formatHint, hintIter);
+        uint32_t ret = CheckFormatHint(formatHint, header, hintIter);
         if (ret == ERR_IMAGE_SOURCE_DATA) {
             IMAGE_LOGE("[ImageSource]image source data error.");
             return ret;
@@ -793,13 +1224,19 @@ uint32_t ImageSource::GetEncodedFormat(const string &formatHint, string &format)
         }
     }
 
-    for (auto iter = formatAgentMap_.begin(); iter != formatAgentMap_.end(); ++iter) {
-        string curFormat = iter->first;
-        if (iter == hintIter || curFormat == InnerFormat::RAW_FORMAT) {
+    if (peekRet != SUCCESS) {
+        // default return raw image
+        format = InnerFormat::RAW_FORMAT;
+        IMAGE_LOGI("[ImageSource]image default to raw format.");
+        return SUCCESS;
+    }
+    // only the agents which may match the leading byte are checked.
+    for (auto iter : formatDispatchTable_[header.inputStreamBuffer[0]]) {
+        if (iter == hintIter) {
             continue;  // has been checked before.
         }
         AbsImageFormatAgent *agent = iter->second;
-        auto ret = CheckEncodedFormat(*agent);
+        auto ret = CheckEncodedFormat(*agent, header);
         if (ret == ERR_IMAGE_MISMATCHED_FORMAT) {
             continue;
         } else if (ret == SUCCESS) {
@@ -987,11 +1424,14 @@ AbsImageDecoder *ImageSource::CreateDecoder(uint32_t &errorCode)
     // in normal mode, we can get actual encoded format to the user
     // but we need transfer to skia codec for adaption, "image/x-skia"
     std::string encodedFormat = sourceInfo_.encodedFormat;
-    if (opts_.sampleSize != 1) {
+    if (IsSkiaSampleDecode()) {
         encodedFormat = InnerFormat::EXTENDED_FORMAT;
     }
-    map<string, AttrData> capabilities = { { IMAGE_ENCODE_FORMAT, AttrData(encodedFormat) } };
-    auto decoder = pluginServer_.CreateObject<AbsImageDecoder>(AbsImageDecoder::SERVICE_DEFAULT, capabilities);
+    AbsImageDecoder *decoder = DecoderPool::GetInstance().Acquire(encodedFormat).release();
+    if (decoder == nullptr) {
+        map<string, AttrData> capabilities = { { IMAGE_ENCODE_FORMAT, AttrData(encodedFormat) } };
+        decoder = pluginServer_.CreateObject<AbsImageDecoder>(AbsImageDecoder::SERVICE_DEFAULT, capabilities);
+    }
     if (decoder == nullptr) {
         IMAGE_LOGE("[ImageSource]failed to create decoder object.");
         errorCode = ERR_IMAGE_PLUGIN_CREATE_FAILED;
@@ -1002,6 +1442,63 @@ AbsImageDecoder *ImageSource::CreateDecoder(uint32_t &errorCode)
     return decoder;
 }
 
+bool ImageSource::AcquirePooledDecoder(PooledDecoder &pooledDecoder)
+{
+    // incremental source keeps growing, its data can't be shared.
+    if (isIncrementalSource_) {
+        return false;
+    }
+    if (!decoderPool_.empty()) {
+        pooledDecoder = std::move(decoderPool_.back());
+        decoderPool_.pop_back();
+        return true;
+    }
+    pooledDecoder.stream = sourceStreamPtr_->CreateView();
+    if (pooledDecoder.stream == nullptr) {
+        return false;
+    }
+    uint32_t errorCode = SUCCESS;
+    pooledDecoder.decoder = std::unique_ptr<AbsImageDecoder>(CreateDecoder(errorCode));
+    if (pooledDecoder.decoder == nullptr) {
+        IMAGE_LOGE("[ImageSource]create pooled decoder fail, ret:%{public}u.", errorCode);
+        pooledDecoder.stream = nullptr;
+        return false;
+    }
+    pooledDecoder.decoder->SetSource(*pooledDecoder.stream);
+    return true;
+}
+
+void ImageSource::RecycleDecoders()
+{
+    // the decoders of incremental source may be in the middle of decoding.
+    bool isRecyclable = !isIncrementalSource_ && preference_ != MemoryUsagePreference::LOW_RAM;
+    if (isRecyclable) {
+        DecoderPool &pool = DecoderPool::GetInstance();
+        pool.Release(sourceInfo_.encodedFormat, std::move(mainDecoder_));
+        for (auto &pooledDecoder : decoderPool_) {
+            pool.Release(sourceInfo_.encodedFormat, std::move(pooledDecoder.decoder));
+        }
+    }
+    mainDecoder_ = nullptr;
+    decoderPool_.clear();
+}
+
+void ImageSource::ReleasePooledDecoder(PooledDecoder &pooledDecoder)
+{
+    if (decoderPool_.size() < MAX_POOLED_DECODERS) {
+        decoderPool_.push_back(std::move(pooledDecoder));
+    }
+}
+
+bool ImageSource::IsSkiaSampleDecode()
+{
+    if (opts_.sampleSize == DecodeOptions::DEFAULT_SAMPLE_SIZE) {
+        return false;
+    }
+    auto end = std::end(InnerFormat::NATIVE_SAMPLE_FORMATS);
+    return std::find(std::begin(InnerFormat::NATIVE_SAMPLE_FORMATS), end, sourceInfo_.encodedFormat) == end;
+}
+
 uint32_t ImageSource::SetDecodeOptions(std::unique_ptr<AbsImageDecoder> &decoder, uint32_t index,
                                        const DecodeOptions &opts, ImagePlugin::PlImageInfo &plInfo)
 {
@@ -1062,6 +1559,7 @@ void ImageSource::CopyOptionsToPlugin(const DecodeOptions &opts, PixelDecodeOpti
     plOpts.desiredColorSpace = (colorSearch != COLOR_SPACE_MAP.end()) ? colorSearch->second : PlColorSpace::UNKNOWN;
     plOpts.allowPartialImage = opts.allowPartialImage;
     plOpts.editable = opts.editable;
+    plOpts.cancelToken = opts.cancelToken;
 }
 
 void ImageSource::CopyOptionsToProcOpts(const DecodeOptions &opts, DecodeOptions &procOpts, PixelMap &pixelMap)
@@ -1084,6 +1582,7 @@ void ImageSource::CopyOptionsToProcOpts(const DecodeOptions &opts, DecodeOptions
     procOpts.desiredColorSpace = opts.desiredColorSpace;
     procOpts.allowPartialImage = opts.allowPartialImage;
     procOpts.editable = opts.editable;
+    procOpts.cancelToken = opts.cancelToken;
     // we need preference_ when post processing
     procOpts.preference = preference_;
 }
@@ -1142,6 +1641,9 @@ uint32_t ImageSource::DoIncrementalDecoding(uint32_t index, const DecodeOptions
     }
     IMAGE_LOGD("[ImageSource]do incremental decoding progress:%{public}u.", context.totalProcessProgress);
     recordContext.decodingProgress = context.totalProcessProgress;
+    if (context.renderedScans > recordContext.renderedScans) {
+        recordContext.renderedScans = context.renderedScans;
+    }
     if (ret != SUCCESS && ret != ERR_IMAGE_SOURCE_DATA_INCOMPLETE) {
         recordContext.IncrementalState = ImageDecodingState::IMAGE_ERROR;
         IMAGE_LOGE("[ImageSource]do incremental decoding source fail, ret:%{public}u.", ret);
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_map_future.h"
+#include <chrono>
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+
+bool PixelMapFuture::IsReady()
+{
+    lock_guard<mutex> guard(mutex_);
+    return isReady_;
+}
+
+void PixelMapFuture::Wait()
+{
+    unique_lock<mutex> guard(mutex_);
+    readyCond_.wait(guard, [this] { return isReady_; });
+}
+
+bool PixelMapFuture::WaitFor(uint32_t timeoutMs)
+{
+    unique_lock<mutex> guard(mutex_);
+    return readyCond_.wait_for(guard, chrono::milliseconds(timeoutMs), [this] { return isReady_; });
+}
+
+unique_ptr<PixelMap> PixelMapFuture::Get(uint32_t &errorCode)
+{
+    unique_lock<mutex> guard(mutex_);
+    readyCond_.wait(guard, [this] { return isReady_; });
+    errorCode = errorCode_;
+    return move(pixelMap_);
+}
+
+void PixelMapFuture::Cancel()
+{
+    if (cancelToken_ != nullptr) {
+        cancelToken_->Cancel();
+    }
+}
+
+void PixelMapFuture::SetResult(unique_ptr<PixelMap> pixelMap, uint32_t errorCode)
+{
+    DecodeCompleteCallback callback;
+    {
+        lock_guard<mutex> guard(mutex_);
+        pixelMap_ = move(pixelMap);
+        errorCode_ = errorCode;
+        isReady_ = true;
+        callback = move(callback_);
+    }
+    readyCond_.notify_all();
+    if (callback != nullptr) {
+        callback(errorCode);
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include "image_log.h"
+#include "plugin_server.h"
+
+// the interface functions of the built-in plugins linked into the library, which are named by their packages.
+#define DECLARE_STATIC_PLUGIN(package) \
+extern "C" { \
+    bool package##ExternalStart(); \
+    void package##ExternalStop(); \
+    OHOS::MultimediaPlugin::PluginClassBase *package##ExternalCreate(const std::string &className); \
+}
+
+#define STATIC_PLUGIN_ENTRY(package) \
+    { #package, package##ExternalStart, package##ExternalStop, package##ExternalCreate }
+
+DECLARE_STATIC_PLUGIN(LibImageFormatAgent)
+DECLARE_STATIC_PLUGIN(LibBmpPlugin)
+DECLARE_STATIC_PLUGIN(LibGifPlugin)
+DECLARE_STATIC_PLUGIN(LibJpegPlugin)
+DECLARE_STATIC_PLUGIN(LibPngPlugin)
+DECLARE_STATIC_PLUGIN(LibWbmpPlugin)
+DECLARE_STATIC_PLUGIN(LibWebpPlugin)
+
+namespace OHOS {
+namespace Media {
+using namespace MultimediaPlugin;
+
+namespace {
+struct StaticPluginEntry {
+    const char *packageName;
+    PluginServer::StaticStartFunc startFunc;
+    PluginServer::StaticStopFunc stopFunc;
+    PluginServer::StaticCreateFunc createFunc;
+};
+
+const StaticPluginEntry STATIC_PLUGINS[] = {
+    STATIC_PLUGIN_ENTRY(LibImageFormatAgent),
+    STATIC_PLUGIN_ENTRY(LibBmpPlugin),
+    STATIC_PLUGIN_ENTRY(LibGifPlugin),
+    STATIC_PLUGIN_ENTRY(LibJpegPlugin),
+    STATIC_PLUGIN_ENTRY(LibPngPlugin),
+    STATIC_PLUGIN_ENTRY(LibWbmpPlugin),
+    STATIC_PLUGIN_ENTRY(LibWebpPlugin),
+};
+
+// the packages are still registered from the metadata in the plugin paths, this only tells the plugin manager
+// to use the linked functions instead of loading their libraries, so it is done once when the library is loaded.
+bool RegisterStaticPlugins()
+{
+    PluginServer &pluginServer = DelayedRefSingleton<PluginServer>::GetInstance();
+    for (const StaticPluginEntry &entry : STATIC_PLUGINS) {
+        uint32_t ret = pluginServer.RegisterStaticPlugin(entry.packageName, entry.startFunc, entry.stopFunc,
+                                                         entry.createFunc);
+        if (ret != SUCCESS) {
+            IMAGE_LOGE("[StaticImagePlugins]failed to register %{public}s, ret:%{public}u.", entry.packageName, ret);
+        }
+    }
+    return true;
+}
+
+[[maybe_unused]] const bool STATIC_PLUGINS_REGISTERED = RegisterStaticPlugins();
+} // namespace
+} // namespace Media
+} // namespace OHOS
@@ -85,12 +85,16 @@ uint32_t IncrementalPixelMap::PromoteDecoding(uint8_t &decodeProgress)
         return ERR_IMAGE_SOURCE_DATA;
     }
     ImageDecodingState imageState = ImageDecodingState::UNRESOLVED;
-    uint32_t ret =
-        imageSource_->PromoteDecoding(index_, opts_, *(static_cast<PixelMap *>(this)), imageState, decodeProgress);
+    uint32_t renderedScans = 0;
+    uint32_t ret = imageSource_->PromoteDecoding(index_, opts_, *(static_cast<PixelMap *>(this)), imageState,
+                                                 decodeProgress, renderedScans);
     decodingStatus_.state = ConvertImageStateToIncrementalState(imageState);
     if (decodeProgress > decodingStatus_.decodingProgress) {
         decodingStatus_.decodingProgress = decodeProgress;
     }
+    if (renderedScans > decodingStatus_.renderedScans) {
+        decodingStatus_.renderedScans = renderedScans;
+    }
     if (ret != SUCCESS && ret != ERR_IMAGE_SOURCE_DATA_INCOMPLETE) {
         DetachSource();
         decodingStatus_.errorDetail = ret;
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_map_cache.h"
+#include "hilog/log.h"
+#include "log_tags.h"
+
+namespace OHOS {
+namespace Media {
+using namespace OHOS::HiviewDFX;
+
+static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "PixelMapCache" };
+static constexpr uint64_t LOW_RAM_BUDGET_DIVISOR = 4;
+
+PixelMapCache &PixelMapCache::GetInstance()
+{
+    static PixelMapCache instance;
+    return instance;
+}
+
+void PixelMapCache::SetBudget(uint64_t budgetBytes)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    budgetBytes_ = budgetBytes;
+    EvictTo(budgetBytes_);
+}
+
+uint64_t PixelMapCache::GetBudget()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return budgetBytes_;
+}
+
+bool PixelMapCache::IsEnabled()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return budgetBytes_ > 0;
+}
+
+void PixelMapCache::Clear()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    EvictTo(0);
+}
+
+PixelMapCacheStats PixelMapCache::GetStats()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    PixelMapCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.usedBytes = usedBytes_;
+    stats.budgetBytes = budgetBytes_;
+    stats.entryCount = static_cast<uint32_t>(entries_.size());
+    return stats;
+}
+
+void PixelMapCache::ResetStats()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+std::shared_ptr<const CachedPixels> PixelMapCache::Get(const std::string &key)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (budgetBytes_ == 0) {
+        return nullptr;
+    }
+    auto iter = entries_.find(key);
+    if (iter == entries_.end()) {
+        misses_++;
+        return nullptr;
+    }
+    hits_++;
+    lruList_.splice(lruList_.begin(), lruList_, iter->second);
+    return iter->second->second;
+}
+
+void PixelMapCache::Put(const std::string &key, std::shared_ptr<const CachedPixels> entry,
+                        MemoryUsagePreference preference)
+{
+    if (entry == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint64_t limitBytes = budgetBytes_;
+    if (preference == MemoryUsagePreference::LOW_RAM) {
+        limitBytes /= LOW_RAM_BUDGET_DIVISOR;
+    }
+    uint64_t entryBytes = entry->pixels.size();
+    if (entryBytes == 0 || entryBytes > limitBytes) {
+        HiLog::Debug(LABEL, "entry size %{public}llu exceeds cache limit %{public}llu.",
+                     static_cast<unsigned long long>(entryBytes), static_cast<unsigned long long>(limitBytes));
+        return;
+    }
+    auto iter = entries_.find(key);
+    if (iter != entries_.end()) {
+        usedBytes_ -= iter->second->second->pixels.size();
+        lruList_.erase(iter->second);
+        entries_.erase(iter);
+    }
+    EvictTo(limitBytes - entryBytes);
+    lruList_.emplace_front(key, std::move(entry));
+    entries_[key] = lruList_.begin();
+    usedBytes_ += entryBytes;
+}
+
+void PixelMapCache::EvictTo(uint64_t limitBytes)
+{
+    while (usedBytes_ > limitBytes && !lruList_.empty()) {
+        auto &last = lruList_.back();
+        usedBytes_ -= last.second->pixels.size();
+        entries_.erase(last.first);
+        lruList_.pop_back();
+        evictions_++;
+    }
+}
+} // namespace Media
+} // namespace OHOS
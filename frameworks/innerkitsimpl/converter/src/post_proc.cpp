@@ -39,6 +39,11 @@ constexpr uint32_t NEED_NEXT = 1;
 constexpr float EPSILON = 1e-6;
 constexpr uint8_t HALF = 2;
 
+static bool IsDecodeCanceled(const DecodeOptions &opts)
+{
+    return opts.cancelToken != nullptr && opts.cancelToken->IsCanceled();
+}
+
 uint32_t PostProc::DecodePostProc(const DecodeOptions &opts, PixelMap &pixelMap, FinalOutputStep finalOutputStep)
 {
     ImageInfo srcImageInfo;
@@ -55,6 +60,10 @@ uint32_t PostProc::DecodePostProc(const DecodeOptions &opts, PixelMap &pixelMap,
         return errorCode;
     }
     decodeOpts_.allocatorType = opts.allocatorType;
+    if (IsDecodeCanceled(opts)) {
+        IMAGE_LOGI("[PostProc]decoding canceled after convert.");
+        return ERR_IMAGE_DECODE_CANCELED;
+    }
     bool isNeedRotate = !ImageUtils::FloatCompareZero(opts.rotateDegrees);
     if (isNeedRotate) {
         if (finalOutputStep == FinalOutputStep::SIZE_CHANGE || finalOutputStep == FinalOutputStep::DENSITY_CHANGE) {
@@ -66,6 +75,10 @@ uint32_t PostProc::DecodePostProc(const DecodeOptions &opts, PixelMap &pixelMap,
         }
     }
     decodeOpts_.allocatorType = opts.allocatorType;
+    if (IsDecodeCanceled(opts)) {
+        IMAGE_LOGI("[PostProc]decoding canceled after rotate.");
+        return ERR_IMAGE_DECODE_CANCELED;
+    }
     if (opts.desiredSize.height > 0 && opts.desiredSize.width > 0) {
         if (!ScalePixelMap(opts.desiredSize, pixelMap)) {
             IMAGE_LOGE("[PostProc]scale:transform pixel map failed");
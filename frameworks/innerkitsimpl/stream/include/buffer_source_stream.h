@@ -31,15 +31,19 @@ public:
     bool Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
     bool Peek(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData) override;
     bool Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    bool ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    uint32_t GetContiguousSize() override;
     uint32_t Tell() override;
     bool Seek(uint32_t position) override;
     size_t GetStreamSize() override;
     uint8_t *GetDataPtr() override;
     uint32_t GetStreamType() override;
+    std::unique_ptr<SourceStream> CreateView() override;
 
 private:
     BufferSourceStream(uint8_t *data, uint32_t size, uint32_t offset);
     uint8_t *inputBuffer_ = nullptr;
+    bool isDataOwner_ = true;  // a view shares the buffer of the stream it is created from.
     size_t dataSize_ = 0;
     size_t dataOffset_ = 0;
 };
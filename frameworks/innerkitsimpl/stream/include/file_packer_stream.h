@@ -17,6 +17,8 @@
 #define FILE_PACKER_STREAM_H
 
 #include <fstream>
+#include <string>
+#include <vector>
 #include "hilog/log.h"
 #include "log_tags.h"
 #include "nocopyable.h"
@@ -27,16 +29,35 @@ namespace Media {
 class FilePackerStream : public PackerStream {
 public:
     explicit FilePackerStream(const std::string &filePath);
+    // with isAtomic, the data is written to a temporary file, which replaces the file at filePath in Flush,
+    // so the file at filePath is either the old one or complete.
+    FilePackerStream(const std::string &filePath, bool isAtomic);
     explicit FilePackerStream(const int fd);
     ~FilePackerStream() override;
     bool Write(const uint8_t *buffer, uint32_t size) override;
     void Flush() override;
+    void SetExpectedSize(uint32_t size) override;
     int64_t BytesWritten() override;
+    // the small writes are combined into a buffer of this size, 0 writes each of them to the file directly.
+    // it takes effect before the first write.
+    void SetBufferSize(uint32_t size);
 
 private:
     DISALLOW_COPY(FilePackerStream);
     static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "FilePackerStream" };
+    static constexpr uint32_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+    void Open(const std::string &filePath, bool isAtomic);
+    bool WriteFile(const uint8_t *buffer, uint32_t size);
+    bool FlushBuffer();
+    void ReleasePreallocated();
+    void CloseFile();
     FILE *file_ = nullptr;
+    bool isOwner_ = false;  // opened by path, so it can be preallocated and truncated.
+    uint32_t bufferSize_ = DEFAULT_BUFFER_SIZE;
+    std::vector<uint8_t> buffer_;
+    int64_t preallocatedSize_ = 0;
+    std::string targetPath_;
+    std::string tempPath_;  // not empty until the temporary file replaces the target in Flush.
 };
 } // namespace Media
 } // namespace OHOS
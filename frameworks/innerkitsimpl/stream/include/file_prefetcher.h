@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FILE_PREFETCHER_H
+#define FILE_PREFETCHER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+// reads a file ahead of the reader on a background thread into a ring of blocks, so the decoding overlaps with
+// the file io. the file is read by offset, its position is not used.
+class FilePrefetcher {
+public:
+    // prefetch the data in [offset, fileSize) of fd, which must be valid until the prefetcher is destroyed.
+    FilePrefetcher(int fd, size_t offset, size_t fileSize, uint32_t ringSize);
+    ~FilePrefetcher();
+    bool Start();
+    // read exactly size bytes at offset, from the ring if prefetched, otherwise from the file, then prefetch the
+    // data after it. the data read stays in the ring until a read after it, so a peek doesn't consume it.
+    bool Read(size_t offset, uint8_t *buffer, size_t size);
+    // the number of reads which were not served by the ring only and read the file.
+    uint64_t GetDirectReadCount();
+
+private:
+    DISALLOW_COPY_AND_MOVE(FilePrefetcher);
+    static constexpr uint32_t MAX_BLOCK_SIZE = 64 * 1024;
+    static constexpr uint32_t MIN_BLOCK_COUNT = 4;
+    void PrefetchLoop();
+    bool ReadFile(size_t offset, uint8_t *buffer, size_t size);
+    size_t GetFilledEnd() const;
+    size_t CopyFromRing(size_t offset, uint8_t *buffer, size_t size);
+    void DropHeadBlock();
+    void DropBlocksBefore(size_t offset);
+    void ResetRing(size_t offset);
+
+    int fd_ = -1;
+    size_t fileSize_ = 0;
+    uint32_t blockSize_ = 0;
+    uint32_t blockCount_ = 0;
+    std::vector<uint8_t> ring_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::thread thread_;
+    // the filled blocks start from the block at headIndex_, which holds the data at ringOffset_.
+    size_t ringOffset_ = 0;
+    uint32_t headIndex_ = 0;
+    uint32_t filledCount_ = 0;
+    uint64_t generation_ = 0;  // changed by each reset, the block being read for an old one is dropped.
+    uint64_t directReadCount_ = 0;
+    bool isReading_ = false;
+    bool isFailed_ = false;  // stop prefetching after an io error, the reader reports it by reading directly.
+    bool isStopped_ = false;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FILE_PREFETCHER_H
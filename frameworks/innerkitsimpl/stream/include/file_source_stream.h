@@ -19,6 +19,7 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include "file_prefetcher.h"
 #include "image/input_data_stream.h"
 #include "source_stream.h"
 
@@ -34,11 +35,20 @@ public:
     bool Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
     bool Peek(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData) override;
     bool Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    bool ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
     uint32_t Tell() override;
     bool Seek(uint32_t position) override;
     size_t GetStreamSize() override;
     uint8_t *GetDataPtr() override;
     uint32_t GetStreamType() override;
+    std::unique_ptr<SourceStream> CreateView() override;
+    // advise the kernel to read the file ahead, and read it ahead on a background thread if the prefetch size is set.
+    void PrepareSequentialRead() override;
+    // the size of the data read ahead of the decoder on a background thread, 0 disables it.
+    // it takes effect at the next PrepareSequentialRead.
+    void SetPrefetchSize(uint32_t size);
+    // the number of reads which missed the prefetched data and read the file directly.
+    uint64_t GetPrefetchMissCount();
 
 private:
     DISALLOW_COPY_AND_MOVE(FileSourceStream);
@@ -46,11 +56,16 @@ private:
     bool GetData(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize);
     bool GetData(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData);
     void ResetReadBuffer();
+    size_t ReadFile(uint8_t *buffer, size_t size);
     std::FILE *filePtr_ = nullptr;
     size_t fileSize_ = 0;
     size_t fileOffset_ = 0;
     size_t fileOriginalOffset_ = 0;
-    uint8_t *readBuffer_ = nullptr;
+    uint8_t *readBuffer_ = nullptr;  // reused by the reads which output a DataStreamBuffer.
+    uint32_t readBufferSize_ = 0;
+    std::string filePath_;  // only known when opened by path, a view reopens the file.
+    uint32_t prefetchSize_ = 0;
+    std::unique_ptr<FilePrefetcher> prefetcher_;  // reads the file by offset instead of filePtr_ once created.
 };
 } // namespace Media
 } // namespace OHOS
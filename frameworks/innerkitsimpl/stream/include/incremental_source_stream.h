@@ -27,12 +27,18 @@ namespace OHOS {
 namespace Media {
 class IncrementalSourceStream : public SourceStream {
 public:
-    static std::unique_ptr<IncrementalSourceStream> CreateSourceStream(IncrementalMode mode);
+    // expectedSize is the total size of the data if the caller knows it, which is reserved at the first update.
+    static std::unique_ptr<IncrementalSourceStream> CreateSourceStream(IncrementalMode mode,
+                                                                       uint32_t expectedSize = 0);
     ~IncrementalSourceStream() = default;
     bool Read(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData) override;
     bool Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
     bool Peek(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData) override;
     bool Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    // copies across the chunks without merging them, nothing is read at the end of the data updated so far.
+    bool ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    // the data left in the current chunk, a longer read merges the chunks it spans.
+    uint32_t GetContiguousSize() override;
     uint32_t Tell() override;
     bool Seek(uint32_t position) override;
 
@@ -41,10 +47,16 @@ public:
     size_t GetStreamSize() override;
 
 private:
-    explicit IncrementalSourceStream(IncrementalMode mode);
+    IncrementalSourceStream(IncrementalMode mode, uint32_t expectedSize);
+    void AppendData(const uint8_t *data, uint32_t size);
+    size_t FindChunk(size_t offset) const;
+    void MergeChunks(size_t first, size_t last);
     IncrementalMode incrementalMode_;
     bool isFinalize_;
-    std::vector<uint8_t> sourceData_;
+    uint32_t expectedSize_ = 0;
+    // the updated data is copied once into the chunks, the chunks a read spans are merged into one on demand.
+    std::vector<std::vector<uint8_t>> chunks_;
+    std::vector<size_t> chunkOffsets_;  // the offset of each chunk in the stream.
     size_t dataSize_ = 0;
     size_t dataOffset_ = 0;
 };
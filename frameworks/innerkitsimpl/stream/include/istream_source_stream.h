@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <vector>
 #include "image/input_data_stream.h"
 #include "source_stream.h"
 
@@ -27,11 +28,15 @@ namespace Media {
 class IstreamSourceStream : public SourceStream {
 public:
     static std::unique_ptr<IstreamSourceStream> CreateSourceStream(std::unique_ptr<std::istream> inputStream);
-    ~IstreamSourceStream();
+    ~IstreamSourceStream() = default;
+    // the data after the current position read from the input stream at least, which serves the following small
+    // reads and peeks from memory. 0 disables reading ahead.
+    void SetReadAheadSize(uint32_t size);
     bool Read(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData) override;
     bool Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
     bool Peek(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData) override;
     bool Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    bool ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
     uint32_t Tell() override;
     bool Seek(uint32_t position) override;
     size_t GetStreamSize() override;
@@ -43,12 +48,20 @@ private:
     IstreamSourceStream(std::unique_ptr<std::istream> inputStream, size_t size, size_t original, size_t offset);
     bool GetData(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize);
     bool GetData(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData);
-    void ResetReadBuffer();
+    bool IsInWindow(uint32_t size) const;
+    bool FillWindow(uint32_t desiredSize);
+    bool ReadInput(size_t position, uint8_t *buffer, size_t size);
+    static constexpr uint32_t DEFAULT_READ_AHEAD_SIZE = 16 * 1024;  // same as the default of SourceOptions.
     std::unique_ptr<std::istream> inputStream_;
     size_t streamSize_ = 0;
     size_t streamOriginalOffset_ = 0;
     size_t streamOffset_ = 0;
-    uint8_t *databuffer_ = nullptr;
+    size_t inputPosition_ = 0;  // the position of the input stream, the seeks to it are skipped.
+    uint32_t readAheadSize_ = DEFAULT_READ_AHEAD_SIZE;
+    // the window of the stream data read last, which grows as needed and is reused.
+    std::vector<uint8_t> window_;
+    size_t windowOffset_ = 0;
+    size_t windowSize_ = 0;
 };
 } // namespace Media
 } // namespace OHOS
@@ -17,6 +17,7 @@
 #define SOURCE_STREAM_H
 
 #include <cinttypes>
+#include <memory>
 #include "image/input_data_stream.h"
 #include "media_errors.h"
 
@@ -28,6 +29,16 @@ public:
     {
         return ERR_IMAGE_DATA_UNSUPPORT;
     }
+
+    // create a stream reading the same data with its own position, so that several decoders can read the source
+    // at the same time. the view must not outlive this stream. return nullptr if the data can't be shared.
+    virtual std::unique_ptr<SourceStream> CreateView()
+    {
+        return nullptr;
+    }
+
+    // called before decoding the image, the data from the current position on is about to be read in order.
+    virtual void PrepareSequentialRead() {}
 };
 } // namespace Media
 } // namespace OHOS
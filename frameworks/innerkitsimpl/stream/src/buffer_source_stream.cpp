@@ -15,6 +15,7 @@
 
 #include "buffer_source_stream.h"
 
+#include <algorithm>
 #include <string>
 #include "image_log.h"
 #ifndef _WIN32
@@ -35,7 +36,7 @@ BufferSourceStream::BufferSourceStream(uint8_t *data, uint32_t size, uint32_t of
 
 BufferSourceStream::~BufferSourceStream()
 {
-    if (inputBuffer_ != nullptr) {
+    if (inputBuffer_ != nullptr && isDataOwner_) {
         free(inputBuffer_);
         inputBuffer_ = nullptr;
     }
@@ -130,6 +131,28 @@ bool BufferSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t
     return true;
 }
 
+bool BufferSourceStream::ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize)
+{
+    if (outBuffer == nullptr || bufferSize == 0) {
+        IMAGE_LOGE("[BufferSourceStream]read into input parameter exception, bufferSize:%{public}u.", bufferSize);
+        return false;
+    }
+    readSize = 0;
+    if (dataOffset_ >= dataSize_) {
+        return true;
+    }
+    if (!Read(min(bufferSize, static_cast<uint32_t>(dataSize_ - dataOffset_)), outBuffer, bufferSize, readSize)) {
+        IMAGE_LOGE("[BufferSourceStream]read into fail.");
+        return false;
+    }
+    return true;
+}
+
+uint32_t BufferSourceStream::GetContiguousSize()
+{
+    return (dataOffset_ < dataSize_) ? static_cast<uint32_t>(dataSize_ - dataOffset_) : 0;
+}
+
 uint32_t BufferSourceStream::Tell()
 {
     return dataOffset_;
@@ -159,5 +182,16 @@ uint32_t BufferSourceStream::GetStreamType()
 {
     return ImagePlugin::BUFFER_SOURCE_TYPE;
 }
+
+unique_ptr<SourceStream> BufferSourceStream::CreateView()
+{
+    BufferSourceStream *view = new (std::nothrow) BufferSourceStream(inputBuffer_, dataSize_, 0);
+    if (view == nullptr) {
+        IMAGE_LOGE("[BufferSourceStream]create the stream view fail.");
+        return nullptr;
+    }
+    view->isDataOwner_ = false;
+    return unique_ptr<SourceStream>(view);
+}
 }  // namespace Media
 }  // namespace OHOS
@@ -14,15 +14,54 @@
  */
 
 #include "file_packer_stream.h"
+#include <atomic>
 #include <cerrno>
 #include "directory_ex.h"
 #include "image_utils.h"
+#if !defined(_WIN32) && !defined(_APPLE)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace OHOS {
 namespace Media {
 using namespace OHOS::HiviewDFX;
 
 FilePackerStream::FilePackerStream(const std::string &filePath)
+{
+    Open(filePath, false);
+}
+
+FilePackerStream::FilePackerStream(const std::string &filePath, bool isAtomic)
+{
+    Open(filePath, isAtomic);
+}
+
+FilePackerStream::FilePackerStream(const int fd)
+{
+    file_ = fdopen(fd, "wb");
+    if (file_ == nullptr) {
+        HiLog::Error(LABEL, "fopen file failed, error:%{public}d", errno);
+        return;
+    }
+    // the writes are combined in buffer_ already.
+    setvbuf(file_, nullptr, _IONBF, 0);
+}
+
+FilePackerStream::~FilePackerStream()
+{
+    if (file_ != nullptr) {
+        FlushBuffer();
+        ReleasePreallocated();
+    }
+    CloseFile();
+    if (!tempPath_.empty()) {
+        // not replaced the target in Flush, the data is incomplete.
+        remove(tempPath_.c_str());
+    }
+}
+
+void FilePackerStream::Open(const std::string &filePath, bool isAtomic)
 {
     std::string dirPath = ExtractFilePath(filePath);
     std::string fileName = ExtractFileName(filePath);
@@ -40,26 +79,42 @@ FilePackerStream::FilePackerStream(const std::string &filePath)
     }
 
     std::string fullPath = realPath + "/" + fileName;
-    file_ = fopen(fullPath.c_str(), "wb");
-    if (file_ == nullptr) {
-        HiLog::Error(LABEL, "fopen file failed, error:%{public}d", errno);
-        return;
+#if !defined(_WIN32) && !defined(_APPLE)
+    if (isAtomic) {
+        // unique among the streams of the process, and exclusive with the other processes.
+        static std::atomic<uint32_t> tempIndex(0);
+        std::string tempPath = fullPath + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(tempIndex++);
+        int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP |
+                      S_IWGRP | S_IROTH | S_IWOTH);
+        if (fd < 0) {
+            HiLog::Error(LABEL, "open temporary file failed, error:%{public}d", errno);
+            return;
+        }
+        file_ = fdopen(fd, "wb");
+        if (file_ == nullptr) {
+            HiLog::Error(LABEL, "fdopen temporary file failed, error:%{public}d", errno);
+            close(fd);
+            remove(tempPath.c_str());
+            return;
+        }
+        targetPath_ = fullPath;
+        tempPath_ = tempPath;
     }
-}
-FilePackerStream::FilePackerStream(const int fd)
-{
-    file_ = fdopen(fd, "wb");
-    if (file_ == nullptr) {
-        HiLog::Error(LABEL, "fopen file failed, error:%{public}d", errno);
-        return;
+#else
+    if (isAtomic) {
+        HiLog::Warn(LABEL, "atomic replacing is unsupported, write the file directly.");
     }
-}
-FilePackerStream::~FilePackerStream()
-{
-    if (file_ != nullptr) {
-        fclose(file_);
-        file_ = nullptr;
+#endif
+    if (file_ == nullptr) {
+        file_ = fopen(fullPath.c_str(), "wb");
+        if (file_ == nullptr) {
+            HiLog::Error(LABEL, "fopen file failed, error:%{public}d", errno);
+            return;
+        }
     }
+    isOwner_ = true;
+    // the writes are combined in buffer_ already.
+    setvbuf(file_, nullptr, _IONBF, 0);
 }
 
 bool FilePackerStream::Write(const uint8_t *buffer, uint32_t size)
@@ -72,25 +127,105 @@ bool FilePackerStream::Write(const uint8_t *buffer, uint32_t size)
         HiLog::Error(LABEL, "output file is null.");
         return false;
     }
-    if (fwrite(buffer, sizeof(uint8_t), size, file_) != size) {
-        HiLog::Error(LABEL, "write %{public}u bytes failed.", size);
-        fclose(file_);
-        file_ = nullptr;
+    if (buffer_.size() + size > bufferSize_ && !FlushBuffer()) {
         return false;
     }
+    if (size >= bufferSize_) {
+        // too large to combine, the buffer is empty here.
+        return WriteFile(buffer, size);
+    }
+    if (buffer_.capacity() < bufferSize_) {
+        buffer_.reserve(bufferSize_);
+    }
+    buffer_.insert(buffer_.end(), buffer, buffer + size);
     return true;
 }
 
 void FilePackerStream::Flush()
 {
-    if (file_ != nullptr) {
-        fflush(file_);
+    if (file_ == nullptr) {
+        return;
+    }
+    if (!FlushBuffer()) {
+        return;
+    }
+    fflush(file_);
+    ReleasePreallocated();
+    if (!tempPath_.empty()) {
+        if (rename(tempPath_.c_str(), targetPath_.c_str()) != 0) {
+            HiLog::Error(LABEL, "replace the target file failed, error:%{public}d", errno);
+            return;
+        }
+        tempPath_.clear();
     }
 }
 
+void FilePackerStream::SetExpectedSize(uint32_t size)
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    // the file got by fd may be shared with others, only the file opened by path is preallocated.
+    if (file_ == nullptr || !isOwner_ || size <= preallocatedSize_) {
+        return;
+    }
+    // keep the file size, so the file is still right if it is not truncated at last.
+    if (fallocate(fileno(file_), FALLOC_FL_KEEP_SIZE, 0, size) != 0) {
+        HiLog::Debug(LABEL, "preallocate %{public}u bytes failed, error:%{public}d", size, errno);
+        return;
+    }
+    preallocatedSize_ = size;
+#endif
+}
+
 int64_t FilePackerStream::BytesWritten()
 {
-    return (file_ != nullptr) ? ftell(file_) : 0;
+    return (file_ != nullptr) ? (ftell(file_) + static_cast<int64_t>(buffer_.size())) : 0;
+}
+
+void FilePackerStream::SetBufferSize(uint32_t size)
+{
+    bufferSize_ = size;
+}
+
+bool FilePackerStream::WriteFile(const uint8_t *buffer, uint32_t size)
+{
+    if (fwrite(buffer, sizeof(uint8_t), size, file_) != size) {
+        HiLog::Error(LABEL, "write %{public}u bytes failed.", size);
+        CloseFile();
+        return false;
+    }
+    return true;
+}
+
+bool FilePackerStream::FlushBuffer()
+{
+    if (buffer_.empty()) {
+        return true;
+    }
+    bool ret = WriteFile(buffer_.data(), buffer_.size());
+    buffer_.clear();
+    return ret;
+}
+
+void FilePackerStream::ReleasePreallocated()
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    // truncating to the written size frees the preallocated blocks which are not used.
+    long written = ftell(file_);
+    if (preallocatedSize_ > 0 && written >= 0 && written < preallocatedSize_) {
+        if (ftruncate(fileno(file_), written) != 0) {
+            HiLog::Debug(LABEL, "release the preallocated blocks failed, error:%{public}d", errno);
+        }
+    }
+    preallocatedSize_ = 0;
+#endif
+}
+
+void FilePackerStream::CloseFile()
+{
+    if (file_ != nullptr) {
+        fclose(file_);
+        file_ = nullptr;
+    }
 }
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "file_prefetcher.h"
+#include <algorithm>
+#include <cerrno>
+#include "image_log.h"
+#include "securec.h"
+#if !defined(_WIN32) && !defined(_APPLE)
+#include <unistd.h>
+#endif
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+
+// a few blocks at least, so the blocks ahead are prefetched while the reader holds the current one.
+FilePrefetcher::FilePrefetcher(int fd, size_t offset, size_t fileSize, uint32_t ringSize)
+    : fd_(fd), fileSize_(fileSize), blockSize_(min(ringSize / MIN_BLOCK_COUNT, MAX_BLOCK_SIZE)),
+      ringOffset_(offset)
+{
+    blockCount_ = (blockSize_ == 0) ? 0 : (ringSize / blockSize_);
+}
+
+FilePrefetcher::~FilePrefetcher()
+{
+    {
+        lock_guard<mutex> guard(mutex_);
+        isStopped_ = true;
+    }
+    cond_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool FilePrefetcher::Start()
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    if (fd_ < 0 || blockCount_ == 0 || thread_.joinable()) {
+        IMAGE_LOGE("[FilePrefetcher]start prefetching fail, fd:%{public}d, blockCount:%{public}u.", fd_,
+                   blockCount_);
+        return false;
+    }
+    ring_.resize(static_cast<size_t>(blockSize_) * blockCount_);
+    thread_ = thread(&FilePrefetcher::PrefetchLoop, this);
+    return true;
+#else
+    IMAGE_LOGE("[FilePrefetcher]prefetching is unsupported.");
+    return false;
+#endif
+}
+
+bool FilePrefetcher::Read(size_t offset, uint8_t *buffer, size_t size)
+{
+    size_t copied = 0;
+    {
+        unique_lock<mutex> guard(mutex_);
+        // the blocks before the reader are not needed any more, free them for the data ahead.
+        DropBlocksBefore(offset);
+        while (copied < size) {
+            size_t position = offset + copied;
+            if (position < ringOffset_) {
+                break;
+            }
+            size_t filledEnd = GetFilledEnd();
+            if (position < filledEnd) {
+                size_t count = CopyFromRing(position, buffer + copied, size - copied);
+                if (count == 0) {
+                    break;
+                }
+                copied += count;
+                continue;
+            }
+            if (filledCount_ == blockCount_) {
+                // the read is larger than the ring, the blocks copied are freed for the rest of it.
+                DropBlocksBefore(position);
+                continue;
+            }
+            // the block is being read or going to be read next, waiting costs less than reading it again.
+            bool isPending = (isReading_ || filledCount_ < blockCount_) && !isFailed_ && filledEnd < fileSize_;
+            if (!isPending || position - filledEnd >= blockSize_) {
+                break;
+            }
+            cond_.wait(guard);
+        }
+        if (copied == size) {
+            return true;
+        }
+        // out of the ring, such as after a seek. prefetch from the end of the data read directly.
+        directReadCount_++;
+        ResetRing(offset + size);
+    }
+    return ReadFile(offset + copied, buffer + copied, size - copied);
+}
+
+uint64_t FilePrefetcher::GetDirectReadCount()
+{
+    lock_guard<mutex> guard(mutex_);
+    return directReadCount_;
+}
+
+void FilePrefetcher::PrefetchLoop()
+{
+    unique_lock<mutex> guard(mutex_);
+    while (true) {
+        cond_.wait(guard, [this] {
+            return isStopped_ || (!isFailed_ && filledCount_ < blockCount_ && GetFilledEnd() < fileSize_);
+        });
+        if (isStopped_) {
+            return;
+        }
+        size_t offset = GetFilledEnd();
+        size_t size = min(static_cast<size_t>(blockSize_), fileSize_ - offset);
+        // the reader never touches the block after the filled ones, so it is filled without the lock.
+        uint8_t *block = ring_.data() + static_cast<size_t>((headIndex_ + filledCount_) % blockCount_) * blockSize_;
+        uint64_t generation = generation_;
+        isReading_ = true;
+        guard.unlock();
+        bool ret = ReadFile(offset, block, size);
+        guard.lock();
+        isReading_ = false;
+        if (generation == generation_) {
+            if (ret) {
+                filledCount_++;
+            } else {
+                isFailed_ = true;
+            }
+        }
+        cond_.notify_all();
+    }
+}
+
+bool FilePrefetcher::ReadFile(size_t offset, uint8_t *buffer, size_t size)
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    while (size > 0) {
+        ssize_t ret = pread(fd_, buffer, size, static_cast<off_t>(offset));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            IMAGE_LOGE("[FilePrefetcher]read fail, offset:%{public}zu, ret:%{public}zd, errno:%{public}d.", offset,
+                       ret, errno);
+            return false;
+        }
+        buffer += ret;
+        offset += static_cast<size_t>(ret);
+        size -= static_cast<size_t>(ret);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t FilePrefetcher::GetFilledEnd() const
+{
+    return min(ringOffset_ + static_cast<size_t>(filledCount_) * blockSize_, fileSize_);
+}
+
+size_t FilePrefetcher::CopyFromRing(size_t offset, uint8_t *buffer, size_t size)
+{
+    size_t inRing = offset - ringOffset_;
+    size_t inBlock = inRing % blockSize_;
+    size_t count = min({ size, blockSize_ - inBlock, GetFilledEnd() - offset });
+    uint32_t index = static_cast<uint32_t>((headIndex_ + inRing / blockSize_) % blockCount_);
+    const uint8_t *block = ring_.data() + static_cast<size_t>(index) * blockSize_;
+    if (memcpy_s(buffer, size, block + inBlock, count) != EOK) {
+        IMAGE_LOGE("[FilePrefetcher]copy the prefetched data fail.");
+        return 0;
+    }
+    return count;
+}
+
+void FilePrefetcher::DropHeadBlock()
+{
+    headIndex_ = (headIndex_ + 1) % blockCount_;
+    filledCount_--;
+    ringOffset_ += blockSize_;
+    cond_.notify_all();
+}
+
+void FilePrefetcher::DropBlocksBefore(size_t offset)
+{
+    while (filledCount_ > 0 && offset >= ringOffset_ && offset - ringOffset_ >= blockSize_) {
+        DropHeadBlock();
+    }
+}
+
+void FilePrefetcher::ResetRing(size_t offset)
+{
+    generation_++;
+    ringOffset_ = offset;
+    headIndex_ = 0;
+    filledCount_ = 0;
+    cond_.notify_all();
+}
+} // namespace Media
+} // namespace OHOS
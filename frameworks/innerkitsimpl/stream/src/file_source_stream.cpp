@@ -18,6 +18,9 @@
 #include "image_log.h"
 #include "image_utils.h"
 #include "media_errors.h"
+#if !defined(_WIN32) && !defined(_APPLE)
+#include <fcntl.h>
+#endif
 
 namespace OHOS {
 namespace Media {
@@ -31,6 +34,8 @@ FileSourceStream::FileSourceStream(std::FILE *file, size_t size, size_t offset,
 
 FileSourceStream::~FileSourceStream()
 {
+    // stop prefetching before the file is closed.
+    prefetcher_ = nullptr;
     fclose(filePtr_);
     ResetReadBuffer();
 }
@@ -58,7 +63,9 @@ unique_ptr<FileSourceStream> FileSourceStream::CreateSourceStream(const string &
         fclose(filePtr);
         return nullptr;
     }
-    return (unique_ptr<FileSourceStream>(new FileSourceStream(filePtr, size, offset, offset)));
+    unique_ptr<FileSourceStream> stream(new FileSourceStream(filePtr, size, offset, offset));
+    stream->filePath_ = realPath;
+    return stream;
 }
 
 unique_ptr<FileSourceStream> FileSourceStream::CreateSourceStream(const int fd)
@@ -150,6 +157,25 @@ bool FileSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t b
     return true;
 }
 
+bool FileSourceStream::ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize)
+{
+    if (outBuffer == nullptr || bufferSize == 0 || filePtr_ == nullptr) {
+        IMAGE_LOGE("[FileSourceStream]read into input parameter exception, bufferSize:%{public}u.", bufferSize);
+        return false;
+    }
+    if (fileOffset_ >= fileSize_) {
+        readSize = 0;
+        return true;
+    }
+    // reads at most the data left, straight into the buffer of the caller.
+    if (!GetData(bufferSize, outBuffer, bufferSize, readSize)) {
+        IMAGE_LOGE("[FileSourceStream]read into fail.");
+        return false;
+    }
+    fileOffset_ += readSize;
+    return true;
+}
+
 bool FileSourceStream::Seek(uint32_t position)
 {
     if (position > fileSize_) {
@@ -180,7 +206,7 @@ bool FileSourceStream::GetData(uint32_t desiredSize, uint8_t *outBuffer, uint32_
     if (desiredSize > (fileSize_ - fileOffset_)) {
         desiredSize = fileSize_ - fileOffset_;
     }
-    size_t bytesRead = fread(outBuffer, sizeof(outBuffer[0]), desiredSize, filePtr_);
+    size_t bytesRead = ReadFile(outBuffer, desiredSize);
     if (bytesRead < desiredSize) {
         IMAGE_LOGE("[FileSourceStream]read fail, bytesRead:%{public}zu", bytesRead);
         return false;
@@ -201,17 +227,20 @@ bool FileSourceStream::GetData(uint32_t desiredSize, DataStreamBuffer &outData)
         return false;
     }
 
-    ResetReadBuffer();
-    readBuffer_ = static_cast<uint8_t *>(malloc(desiredSize));
-    if (readBuffer_ == nullptr) {
-        IMAGE_LOGE("[FileSourceStream]malloc the desiredSize fail.");
-        return false;
+    if (readBuffer_ == nullptr || readBufferSize_ < desiredSize) {
+        ResetReadBuffer();
+        readBuffer_ = static_cast<uint8_t *>(malloc(desiredSize));
+        if (readBuffer_ == nullptr) {
+            IMAGE_LOGE("[FileSourceStream]malloc the desiredSize fail.");
+            return false;
+        }
+        readBufferSize_ = desiredSize;
     }
     outData.bufferSize = desiredSize;
     if (desiredSize > (fileSize_ - fileOffset_)) {
         desiredSize = fileSize_ - fileOffset_;
     }
-    size_t bytesRead = fread(readBuffer_, sizeof(uint8_t), desiredSize, filePtr_);
+    size_t bytesRead = ReadFile(readBuffer_, desiredSize);
     if (bytesRead < desiredSize) {
         IMAGE_LOGE("[FileSourceStream]read fail, bytesRead:%{public}zu", bytesRead);
         return false;
@@ -236,11 +265,68 @@ uint32_t FileSourceStream::GetStreamType()
     return ImagePlugin::FILE_STREAM_TYPE;
 }
 
+unique_ptr<SourceStream> FileSourceStream::CreateView()
+{
+    // the file opened by fd shares its position with the caller, it can't be reopened independently.
+    if (filePath_.empty()) {
+        return nullptr;
+    }
+    unique_ptr<FileSourceStream> view = CreateSourceStream(filePath_);
+    if (view != nullptr) {
+        view->SetPrefetchSize(prefetchSize_);
+    }
+    return view;
+}
+
+void FileSourceStream::PrepareSequentialRead()
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    if (filePtr_ == nullptr || fileOffset_ >= fileSize_) {
+        return;
+    }
+    int fd = fileno(filePtr_);
+    // the decoder may go back to the start of the image, so the whole image is advised.
+    int ret = posix_fadvise(fd, fileOriginalOffset_, fileSize_ - fileOriginalOffset_, POSIX_FADV_SEQUENTIAL);
+    if (ret == 0) {
+        ret = posix_fadvise(fd, fileOriginalOffset_, fileSize_ - fileOriginalOffset_, POSIX_FADV_WILLNEED);
+    }
+    if (ret != 0) {
+        IMAGE_LOGD("[FileSourceStream]advise the file fail, ret:%{public}d.", ret);
+    }
+    if (prefetchSize_ == 0 || prefetcher_ != nullptr) {
+        return;
+    }
+    unique_ptr<FilePrefetcher> prefetcher = make_unique<FilePrefetcher>(fd, fileOffset_, fileSize_, prefetchSize_);
+    if (prefetcher->Start()) {
+        prefetcher_ = move(prefetcher);
+    }
+#endif
+}
+
+void FileSourceStream::SetPrefetchSize(uint32_t size)
+{
+    prefetchSize_ = size;
+}
+
+uint64_t FileSourceStream::GetPrefetchMissCount()
+{
+    return (prefetcher_ != nullptr) ? prefetcher_->GetDirectReadCount() : 0;
+}
+
+size_t FileSourceStream::ReadFile(uint8_t *buffer, size_t size)
+{
+    if (prefetcher_ != nullptr) {
+        return prefetcher_->Read(fileOffset_, buffer, size) ? size : 0;
+    }
+    return fread(buffer, sizeof(uint8_t), size, filePtr_);
+}
+
 void FileSourceStream::ResetReadBuffer()
 {
     if (readBuffer_ != nullptr) {
         free(readBuffer_);
         readBuffer_ = nullptr;
+        readBufferSize_ = 0;
     }
 }
 } // namespace Media
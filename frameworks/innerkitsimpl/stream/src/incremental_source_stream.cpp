@@ -30,14 +30,20 @@ using namespace OHOS::HiviewDFX;
 using namespace std;
 using namespace ImagePlugin;
 
-IncrementalSourceStream::IncrementalSourceStream(IncrementalMode mode)
-    : incrementalMode_(mode), isFinalize_(false), dataSize_(0), dataOffset_(0)
+namespace {
+// a new chunk reserves at least this size, so the small updates share a chunk.
+constexpr size_t MIN_CHUNK_SIZE = 16 * 1024;
+}
+
+IncrementalSourceStream::IncrementalSourceStream(IncrementalMode mode, uint32_t expectedSize)
+    : incrementalMode_(mode), isFinalize_(false), expectedSize_(expectedSize), dataSize_(0), dataOffset_(0)
 {}
 
-unique_ptr<IncrementalSourceStream> IncrementalSourceStream::CreateSourceStream(IncrementalMode mode)
+unique_ptr<IncrementalSourceStream> IncrementalSourceStream::CreateSourceStream(IncrementalMode mode,
+                                                                                uint32_t expectedSize)
 {
-    IMAGE_LOGD("[IncrementalSourceStream]mode:%{public}d.", mode);
-    return (unique_ptr<IncrementalSourceStream>(new IncrementalSourceStream(mode)));
+    IMAGE_LOGD("[IncrementalSourceStream]mode:%{public}d, expectedSize:%{public}u.", mode, expectedSize);
+    return (unique_ptr<IncrementalSourceStream>(new IncrementalSourceStream(mode, expectedSize)));
 }
 
 bool IncrementalSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
@@ -56,20 +62,28 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, DataStreamBuffer &outDa
         IMAGE_LOGE("[IncrementalSourceStream]input the parameter exception.");
         return false;
     }
-    if (sourceData_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
+    if (chunks_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
         IMAGE_LOGE("[IncrementalSourceStream]source data exception. dataSize_:%{public}zu, dataOffset_:%{public}zu.",
                    dataSize_, dataOffset_);
         return false;
     }
-    outData.bufferSize = dataSize_ - dataOffset_;
     if (desiredSize > dataSize_ - dataOffset_) {
         desiredSize = dataSize_ - dataOffset_;
     }
+    size_t first = FindChunk(dataOffset_);
+    size_t last = FindChunk(dataOffset_ + desiredSize - 1);
+    if (first != last) {
+        // the decoders need a continuous buffer, merge the chunks so the next reads of the span don't copy.
+        MergeChunks(first, last);
+    }
+    const vector<uint8_t> &chunk = chunks_[first];
+    size_t chunkOffset = dataOffset_ - chunkOffsets_[first];
+    outData.bufferSize = chunk.size() - chunkOffset;
     outData.dataSize = desiredSize;
-    outData.inputStreamBuffer = sourceData_.data() + dataOffset_;
-    IMAGE_LOGD("[IncrementalSourceStream]Peek end. desiredSize:%{public}u, offset:%{public}zu, dataSize_:%{public}zu, \
+    outData.inputStreamBuffer = chunk.data() + chunkOffset;
+    IMAGE_LOGD("[IncrementalSourceStream]Peek end. desiredSize:%{public}u, dataSize_:%{public}zu, \
                dataOffset_:%{public}zu.",
-               desiredSize, dataOffset_, dataSize_, dataOffset_);
+               desiredSize, dataSize_, dataOffset_);
     return true;
 }
 
@@ -90,7 +104,7 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uin
                    desiredSize, bufferSize);
         return false;
     }
-    if (sourceData_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
+    if (chunks_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
         IMAGE_LOGE("[IncrementalSourceStream]source data exception. dataSize_:%{public}zu, dataOffset_:%{public}zu.",
                    dataSize_, dataOffset_);
         return false;
@@ -98,17 +112,51 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uin
     if (desiredSize > (dataSize_ - dataOffset_)) {
         desiredSize = dataSize_ - dataOffset_;
     }
-    errno_t ret = memcpy_s(outBuffer, bufferSize, sourceData_.data() + dataOffset_, desiredSize);
-    if (ret != 0) {
-        IMAGE_LOGE("[IncrementalSourceStream]copy data fail, ret:%{public}d, bufferSize:%{public}u, \
-                    offset:%{public}zu, desiredSize:%{public}u, dataSize:%{public}zu.",
-                   ret, bufferSize, dataOffset_, desiredSize, dataSize_);
-        return false;
+    size_t copied = 0;
+    for (size_t index = FindChunk(dataOffset_); copied < desiredSize; index++) {
+        const vector<uint8_t> &chunk = chunks_[index];
+        size_t chunkOffset = dataOffset_ + copied - chunkOffsets_[index];
+        size_t copySize = min(chunk.size() - chunkOffset, desiredSize - copied);
+        errno_t ret = memcpy_s(outBuffer + copied, bufferSize - copied, chunk.data() + chunkOffset, copySize);
+        if (ret != 0) {
+            IMAGE_LOGE("[IncrementalSourceStream]copy data fail, ret:%{public}d, bufferSize:%{public}u, \
+                        offset:%{public}zu, desiredSize:%{public}u, dataSize:%{public}zu.",
+                       ret, bufferSize, dataOffset_, desiredSize, dataSize_);
+            return false;
+        }
+        copied += copySize;
     }
     readSize = desiredSize;
     return true;
 }
 
+bool IncrementalSourceStream::ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize)
+{
+    if (outBuffer == nullptr || bufferSize == 0) {
+        IMAGE_LOGE("[IncrementalSourceStream]read into input parameter exception, bufferSize:%{public}u.",
+                   bufferSize);
+        return false;
+    }
+    readSize = 0;
+    if (dataOffset_ >= dataSize_) {
+        return true;
+    }
+    if (!Read(min(bufferSize, static_cast<uint32_t>(dataSize_ - dataOffset_)), outBuffer, bufferSize, readSize)) {
+        IMAGE_LOGE("[IncrementalSourceStream]read into fail.");
+        return false;
+    }
+    return true;
+}
+
+uint32_t IncrementalSourceStream::GetContiguousSize()
+{
+    if (chunks_.empty() || dataOffset_ >= dataSize_) {
+        return 0;
+    }
+    size_t index = FindChunk(dataOffset_);
+    return static_cast<uint32_t>(chunkOffsets_[index] + chunks_[index].size() - dataOffset_);
+}
+
 uint32_t IncrementalSourceStream::Tell()
 {
     return dataOffset_;
@@ -135,23 +183,66 @@ uint32_t IncrementalSourceStream::UpdateData(const uint8_t *data, uint32_t size,
         return SUCCESS;
     }
     if (incrementalMode_ == IncrementalMode::INCREMENTAL_DATA) {
-        vector<uint8_t> newData;
-        newData.resize(size);
-        copy(data, data + size, newData.begin());
-        sourceData_.resize(dataSize_ + size);
-        sourceData_.insert(sourceData_.begin() + dataSize_, newData.begin(), newData.end());
-        dataSize_ += size;
+        AppendData(data, size);
         isFinalize_ = isCompleted;
     } else {
-        sourceData_.clear();
-        sourceData_.resize(size);
-        dataSize_ = size;
-        copy(data, data + size, sourceData_.begin());
+        chunks_.clear();
+        chunkOffsets_.clear();
+        dataSize_ = 0;
+        AppendData(data, size);
         isFinalize_ = true;
     }
     return SUCCESS;
 }
 
+void IncrementalSourceStream::AppendData(const uint8_t *data, uint32_t size)
+{
+    // fill the spare capacity of the last chunk first, it never reallocates, so the peeked buffers keep valid.
+    if (!chunks_.empty()) {
+        vector<uint8_t> &lastChunk = chunks_.back();
+        if (lastChunk.capacity() - lastChunk.size() >= size) {
+            lastChunk.insert(lastChunk.end(), data, data + size);
+            dataSize_ += size;
+            return;
+        }
+    }
+    size_t reserveSize = max(static_cast<size_t>(size), MIN_CHUNK_SIZE);
+    if (expectedSize_ > dataSize_) {
+        reserveSize = max(reserveSize, expectedSize_ - dataSize_);
+    }
+    chunks_.emplace_back();
+    chunks_.back().reserve(reserveSize);
+    chunks_.back().assign(data, data + size);
+    chunkOffsets_.push_back(dataSize_);
+    dataSize_ += size;
+}
+
+size_t IncrementalSourceStream::FindChunk(size_t offset) const
+{
+    auto iter = upper_bound(chunkOffsets_.begin(), chunkOffsets_.end(), offset);
+    return static_cast<size_t>(iter - chunkOffsets_.begin()) - 1;
+}
+
+void IncrementalSourceStream::MergeChunks(size_t first, size_t last)
+{
+    size_t mergedSize = 0;
+    for (size_t index = first; index <= last; index++) {
+        mergedSize += chunks_[index].size();
+    }
+    vector<uint8_t> merged;
+    // the last chunk keeps growing, double it so the whole data reads are merged only a few times.
+    bool isLastChunk = (last + 1 == chunks_.size());
+    merged.reserve((isLastChunk && !isFinalize_) ? mergedSize * 2 : mergedSize);
+    for (size_t index = first; index <= last; index++) {
+        merged.insert(merged.end(), chunks_[index].begin(), chunks_[index].end());
+    }
+    IMAGE_LOGD("[IncrementalSourceStream]merge chunks [%{public}zu, %{public}zu], size:%{public}zu.", first, last,
+               mergedSize);
+    chunks_[first].swap(merged);
+    chunks_.erase(chunks_.begin() + first + 1, chunks_.begin() + last + 1);
+    chunkOffsets_.erase(chunkOffsets_.begin() + first + 1, chunkOffsets_.begin() + last + 1);
+}
+
 bool IncrementalSourceStream::IsStreamCompleted()
 {
     return isFinalize_;
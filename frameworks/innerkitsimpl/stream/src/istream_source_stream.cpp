@@ -14,8 +14,14 @@
  */
 
 #include "istream_source_stream.h"
+#include <algorithm>
 #include "image_log.h"
 #include "image_utils.h"
+#ifndef _WIN32
+#include "securec.h"
+#else
+#include "memory.h"
+#endif
 
 namespace OHOS {
 namespace Media {
@@ -24,14 +30,10 @@ using namespace std;
 using namespace ImagePlugin;
 
 IstreamSourceStream::IstreamSourceStream(unique_ptr<istream> inputStream, size_t size, size_t original, size_t offset)
-    : inputStream_(move(inputStream)), streamSize_(size), streamOriginalOffset_(original), streamOffset_(offset)
+    : inputStream_(move(inputStream)), streamSize_(size), streamOriginalOffset_(original), streamOffset_(offset),
+      inputPosition_(offset)
 {}
 
-IstreamSourceStream::~IstreamSourceStream()
-{
-    ResetReadBuffer();
-}
-
 std::unique_ptr<IstreamSourceStream> IstreamSourceStream::CreateSourceStream(unique_ptr<istream> inputStream)
 {
     if ((inputStream == nullptr) || (inputStream->rdbuf() == nullptr)) {
@@ -52,6 +54,11 @@ std::unique_ptr<IstreamSourceStream> IstreamSourceStream::CreateSourceStream(uni
     return (unique_ptr<IstreamSourceStream>(new IstreamSourceStream(move(inputStream), streamSize, original, offset)));
 }
 
+void IstreamSourceStream::SetReadAheadSize(uint32_t size)
+{
+    readAheadSize_ = size;
+}
+
 bool IstreamSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
 {
     if (desiredSize == 0) {
@@ -76,7 +83,6 @@ bool IstreamSourceStream::Peek(uint32_t desiredSize, DataStreamBuffer &outData)
         IMAGE_LOGE("[IstreamSourceStream]peek fail.");
         return false;
     }
-    inputStream_->seekg(streamOffset_);
     return true;
 }
 
@@ -106,7 +112,25 @@ bool IstreamSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_
         IMAGE_LOGE("[IstreamSourceStream]peek fail.");
         return false;
     }
-    inputStream_->seekg(streamOffset_);
+    return true;
+}
+
+bool IstreamSourceStream::ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize)
+{
+    if (outBuffer == nullptr || bufferSize == 0) {
+        IMAGE_LOGE("[IstreamSourceStream]read into input parameter exception, bufferSize:%{public}u.", bufferSize);
+        return false;
+    }
+    readSize = 0;
+    if (streamOffset_ >= streamSize_) {
+        return true;
+    }
+    // a large buffer is read straight from the input stream, a small one from the read ahead window.
+    if (!GetData(bufferSize, outBuffer, bufferSize, readSize)) {
+        IMAGE_LOGE("[IstreamSourceStream]read into fail.");
+        return false;
+    }
+    streamOffset_ += readSize;
     return true;
 }
 
@@ -118,8 +142,8 @@ bool IstreamSourceStream::Seek(uint32_t position)
         return false;
     }
     size_t targetPosition = position + streamOriginalOffset_;
+    // the input stream is only moved when the data out of the window is read.
     streamOffset_ = ((targetPosition < streamSize_) ? targetPosition : streamSize_);
-    inputStream_->seekg(streamOffset_);
     return true;
 }
 
@@ -138,8 +162,20 @@ bool IstreamSourceStream::GetData(uint32_t desiredSize, uint8_t *outBuffer, uint
     if (desiredSize > (streamSize_ - streamOffset_)) {
         desiredSize = (streamSize_ - streamOffset_);
     }
-    if (!inputStream_->read(reinterpret_cast<char *>(outBuffer), desiredSize)) {
-        IMAGE_LOGE("[IstreamSourceStream]read the inputstream fail.");
+    if (!IsInWindow(desiredSize) && desiredSize >= readAheadSize_) {
+        // too large to read ahead, read it straight into the buffer of the caller.
+        if (!ReadInput(streamOffset_, outBuffer, desiredSize)) {
+            return false;
+        }
+        readSize = desiredSize;
+        return true;
+    }
+    if (!FillWindow(desiredSize)) {
+        return false;
+    }
+    errno_t ret = memcpy_s(outBuffer, bufferSize, window_.data() + (streamOffset_ - windowOffset_), desiredSize);
+    if (ret != EOK) {
+        IMAGE_LOGE("[IstreamSourceStream]copy data fail, ret:%{public}d, bufferSize:%{public}u.", ret, bufferSize);
         return false;
     }
     readSize = desiredSize;
@@ -158,26 +194,73 @@ bool IstreamSourceStream::GetData(uint32_t desiredSize, DataStreamBuffer &outDat
         IMAGE_LOGE("IstreamSourceStream]Invalid value, desiredSize out of size.");
         return false;
     }
-    ResetReadBuffer();
-    databuffer_ = static_cast<uint8_t *>(malloc(desiredSize));
-    if (databuffer_ == nullptr) {
-        IMAGE_LOGE("[IstreamSourceStream]malloc the output data buffer fail.");
-        return false;
-    }
     outData.bufferSize = desiredSize;
     if (desiredSize > (streamSize_ - streamOffset_)) {
         desiredSize = (streamSize_ - streamOffset_);
     }
-    inputStream_->seekg(streamOffset_);
-    if (!inputStream_->read(reinterpret_cast<char *>(databuffer_), desiredSize)) {
-        IMAGE_LOGE("[IstreamSourceStream]read the inputstream fail.");
+    if (!FillWindow(desiredSize)) {
         return false;
     }
-    outData.inputStreamBuffer = databuffer_;
+    outData.inputStreamBuffer = window_.data() + (streamOffset_ - windowOffset_);
     outData.dataSize = desiredSize;
     return true;
 }
 
+bool IstreamSourceStream::IsInWindow(uint32_t size) const
+{
+    return streamOffset_ >= windowOffset_ && streamOffset_ + size <= windowOffset_ + windowSize_;
+}
+
+bool IstreamSourceStream::FillWindow(uint32_t desiredSize)
+{
+    if (IsInWindow(desiredSize)) {
+        return true;
+    }
+    // keep the data of the window after the current position, only the rest is read from the input stream.
+    size_t keptSize = 0;
+    if (streamOffset_ >= windowOffset_ && streamOffset_ < windowOffset_ + windowSize_) {
+        keptSize = windowOffset_ + windowSize_ - streamOffset_;
+    }
+    size_t fetchSize = max(static_cast<size_t>(desiredSize), static_cast<size_t>(readAheadSize_));
+    fetchSize = min(fetchSize, streamSize_ - streamOffset_);
+    if (window_.size() < fetchSize) {
+        window_.resize(fetchSize);
+    }
+    if (keptSize > 0 && streamOffset_ != windowOffset_) {
+        errno_t ret = memmove_s(window_.data(), window_.size(), window_.data() + (streamOffset_ - windowOffset_),
+                                keptSize);
+        if (ret != EOK) {
+            IMAGE_LOGE("[IstreamSourceStream]move the window data fail, ret:%{public}d.", ret);
+            windowSize_ = 0;
+            return false;
+        }
+    }
+    windowOffset_ = streamOffset_;
+    windowSize_ = keptSize;
+    if (!ReadInput(windowOffset_ + keptSize, window_.data() + keptSize, fetchSize - keptSize)) {
+        return false;
+    }
+    windowSize_ = fetchSize;
+    return true;
+}
+
+bool IstreamSourceStream::ReadInput(size_t position, uint8_t *buffer, size_t size)
+{
+    // each seek of the input stream may be expensive, seek only when the position is not the next to read.
+    if (position != inputPosition_) {
+        inputStream_->clear();
+        inputStream_->seekg(position);
+    }
+    if (!inputStream_->read(reinterpret_cast<char *>(buffer), size)) {
+        IMAGE_LOGE("[IstreamSourceStream]read the inputstream fail.");
+        inputStream_->clear();
+        inputPosition_ = SIZE_MAX;  // unknown, seek before the next read.
+        return false;
+    }
+    inputPosition_ = position + size;
+    return true;
+}
+
 size_t IstreamSourceStream::GetStreamSize()
 {
     return streamSize_;
@@ -192,13 +275,5 @@ uint32_t IstreamSourceStream::GetStreamType()
 {
     return ImagePlugin::INPUT_STREAM_TYPE;
 }
-
-void IstreamSourceStream::ResetReadBuffer()
-{
-    if (databuffer_ != nullptr) {
-        free(databuffer_);
-        databuffer_ = nullptr;
-    }
-}
 } // namespace Media
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "decode_task_pool.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+static constexpr uint32_t WAIT_INTERVAL_MS = 10;
+
+class DecodeTaskPoolTest : public testing::Test {
+public:
+    DecodeTaskPoolTest() {};
+    ~DecodeTaskPoolTest() {};
+    void SetUp() override
+    {
+        maxWorkers_ = DecodeTaskPool::GetInstance().GetMaxWorkers();
+    }
+    void TearDown() override
+    {
+        DecodeTaskPool::GetInstance().SetMaxWorkers(maxWorkers_);
+    }
+
+private:
+    uint32_t maxWorkers_ = 1;
+};
+
+static void WaitDone(const std::atomic<uint32_t> &done, uint32_t count)
+{
+    while (done < count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_INTERVAL_MS));
+    }
+}
+
+// submit a task which keeps the only worker busy until the gate is opened.
+static void SubmitGateTask(std::shared_future<void> gate, std::atomic<uint32_t> &done)
+{
+    DecodeTask task;
+    task.priority = DecodePriority::HIGH;
+    task.run = [gate, &done]() {
+        gate.wait();
+        done++;
+    };
+    DecodeTaskPool::GetInstance().Submit(std::move(task));
+}
+
+/**
+ * @tc.name: DecodeTaskPool001
+ * @tc.desc: Pending tasks run by priority, tasks of the same priority run in submitting order.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DecodeTaskPoolTest, DecodeTaskPool001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. run one task at a time and keep it busy.
+     * @tc.expected: step1. the max workers is set.
+     */
+    DecodeTaskPool &pool = DecodeTaskPool::GetInstance();
+    pool.SetMaxWorkers(1);
+    ASSERT_EQ(pool.GetMaxWorkers(), 1u);
+    std::promise<void> gate;
+    std::atomic<uint32_t> done(0);
+    SubmitGateTask(gate.get_future().share(), done);
+    /**
+     * @tc.steps: step2. submit tasks of mixed priorities and open the gate.
+     * @tc.expected: step2. high priority tasks run first.
+     */
+    const std::vector<DecodePriority> priorities = { DecodePriority::LOW, DecodePriority::NORMAL,
+        DecodePriority::HIGH, DecodePriority::LOW, DecodePriority::HIGH };
+    std::mutex orderMutex;
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < priorities.size(); i++) {
+        DecodeTask task;
+        task.priority = priorities[i];
+        task.run = [i, &orderMutex, &order, &done]() {
+            std::lock_guard<std::mutex> guard(orderMutex);
+            order.push_back(i);
+            done++;
+        };
+        ASSERT_NE(pool.Submit(std::move(task)), 0u);
+    }
+    gate.set_value();
+    WaitDone(done, priorities.size() + 1);
+    const std::vector<uint32_t> expectedOrder = { 2, 4, 1, 0, 3 };
+    ASSERT_EQ(order, expectedOrder);
+}
+
+/**
+ * @tc.name: DecodeTaskPool002
+ * @tc.desc: Cancel pending tasks by id and by owner.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DecodeTaskPoolTest, DecodeTaskPool002, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. keep the only worker busy and submit tasks of two owners.
+     * @tc.expected: step1. submit success.
+     */
+    DecodeTaskPool &pool = DecodeTaskPool::GetInstance();
+    pool.SetMaxWorkers(1);
+    std::promise<void> gate;
+    std::atomic<uint32_t> done(0);
+    SubmitGateTask(gate.get_future().share(), done);
+    int ownerA = 0;
+    int ownerB = 0;
+    std::atomic<uint32_t> runCount(0);
+    std::atomic<uint32_t> cancelCount(0);
+    std::vector<uint64_t> taskIds;
+    for (uint32_t i = 0; i < 4; i++) {
+        DecodeTask task;
+        task.owner = (i % 2 == 0) ? &ownerA : &ownerB;
+        task.run = [&runCount, &done]() {
+            runCount++;
+            done++;
+        };
+        task.cancel = [&cancelCount, &done]() {
+            cancelCount++;
+            done++;
+        };
+        taskIds.push_back(pool.Submit(std::move(task)));
+    }
+    /**
+     * @tc.steps: step2. cancel a task of owner A by id and all tasks of owner B.
+     * @tc.expected: step2. the cancel callbacks are called at once, a canceled task can't be canceled again.
+     */
+    ASSERT_EQ(pool.CancelTask(taskIds[0]), true);
+    ASSERT_EQ(pool.CancelTask(taskIds[0]), false);
+    pool.CancelTasks(&ownerB);
+    ASSERT_EQ(cancelCount, 3u);
+    /**
+     * @tc.steps: step3. open the gate.
+     * @tc.expected: step3. only the task left runs, and it can't be canceled after done.
+     */
+    gate.set_value();
+    WaitDone(done, taskIds.size() + 1);
+    ASSERT_EQ(runCount, 1u);
+    ASSERT_EQ(pool.CancelTask(taskIds[2]), false);
+}
+
+/**
+ * @tc.name: DecodeTaskPool003
+ * @tc.desc: The number of running tasks is bounded by the max workers.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DecodeTaskPoolTest, DecodeTaskPool003, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. set two workers and submit tasks which record the running count.
+     * @tc.expected: step1. all tasks run, no more than two at a time.
+     */
+    DecodeTaskPool &pool = DecodeTaskPool::GetInstance();
+    const uint32_t workerCount = 2;
+    const uint32_t taskCount = 8;
+    pool.SetMaxWorkers(workerCount);
+    std::atomic<uint32_t> running(0);
+    std::atomic<uint32_t> maxRunning(0);
+    std::atomic<uint32_t> done(0);
+    for (uint32_t i = 0; i < taskCount; i++) {
+        DecodeTask task;
+        task.run = [&running, &maxRunning, &done]() {
+            uint32_t current = ++running;
+            uint32_t observed = maxRunning;
+            while (current > observed && !maxRunning.compare_exchange_weak(observed, current)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_INTERVAL_MS));
+            running--;
+            done++;
+        };
+        pool.Submit(std::move(task));
+    }
+    WaitDone(done, taskCount);
+    ASSERT_LE(maxRunning, workerCount);
+}
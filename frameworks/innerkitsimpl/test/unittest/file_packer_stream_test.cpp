@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include "directory_ex.h"
+#include "file_packer_stream.h"
+#include "image_packer.h"
+#include "image_source.h"
+#include "media_errors.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+static const std::string TEST_DIR = "/data/test/file_packer_stream";
+static const std::string TEST_FILE_PATH = TEST_DIR + "/test_packer_stream.dat";
+static const std::string TEST_FILE_NAME = "test_packer_stream.dat";
+static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test.jpg";
+static const std::string IMAGE_OUTPUT_JPEG_PATH = TEST_DIR + "/test_packer_stream.jpg";
+static constexpr uint32_t TEST_BUFFER_SIZE = 16;
+static constexpr uint32_t TEST_EXPECTED_SIZE = 1024 * 1024;
+static constexpr int64_t STAT_BLOCK_SIZE = 512;
+
+class FilePackerStreamTest : public testing::Test {
+public:
+    FilePackerStreamTest() {}
+    ~FilePackerStreamTest() {}
+    void SetUp();
+    void TearDown();
+
+    static std::string ReadFile(const std::string &path);
+    static int64_t GetFileSize(const std::string &path);
+    // the files in the test dir whose names start with the prefix.
+    static uint32_t CountFiles(const std::string &prefix);
+};
+
+void FilePackerStreamTest::SetUp(void)
+{
+    OHOS::ForceRemoveDirectory(TEST_DIR);
+    OHOS::ForceCreateDirectory(TEST_DIR);
+}
+
+void FilePackerStreamTest::TearDown(void)
+{
+    OHOS::ForceRemoveDirectory(TEST_DIR);
+}
+
+std::string FilePackerStreamTest::ReadFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+int64_t FilePackerStreamTest::GetFileSize(const std::string &path)
+{
+    struct stat fileStat;
+    return (stat(path.c_str(), &fileStat) == 0) ? static_cast<int64_t>(fileStat.st_size) : -1;
+}
+
+uint32_t FilePackerStreamTest::CountFiles(const std::string &prefix)
+{
+    DIR *dir = opendir(TEST_DIR.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    uint32_t count = 0;
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (std::string(entry->d_name).compare(0, prefix.size(), prefix) == 0) {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+/**
+ * @tc.name: FilePackerStream001
+ * @tc.desc: The small writes are combined into the buffer, and the large writes go to the file directly.
+ * @tc.type: FUNC
+ */
+HWTEST_F(FilePackerStreamTest, FilePackerStream001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. write data smaller than the buffer several times.
+     * @tc.expected: step1. the data is counted by BytesWritten, but not written to the file until the buffer is full.
+     */
+    FilePackerStream stream(TEST_FILE_PATH);
+    stream.SetBufferSize(TEST_BUFFER_SIZE);
+    std::string expected;
+    const std::string smallData = "abcde";
+    ASSERT_EQ(stream.Write(reinterpret_cast<const uint8_t *>(smallData.data()), smallData.size()), true);
+    expected += smallData;
+    ASSERT_EQ(stream.BytesWritten(), static_cast<int64_t>(expected.size()));
+    ASSERT_EQ(GetFileSize(TEST_FILE_PATH), 0);
+    for (uint32_t i = 0; i < 3; i++) {
+        ASSERT_EQ(stream.Write(reinterpret_cast<const uint8_t *>(smallData.data()), smallData.size()), true);
+        expected += smallData;
+        ASSERT_EQ(stream.BytesWritten(), static_cast<int64_t>(expected.size()));
+    }
+    // the fourth write doesn't fit into the buffer, the three before are written together.
+    ASSERT_EQ(GetFileSize(TEST_FILE_PATH), static_cast<int64_t>(smallData.size() * 3));
+    /**
+     * @tc.steps: step2. write data larger than the buffer.
+     * @tc.expected: step2. the buffered data and the large data are written to the file in order.
+     */
+    const std::string largeData(TEST_BUFFER_SIZE * 2, 'x');
+    ASSERT_EQ(stream.Write(reinterpret_cast<const uint8_t *>(largeData.data()), largeData.size()), true);
+    expected += largeData;
+    ASSERT_EQ(stream.BytesWritten(), static_cast<int64_t>(expected.size()));
+    ASSERT_EQ(GetFileSize(TEST_FILE_PATH), static_cast<int64_t>(expected.size()));
+    /**
+     * @tc.steps: step3. write small data again and flush the stream.
+     * @tc.expected: step3. the file has all the data in order.
+     */
+    ASSERT_EQ(stream.Write(reinterpret_cast<const uint8_t *>(smallData.data()), smallData.size()), true);
+    expected += smallData;
+    stream.Flush();
+    ASSERT_EQ(stream.BytesWritten(), static_cast<int64_t>(expected.size()));
+    ASSERT_EQ(ReadFile(TEST_FILE_PATH), expected);
+}
+
+/**
+ * @tc.name: FilePackerStream002
+ * @tc.desc: The space preallocated for the expected size is released by flushing, the file keeps the written size.
+ * @tc.type: FUNC
+ */
+HWTEST_F(FilePackerStreamTest, FilePackerStream002, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. preallocate the expected size, then write much less data.
+     * @tc.expected: step1. the file size is not changed by the preallocation.
+     */
+    FilePackerStream stream(TEST_FILE_PATH);
+    stream.SetBufferSize(0);
+    stream.SetExpectedSize(TEST_EXPECTED_SIZE);
+    const std::string data(TEST_BUFFER_SIZE, 'x');
+    ASSERT_EQ(stream.Write(reinterpret_cast<const uint8_t *>(data.data()), data.size()), true);
+    ASSERT_EQ(GetFileSize(TEST_FILE_PATH), static_cast<int64_t>(data.size()));
+    struct stat fileStat;
+    ASSERT_EQ(stat(TEST_FILE_PATH.c_str(), &fileStat), 0);
+    // the file system may not support preallocation.
+    bool isPreallocated = static_cast<int64_t>(fileStat.st_blocks) * STAT_BLOCK_SIZE >= TEST_EXPECTED_SIZE;
+    /**
+     * @tc.steps: step2. flush the stream.
+     * @tc.expected: step2. the preallocated blocks are released, the file has the written data.
+     */
+    stream.Flush();
+    ASSERT_EQ(stat(TEST_FILE_PATH.c_str(), &fileStat), 0);
+    ASSERT_EQ(static_cast<int64_t>(fileStat.st_size), static_cast<int64_t>(data.size()));
+    if (isPreallocated) {
+        ASSERT_LT(static_cast<int64_t>(fileStat.st_blocks) * STAT_BLOCK_SIZE, TEST_EXPECTED_SIZE);
+    }
+    ASSERT_EQ(ReadFile(TEST_FILE_PATH), data);
+}
+
+/**
+ * @tc.name: FilePackerStream003
+ * @tc.desc: The atomic stream replaces the file in Flush, and removes its temporary file if it is not flushed.
+ * @tc.type: FUNC
+ */
+HWTEST_F(FilePackerStreamTest, FilePackerStream003, TestSize.Level3)
+{
+    const std::string oldData = "old data";
+    const std::string newData = "new data of the atomic stream";
+    {
+        std::ofstream file(TEST_FILE_PATH, std::ios::binary);
+        file << oldData;
+    }
+    /**
+     * @tc.steps: step1. write to an atomic stream, and destroy it without flushing.
+     * @tc.expected: step1. the file keeps the old data, and the temporary file is removed.
+     */
+    {
+        FilePackerStream stream(TEST_FILE_PATH, true);
+        ASSERT_EQ(stream.Write(reinterpret_cast<const uint8_t *>(newData.data()), newData.size()), true);
+        ASSERT_EQ(CountFiles(TEST_FILE_NAME), 2u);
+    }
+    ASSERT_EQ(ReadFile(TEST_FILE_PATH), oldData);
+    ASSERT_EQ(CountFiles(TEST_FILE_NAME), 1u);
+    /**
+     * @tc.steps: step2. write to an atomic stream, and flush it.
+     * @tc.expected: step2. the file keeps the old data until the flushing, then it has the new data.
+     */
+    {
+        FilePackerStream stream(TEST_FILE_PATH, true);
+        stream.SetExpectedSize(TEST_EXPECTED_SIZE);
+        ASSERT_EQ(stream.Write(reinterpret_cast<const uint8_t *>(newData.data()), newData.size()), true);
+        ASSERT_EQ(ReadFile(TEST_FILE_PATH), oldData);
+        stream.Flush();
+        ASSERT_EQ(ReadFile(TEST_FILE_PATH), newData);
+        ASSERT_EQ(stream.BytesWritten(), static_cast<int64_t>(newData.size()));
+    }
+    ASSERT_EQ(ReadFile(TEST_FILE_PATH), newData);
+    ASSERT_EQ(CountFiles(TEST_FILE_NAME), 1u);
+}
+
+/**
+ * @tc.name: FilePackerStream004
+ * @tc.desc: Pack jpeg image to a file atomically with a small buffer by the image packer.
+ * @tc.type: FUNC
+ */
+HWTEST_F(FilePackerStreamTest, FilePackerStream004, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. decode the jpeg image.
+     * @tc.expected: step1. decode success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    /**
+     * @tc.steps: step2. pack the image to a file atomically.
+     * @tc.expected: step2. the file doesn't exist until the packing is finalized, then it has all the packed data,
+     *                      and no temporary file is left.
+     */
+    ImagePacker imagePacker;
+    PackOption option;
+    option.format = "image/jpeg";
+    option.isAtomic = true;
+    option.bufferSize = TEST_BUFFER_SIZE;
+    ASSERT_EQ(imagePacker.StartPacking(IMAGE_OUTPUT_JPEG_PATH, option), SUCCESS);
+    ASSERT_EQ(imagePacker.AddImage(*pixelMap), SUCCESS);
+    ASSERT_EQ(GetFileSize(IMAGE_OUTPUT_JPEG_PATH), -1);
+    int64_t packedSize = 0;
+    ASSERT_EQ(imagePacker.FinalizePacking(packedSize), SUCCESS);
+    ASSERT_GT(packedSize, 0);
+    ASSERT_EQ(GetFileSize(IMAGE_OUTPUT_JPEG_PATH), packedSize);
+    ASSERT_EQ(CountFiles("test_packer_stream.jpg"), 1u);
+    /**
+     * @tc.steps: step3. decode the packed file.
+     * @tc.expected: step3. decode success.
+     */
+    imageSource = ImageSource::CreateImageSource(IMAGE_OUTPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    std::unique_ptr<PixelMap> packedPixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(packedPixelMap.get(), nullptr);
+    ASSERT_EQ(packedPixelMap->GetWidth(), pixelMap->GetWidth());
+    ASSERT_EQ(packedPixelMap->GetHeight(), pixelMap->GetHeight());
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "buffer_source_stream.h"
+#include "heif_decoder.h"
+#include "media_errors.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+using namespace OHOS::ImagePlugin;
+
+namespace {
+constexpr uint32_t PRIMARY_WIDTH = 4000;
+constexpr uint32_t PRIMARY_HEIGHT = 3000;
+constexpr int32_t BYTES_PER_PIXEL = 4;
+
+// the sizes the fake codec provides, and what it is asked to output.
+struct FakeHeifCodecState {
+    std::vector<PlSize> supportedSizes;
+    bool acceptOutputSize = true;
+    PlSize outputSize = { PRIMARY_WIDTH, PRIMARY_HEIGHT };
+    PlSize decodedSize;
+    uint32_t decodedRowBytes = 0;
+};
+
+FakeHeifCodecState g_codecState;
+
+class FakeHeifDecoderInterface : public HeifDecoderInterface {
+public:
+    void GetHeifSize(PlSize &size) override
+    {
+        size.width = PRIMARY_WIDTH;
+        size.height = PRIMARY_HEIGHT;
+    }
+    void SetAllowPartial(const bool isAllowPartialImage) override {}
+    bool ConversionSupported(const PlPixelFormat &plPixelFormat, int32_t &bytesPerPixel) override
+    {
+        bytesPerPixel = BYTES_PER_PIXEL;
+        return true;
+    }
+    uint32_t OnGetPixels(const PlSize &dstSize, const uint32_t dstRowBytes, DecodeContext &context) override
+    {
+        g_codecState.decodedSize = dstSize;
+        g_codecState.decodedRowBytes = dstRowBytes;
+        return SUCCESS;
+    }
+    void GetSupportedSizes(std::vector<PlSize> &sizes) override
+    {
+        sizes = g_codecState.supportedSizes;
+    }
+    bool SetOutputSize(const PlSize &size) override
+    {
+        if (!g_codecState.acceptOutputSize) {
+            return false;
+        }
+        g_codecState.outputSize = size;
+        return true;
+    }
+};
+} // namespace
+
+namespace OHOS {
+namespace ImagePlugin {
+// the codec of the device is replaced by the fake one.
+std::unique_ptr<HeifDecoderInterface> HeifDecoderWrapper::CreateHeifDecoderInterface(InputDataStream &stream)
+{
+    return std::make_unique<FakeHeifDecoderInterface>();
+}
+} // namespace ImagePlugin
+} // namespace OHOS
+
+class HeifDecoderTest : public testing::Test {
+public:
+    HeifDecoderTest() {}
+    ~HeifDecoderTest() {}
+    void SetUp();
+
+    // set the options to the decoder of the fake codec, return the size reported by the decoder.
+    static PlSize SetDecodeOptions(HeifDecoder &decoder, const PixelDecodeOptions &opts);
+};
+
+void HeifDecoderTest::SetUp(void)
+{
+    g_codecState = FakeHeifCodecState();
+    // an embedded thumbnail and two reduced resolutions.
+    g_codecState.supportedSizes = { { 2000, 1500 }, { 320, 240 }, { 1000, 750 } };
+}
+
+PlSize HeifDecoderTest::SetDecodeOptions(HeifDecoder &decoder, const PixelDecodeOptions &opts)
+{
+    static const uint8_t data[] = { 0 };
+    std::unique_ptr<BufferSourceStream> stream = BufferSourceStream::CreateSourceStream(data, sizeof(data));
+    EXPECT_NE(stream.get(), nullptr);
+    decoder.SetSource(*stream);
+    PlImageInfo info;
+    EXPECT_EQ(decoder.SetDecodeOptions(0, opts, info), SUCCESS);
+    return info.size;
+}
+
+/**
+ * @tc.name: HeifDecodeReducedSize001
+ * @tc.desc: Decode at the smallest size provided by the codec which is not smaller than the desired size.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HeifDecoderTest, HeifDecodeReducedSize001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. set a desired size smaller than the thumbnail, then decode.
+     * @tc.expected: step1. the thumbnail size is reported and decoded.
+     */
+    HeifDecoder decoder;
+    PixelDecodeOptions opts;
+    opts.desiredSize = { 256, 192 };
+    PlSize size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, 320u);
+    ASSERT_EQ(size.height, 240u);
+    DecodeContext context;
+    ASSERT_EQ(decoder.Decode(0, context), SUCCESS);
+    ASSERT_NE(context.pixelsBuffer.buffer, nullptr);
+    ASSERT_EQ(context.pixelsBuffer.bufferSize, 320u * 240u * BYTES_PER_PIXEL);
+    free(context.pixelsBuffer.buffer);
+    ASSERT_EQ(g_codecState.decodedSize.width, 320u);
+    ASSERT_EQ(g_codecState.decodedSize.height, 240u);
+    ASSERT_EQ(g_codecState.decodedRowBytes, 320u * BYTES_PER_PIXEL);
+    /**
+     * @tc.steps: step2. set a desired size between the provided sizes.
+     * @tc.expected: step2. the closest larger size is selected.
+     */
+    opts.desiredSize = { 1200, 900 };
+    size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, 2000u);
+    ASSERT_EQ(size.height, 1500u);
+    ASSERT_EQ(g_codecState.outputSize.width, 2000u);
+    /**
+     * @tc.steps: step3. set a desired size equal to a provided size, and one only covered in one dimension.
+     * @tc.expected: step3. the equal size is selected, a size must cover both dimensions.
+     */
+    opts.desiredSize = { 1000, 750 };
+    size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, 1000u);
+    ASSERT_EQ(size.height, 750u);
+    opts.desiredSize = { 300, 1000 };
+    size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, 2000u);
+    ASSERT_EQ(size.height, 1500u);
+    /**
+     * @tc.steps: step4. set a desired size larger than all the provided sizes.
+     * @tc.expected: step4. the primary image is decoded.
+     */
+    opts.desiredSize = { 3000, 2250 };
+    size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, PRIMARY_WIDTH);
+    ASSERT_EQ(size.height, PRIMARY_HEIGHT);
+}
+
+/**
+ * @tc.name: HeifDecodeReducedSize002
+ * @tc.desc: Decode at a reduced size by the sample size, and at the full size when a size can't be reduced.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HeifDecoderTest, HeifDecodeReducedSize002, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. set a sample size without a desired size.
+     * @tc.expected: step1. the size covering the sampled image size is selected.
+     */
+    HeifDecoder decoder;
+    PixelDecodeOptions opts;
+    opts.sampleSize = 4;
+    PlSize size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, 1000u);
+    ASSERT_EQ(size.height, 750u);
+    /**
+     * @tc.steps: step2. set a crop rect in the coordinates of the primary image.
+     * @tc.expected: step2. the primary image is decoded.
+     */
+    opts.desiredSize = { 256, 192 };
+    opts.CropRect = { 0, 0, 800, 600 };
+    size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, PRIMARY_WIDTH);
+    ASSERT_EQ(size.height, PRIMARY_HEIGHT);
+    /**
+     * @tc.steps: step3. decode by a codec which provides no reduced size, then by one which refuses the size.
+     * @tc.expected: step3. the primary image is decoded.
+     */
+    opts.CropRect = {};
+    g_codecState.supportedSizes.clear();
+    size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, PRIMARY_WIDTH);
+    ASSERT_EQ(size.height, PRIMARY_HEIGHT);
+    g_codecState.supportedSizes = { { 320, 240 } };
+    g_codecState.acceptOutputSize = false;
+    size = SetDecodeOptions(decoder, opts);
+    ASSERT_EQ(size.width, PRIMARY_WIDTH);
+    ASSERT_EQ(size.height, PRIMARY_HEIGHT);
+}
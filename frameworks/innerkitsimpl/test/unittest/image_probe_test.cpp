@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "image_probe.h"
+#include "image_source.h"
+#include "image_source_util.h"
+#include "image_type.h"
+#include "image_utils.h"
+#include "media_errors.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+using namespace OHOS::ImageSourceUtil;
+
+static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test.jpg";
+static const std::string IMAGE_INPUT_PNG_PATH = "/data/local/tmp/image/test.png";
+static const std::string IMAGE_INPUT_GIF_PATH = "/data/local/tmp/image/moving_test.gif";
+static const std::string IMAGE_INPUT_WEBP_PATH = "/data/local/tmp/image/test_large.webp";
+static const std::string IMAGE_INPUT_BMP_PATH = "/data/local/tmp/image/test.bmp";
+static const std::string IMAGE_INPUT_INVALID_PATH = "/data/local/tmp/image/not_exist.jpg";
+
+class ImageProbeTest : public testing::Test {
+public:
+    ImageProbeTest() {};
+    ~ImageProbeTest() {};
+};
+
+/**
+ * @tc.name: ImageProbe001
+ * @tc.desc: Probe images of each format by path and compare with the image source.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageProbeTest, ImageProbe001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. probe the images by a batch of paths.
+     * @tc.expected: step1. probe success, the results are in the order of the paths.
+     */
+    std::vector<std::string> paths = { IMAGE_INPUT_JPEG_PATH, IMAGE_INPUT_PNG_PATH, IMAGE_INPUT_GIF_PATH,
+                                       IMAGE_INPUT_WEBP_PATH, IMAGE_INPUT_BMP_PATH };
+    std::vector<ImageProbeInfo> infos = ImageProbe::Probe(paths);
+    ASSERT_EQ(infos.size(), paths.size());
+    /**
+     * @tc.steps: step2. get the image info by image source.
+     * @tc.expected: step2. the probed format, size and frame count equal those of the image source.
+     */
+    for (size_t i = 0; i < paths.size(); i++) {
+        ASSERT_EQ(infos[i].errorCode, SUCCESS);
+        uint32_t errorCode = 0;
+        SourceOptions opts;
+        std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(paths[i], opts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(imageSource.get(), nullptr);
+        ImageInfo imageInfo;
+        ASSERT_EQ(imageSource->GetImageInfo(imageInfo), SUCCESS);
+        const SourceInfo &sourceInfo = imageSource->GetSourceInfo(errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_EQ(infos[i].encodedFormat, sourceInfo.encodedFormat);
+        ASSERT_EQ(infos[i].size.width, imageInfo.size.width);
+        ASSERT_EQ(infos[i].size.height, imageInfo.size.height);
+        ASSERT_EQ(infos[i].orientation, 1);
+    }
+    ASSERT_EQ(infos[2].frameCount, 3u);
+}
+
+/**
+ * @tc.name: ImageProbe002
+ * @tc.desc: Probe jpeg image by fd and by buffer.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageProbeTest, ImageProbe002, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. probe the jpeg image by fd.
+     * @tc.expected: step1. probe success, the fd is not closed and its position is kept.
+     */
+    int fd = open(IMAGE_INPUT_JPEG_PATH.c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+    ImageProbeInfo fdInfo;
+    ASSERT_EQ(ImageProbe::Probe(fd, fdInfo), SUCCESS);
+    ASSERT_EQ(fdInfo.encodedFormat, "image/jpeg");
+    ASSERT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+    close(fd);
+    /**
+     * @tc.steps: step2. probe the jpeg image by buffer.
+     * @tc.expected: step2. probe success, the result equals that of the fd.
+     */
+    size_t bufferSize = 0;
+    ASSERT_EQ(ImageUtils::GetFileSize(IMAGE_INPUT_JPEG_PATH, bufferSize), true);
+    uint8_t *buffer = static_cast<uint8_t *>(malloc(bufferSize));
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ(ReadFileToBuffer(IMAGE_INPUT_JPEG_PATH, buffer, bufferSize), true);
+    ImageProbeBuffer probeBuffer;
+    probeBuffer.data = buffer;
+    probeBuffer.size = bufferSize;
+    std::vector<ImageProbeInfo> infos = ImageProbe::Probe(std::vector<ImageProbeBuffer> { probeBuffer });
+    ASSERT_EQ(infos.size(), 1u);
+    ASSERT_EQ(infos[0].errorCode, SUCCESS);
+    ASSERT_EQ(infos[0].encodedFormat, fdInfo.encodedFormat);
+    ASSERT_EQ(infos[0].size.width, fdInfo.size.width);
+    ASSERT_EQ(infos[0].size.height, fdInfo.size.height);
+    /**
+     * @tc.steps: step3. probe the truncated jpeg header.
+     * @tc.expected: step3. probe fail.
+     */
+    ImageProbeInfo info;
+    ASSERT_NE(ImageProbe::Probe(buffer, 4, info), SUCCESS);
+    ASSERT_NE(info.errorCode, SUCCESS);
+    free(buffer);
+}
+
+/**
+ * @tc.name: ImageProbe003
+ * @tc.desc: Probe a batch of paths with an invalid one.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageProbeTest, ImageProbe003, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. probe a batch of paths which has a path not exist.
+     * @tc.expected: step1. only the probe of the invalid path fails.
+     */
+    std::vector<std::string> paths = { IMAGE_INPUT_PNG_PATH, IMAGE_INPUT_INVALID_PATH, IMAGE_INPUT_JPEG_PATH };
+    std::vector<ImageProbeInfo> infos = ImageProbe::Probe(paths);
+    ASSERT_EQ(infos.size(), paths.size());
+    ASSERT_EQ(infos[0].errorCode, SUCCESS);
+    ASSERT_EQ(infos[0].encodedFormat, "image/png");
+    ASSERT_EQ(infos[1].errorCode, ERR_IMAGE_SOURCE_DATA);
+    ASSERT_EQ(infos[2].errorCode, SUCCESS);
+    ASSERT_EQ(infos[2].encodedFormat, "image/jpeg");
+}
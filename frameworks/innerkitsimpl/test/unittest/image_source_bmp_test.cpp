@@ -14,6 +14,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include <fstream>
 #include "directory_ex.h"
 #include "hilog/log.h"
@@ -396,4 +397,61 @@ HWTEST_F(ImageSourceBmpTest, BmpImageDecode011, TestSize.Level3)
     std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
     ASSERT_NE(errorCode, SUCCESS);
     ASSERT_EQ(pixelMap.get(), nullptr);
-}
\ No newline at end of file
+}
+
+/**
+ * @tc.name: BmpImageDecode012
+ * @tc.desc: Decode bmp image with sample size by bmp plugin itself
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceBmpTest, BmpImageDecode012, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create image source by correct bmp file path and bmp format hit.
+     * @tc.expected: step1. create image source success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = "image/bmp";
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_BMP_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    ImageInfo imageInfo;
+    errorCode = imageSource->GetImageInfo(imageInfo);
+    ASSERT_EQ(errorCode, SUCCESS);
+    /**
+     * @tc.steps: step2. decode image source to pixel map with sample size 2.
+     * @tc.expected: step2. decode image source to pixel map success and the size is halved.
+     */
+    DecodeOptions decodeOpts;
+    decodeOpts.sampleSize = 2;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), std::max(imageInfo.size.width / 2, 1));
+    ASSERT_EQ(pixelMap->GetHeight(), std::max(imageInfo.size.height / 2, 1));
+    /**
+     * @tc.steps: step3. decode image source to pixel map in full size as the reference.
+     * @tc.expected: step3. each sampled pixel is the same as the center one of its 2x2 block in the reference.
+     */
+    DecodeOptions referenceOpts;
+    std::unique_ptr<PixelMap> referencePixelMap = imageSource->CreatePixelMap(referenceOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(referencePixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetPixelFormat(), referencePixelMap->GetPixelFormat());
+    int32_t pixelBytes = pixelMap->GetPixelBytes();
+    const int32_t sampleSize = 2;
+    for (int32_t y = 0; y < pixelMap->GetHeight(); y++) {
+        int32_t referenceY = (imageInfo.size.height < sampleSize) ? (imageInfo.size.height / 2) :
+            (y * sampleSize + sampleSize / 2);
+        for (int32_t x = 0; x < pixelMap->GetWidth(); x++) {
+            int32_t referenceX = (imageInfo.size.width < sampleSize) ? (imageInfo.size.width / 2) :
+                (x * sampleSize + sampleSize / 2);
+            const uint8_t *pixel = pixelMap->GetPixel(x, y);
+            const uint8_t *referencePixel = referencePixelMap->GetPixel(referenceX, referenceY);
+            ASSERT_NE(pixel, nullptr);
+            ASSERT_NE(referencePixel, nullptr);
+            ASSERT_EQ(memcmp(pixel, referencePixel, pixelBytes), 0);
+        }
+    }
+}
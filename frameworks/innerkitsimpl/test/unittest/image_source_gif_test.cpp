@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 #include <fstream>
+#include <future>
+#include "decode_task_pool.h"
 #include "directory_ex.h"
 #include "hilog/log.h"
 #include "image_packer.h"
@@ -43,6 +45,22 @@ public:
     ~ImageSourceGifTest() {};
 };
 
+// cancels the pending decoding tasks of another source once the header of the listened source is decoded.
+class CancelTasksListener : public DecodeListener {
+public:
+    explicit CancelTasksListener(const ImageSource *owner) : owner_(owner) {};
+    ~CancelTasksListener() {};
+    void OnEvent(int event) override
+    {
+        if (event == static_cast<int>(DecodeEvent::EVENT_HEADER_DECODE)) {
+            DecodeTaskPool::GetInstance().CancelTasks(owner_);
+        }
+    }
+
+private:
+    const ImageSource *owner_;
+};
+
 /**
  * @tc.name: GifImageDecode001
  * @tc.desc: Decode gif image from file source stream
@@ -369,3 +387,126 @@ HWTEST_F(ImageSourceGifTest, GifImageDecode007, TestSize.Level3)
     ASSERT_EQ(errorCode, SUCCESS);
     ASSERT_EQ(3, imageCount);
 }
+
+/**
+ * @tc.name: GifImageDecode008
+ * @tc.desc: Decode the frames of moving gif image and a list of sources in one call
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifTest, GifImageDecode008, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. decode the frames one by one as the reference.
+     * @tc.expected: step1. decode image source to pixel maps success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = "image/gif";
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource("/data/local/tmp/image/moving_test.gif", opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    const uint32_t imageCount = 3;
+    std::vector<std::unique_ptr<PixelMap>> expectedPixelMaps;
+    for (uint32_t i = 0; i < imageCount; i++) {
+        expectedPixelMaps.push_back(imageSource->CreatePixelMap(i, decodeOpts, errorCode));
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(expectedPixelMaps.back().get(), nullptr);
+    }
+    /**
+     * @tc.steps: step2. decode the frames of unordered and repeated indices in one call by a new source.
+     * @tc.expected: step2. each pixel map has the pixels of its frame, the out of range index fails.
+     */
+    std::unique_ptr<ImageSource> batchSource =
+        ImageSource::CreateImageSource("/data/local/tmp/image/moving_test.gif", opts, errorCode);
+    ASSERT_NE(batchSource.get(), nullptr);
+    const std::vector<uint32_t> indices = { 2, 0, 1, 2, imageCount };
+    std::vector<uint32_t> errorCodes;
+    std::vector<std::unique_ptr<PixelMap>> pixelMaps = batchSource->CreatePixelMaps(indices, decodeOpts, errorCodes);
+    ASSERT_EQ(pixelMaps.size(), indices.size());
+    ASSERT_EQ(errorCodes.size(), indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (indices[i] >= imageCount) {
+            ASSERT_NE(errorCodes[i], SUCCESS);
+            ASSERT_EQ(pixelMaps[i].get(), nullptr);
+            continue;
+        }
+        ASSERT_EQ(errorCodes[i], SUCCESS);
+        ASSERT_NE(pixelMaps[i].get(), nullptr);
+        ASSERT_EQ(pixelMaps[i]->IsSameImage(*expectedPixelMaps[indices[i]]), true);
+    }
+    /**
+     * @tc.steps: step3. decode a list of sources with a null one in one call.
+     * @tc.expected: step3. each pixel map has the pixels of its first frame, the null source fails.
+     */
+    std::vector<ImageSource *> sources = { imageSource.get(), nullptr, batchSource.get() };
+    pixelMaps = ImageSource::CreatePixelMaps(sources, decodeOpts, errorCodes);
+    ASSERT_EQ(pixelMaps.size(), sources.size());
+    ASSERT_EQ(errorCodes[1], ERR_IMAGE_INVALID_PARAMETER);
+    ASSERT_EQ(pixelMaps[1].get(), nullptr);
+    for (size_t i : { 0, 2 }) {
+        ASSERT_EQ(errorCodes[i], SUCCESS);
+        ASSERT_NE(pixelMaps[i].get(), nullptr);
+        ASSERT_EQ(pixelMaps[i]->IsSameImage(*expectedPixelMaps[0]), true);
+    }
+}
+
+/**
+ * @tc.name: GifImageDecode009
+ * @tc.desc: Decode a list of sources in one call while the task of one source is canceled by the pool
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifTest, GifImageDecode009, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. keep the only decode thread busy, so that the tasks of the batch are pending.
+     * @tc.expected: step1. create the image sources success.
+     */
+    DecodeTaskPool &pool = DecodeTaskPool::GetInstance();
+    uint32_t maxWorkers = pool.GetMaxWorkers();
+    pool.SetMaxWorkers(1);
+    std::promise<void> gate;
+    std::shared_future<void> gateFuture = gate.get_future().share();
+    std::promise<void> gateDone;
+    DecodeTask gateTask;
+    gateTask.priority = DecodePriority::HIGH;
+    gateTask.run = [gateFuture, &gateDone]() {
+        gateFuture.wait();
+        gateDone.set_value();
+    };
+    pool.Submit(std::move(gateTask));
+    std::vector<std::unique_ptr<ImageSource>> imageSources;
+    for (uint32_t i = 0; i < 3; i++) {
+        uint32_t errorCode = 0;
+        SourceOptions opts;
+        opts.formatHint = "image/gif";
+        imageSources.push_back(ImageSource::CreateImageSource("/data/local/tmp/image/moving_test.gif", opts,
+            errorCode));
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(imageSources.back().get(), nullptr);
+    }
+    /**
+     * @tc.steps: step2. decode the sources in one call, the first source decoded on the caller thread cancels the
+     * pending task of the last source.
+     * @tc.expected: step2. the call returns, the canceled source fails and the others succeed.
+     */
+    CancelTasksListener listener(imageSources[2].get());
+    imageSources[0]->AddDecodeListener(&listener);
+    std::vector<ImageSource *> sources = { imageSources[0].get(), imageSources[1].get(), imageSources[2].get() };
+    DecodeOptions decodeOpts;
+    std::vector<uint32_t> errorCodes;
+    std::vector<std::unique_ptr<PixelMap>> pixelMaps = ImageSource::CreatePixelMaps(sources, decodeOpts,
+        errorCodes);
+    imageSources[0]->RemoveDecodeListener(&listener);
+    gate.set_value();
+    gateDone.get_future().wait();
+    pool.SetMaxWorkers(maxWorkers);
+    ASSERT_EQ(pixelMaps.size(), sources.size());
+    ASSERT_EQ(errorCodes[0], SUCCESS);
+    ASSERT_NE(pixelMaps[0].get(), nullptr);
+    ASSERT_EQ(errorCodes[1], SUCCESS);
+    ASSERT_NE(pixelMaps[1].get(), nullptr);
+    ASSERT_EQ(errorCodes[2], ERR_IMAGE_DECODE_CANCELED);
+    ASSERT_EQ(pixelMaps[2].get(), nullptr);
+}
@@ -13,19 +13,27 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <gtest/gtest.h>
 #include <fstream>
 #include <fcntl.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
 #include "directory_ex.h"
+#include "file_source_stream.h"
 #include "hilog/log.h"
 #include "image_packer.h"
 #include "image_source.h"
 #include "image_type.h"
 #include "image_utils.h"
 #include "incremental_pixel_map.h"
+#include "istream_source_stream.h"
 #include "log_tags.h"
 #include "media_errors.h"
 #include "pixel_map.h"
+#include "pixel_map_cache.h"
 #include "image_receiver.h"
 #include "image_source_util.h"
 #include "graphic_common.h"
@@ -40,9 +48,12 @@ static constexpr OHOS::HiviewDFX::HiLogLabel LABEL_TEST = {
     LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "ImageSourceJpegTest"
 };
 static constexpr uint32_t DEFAULT_DELAY_UTIME = 10000;  // 10 ms.
+static constexpr uint32_t DEFAULT_DECODER_POOL_SIZE = 2;
 static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test.jpg";
 static const std::string IMAGE_INPUT_HW_JPEG_PATH = "/data/local/tmp/image/test_hw.jpg";
+static const std::string IMAGE_INPUT_PROGRESSIVE_JPEG_PATH = "/data/local/tmp/image/test_progressive.jpg";
 static const std::string IMAGE_INPUT_EXIF_JPEG_PATH = "/data/local/tmp/image/test_exif.jpg";
+static const std::string IMAGE_INPUT_RESTART_JPEG_PATH = "/data/local/tmp/image/test_restart.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_FILE_PATH = "/data/test/test_file.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_BUFFER_PATH = "/data/test/test_buffer.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_ISTREAM_PATH = "/data/test/test_istream.jpg";
@@ -54,6 +65,8 @@ static const std::string IMAGE_OUTPUT_JPEG_MULTI_INC1_PATH = "/data/test/test_in
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_ONETIME1_PATH = "/data/test/test_onetime1.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_INC2_PATH = "/data/test/test_inc2.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_ONETIME2_PATH = "/data/test/test_onetime2.jpg";
+static const std::string IMAGE_OUTPUT_JPEG_PROGRESSIVE_INC_PATH = "/data/test/test_progressive_inc.jpg";
+static const std::string IMAGE_OUTPUT_JPEG_MTIME_PATH = "/data/test/test_mtime.jpg";
 
 const std::string ORIENTATION = "Orientation";
 const std::string IMAGE_HEIGHT = "ImageHeight";
@@ -69,6 +82,22 @@ public:
     ~ImageSourceJpegTest() {};
 };
 
+class CancelDecodeListener : public DecodeListener {
+public:
+    explicit CancelDecodeListener(std::shared_ptr<DecodeCancelToken> cancelToken) : cancelToken_(cancelToken) {};
+    ~CancelDecodeListener() {};
+    void OnEvent(int event) override
+    {
+        // the header is decoded, cancel the decoding before the decoder starts to output pixels.
+        if (event == static_cast<int>(DecodeEvent::EVENT_HEADER_DECODE) && cancelToken_ != nullptr) {
+            cancelToken_->Cancel();
+        }
+    }
+
+private:
+    std::shared_ptr<DecodeCancelToken> cancelToken_;
+};
+
 /**
  * @tc.name: TC028
  * @tc.desc: Create ImageSource(stream)
@@ -960,6 +989,783 @@ HWTEST_F(ImageSourceJpegTest, JpegImageDecode010, TestSize.Level3)
     free(buffer);
 }
 
+/**
+ * @tc.name: JpegImageDecode011
+ * @tc.desc: Decode progressive jpeg image by incremental mode, full frame previews are output before completion.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode011, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create image source by incremental source stream and default format hit
+     * @tc.expected: step1. create image source success.
+     */
+    size_t bufferSize = 0;
+    bool fileRet = ImageUtils::GetFileSize(IMAGE_INPUT_PROGRESSIVE_JPEG_PATH, bufferSize);
+    ASSERT_EQ(fileRet, true);
+    uint8_t *buffer = (uint8_t *)malloc(bufferSize);
+    ASSERT_NE(buffer, nullptr);
+    fileRet = OHOS::ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_PROGRESSIVE_JPEG_PATH, buffer, bufferSize);
+    ASSERT_EQ(fileRet, true);
+    uint32_t errorCode = 0;
+    IncrementalSourceOptions incOpts;
+    incOpts.incrementalMode = IncrementalMode::INCREMENTAL_DATA;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateIncrementalImageSource(incOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    /**
+     * @tc.steps: step2. update incremental stream by 512 bytes each time and promote decode image to pixel map
+     * by default decode options.
+     * @tc.expected: step2. scans are rendered before the data completes, and decode success at last.
+     */
+    DecodeOptions decodeOpts;
+    std::unique_ptr<IncrementalPixelMap> incPixelMap = imageSource->CreateIncrementalPixelMap(0, decodeOpts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(incPixelMap.get(), nullptr);
+    const uint32_t updateOnceSize = 512;
+    uint32_t updateSize = 0;
+    uint32_t previewScans = 0;
+    while (updateSize < bufferSize) {
+        uint32_t dataSize = std::min(updateOnceSize, static_cast<uint32_t>(bufferSize - updateSize));
+        bool isCompleted = (updateSize + dataSize == bufferSize);
+        uint32_t ret = imageSource->UpdateData(buffer + updateSize, dataSize, isCompleted);
+        ASSERT_EQ(ret, SUCCESS);
+        updateSize += dataSize;
+        uint8_t decodeProgress = 0;
+        incPixelMap->PromoteDecoding(decodeProgress);
+        const IncrementalDecodingStatus &status = incPixelMap->GetDecodingStatus();
+        if (!isCompleted) {
+            previewScans = status.renderedScans;
+        }
+    }
+    ASSERT_GT(previewScans, 0);
+    incPixelMap->DetachFromDecoding();
+    IncrementalDecodingStatus status = incPixelMap->GetDecodingStatus();
+    ASSERT_EQ(status.decodingProgress, 100);
+    ASSERT_GT(status.renderedScans, previewScans);
+    /**
+     * @tc.steps: step3. compress the pixel map to jpeg file.
+     * @tc.expected: step3. pack pixel map success.
+     */
+    int64_t packSize = OHOS::ImageSourceUtil::PackImage(IMAGE_OUTPUT_JPEG_PROGRESSIVE_INC_PATH,
+                                                        std::move(incPixelMap));
+    ASSERT_NE(packSize, 0);
+    free(buffer);
+}
+
+/**
+ * @tc.name: JpegImageDecode012
+ * @tc.desc: Decode jpeg image from one image source on several threads, results equal to the serialized decoding.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode012, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create image source by correct jpeg file path and jpeg format hit.
+     * @tc.expected: step1. create image source success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = "image/jpeg";
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    /**
+     * @tc.steps: step2. decode the full size and a smaller size one by one as reference.
+     * @tc.expected: step2. decode image source to pixel map success.
+     */
+    DecodeOptions fullOpts;
+    DecodeOptions smallOpts;
+    smallOpts.desiredSize.width = 200;
+    smallOpts.desiredSize.height = 100;
+    std::unique_ptr<PixelMap> fullRef = imageSource->CreatePixelMap(fullOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(fullRef.get(), nullptr);
+    std::unique_ptr<PixelMap> smallRef = imageSource->CreatePixelMap(smallOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(smallRef.get(), nullptr);
+    /**
+     * @tc.steps: step3. decode the two sizes on two threads at the same time.
+     * @tc.expected: step3. decode success and the pixels equal to the reference.
+     */
+    std::unique_ptr<PixelMap> fullPixelMap;
+    std::unique_ptr<PixelMap> smallPixelMap;
+    uint32_t fullError = 0;
+    uint32_t smallError = 0;
+    std::thread fullThread([&]() { fullPixelMap = imageSource->CreatePixelMap(fullOpts, fullError); });
+    std::thread smallThread([&]() { smallPixelMap = imageSource->CreatePixelMap(smallOpts, smallError); });
+    fullThread.join();
+    smallThread.join();
+    ASSERT_EQ(fullError, SUCCESS);
+    ASSERT_EQ(smallError, SUCCESS);
+    ASSERT_NE(fullPixelMap.get(), nullptr);
+    ASSERT_NE(smallPixelMap.get(), nullptr);
+    ASSERT_EQ(fullPixelMap->GetByteCount(), fullRef->GetByteCount());
+    ASSERT_EQ(memcmp(fullPixelMap->GetPixels(), fullRef->GetPixels(), fullRef->GetByteCount()), 0);
+    ASSERT_EQ(smallPixelMap->GetByteCount(), smallRef->GetByteCount());
+    ASSERT_EQ(memcmp(smallPixelMap->GetPixels(), smallRef->GetPixels(), smallRef->GetByteCount()), 0);
+}
+
+/**
+ * @tc.name: JpegImageDecode013
+ * @tc.desc: Recognize jpeg format from buffer source without format hint or with a wrong one.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode013, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. read the jpeg file to buffer.
+     * @tc.expected: step1. read success.
+     */
+    size_t bufferSize = 0;
+    bool fileRet = ImageUtils::GetFileSize(IMAGE_INPUT_JPEG_PATH, bufferSize);
+    ASSERT_EQ(fileRet, true);
+    uint8_t *buffer = (uint8_t *)malloc(bufferSize);
+    ASSERT_NE(buffer, nullptr);
+    fileRet = OHOS::ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_JPEG_PATH, buffer, bufferSize);
+    ASSERT_EQ(fileRet, true);
+    /**
+     * @tc.steps: step2. create image source without format hint and get source info.
+     * @tc.expected: step2. the encoded format is jpeg.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(buffer, bufferSize, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    SourceInfo sourceInfo = imageSource->GetSourceInfo(errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_EQ(sourceInfo.encodedFormat, "image/jpeg");
+    /**
+     * @tc.steps: step3. create image source with png format hint and get source info.
+     * @tc.expected: step3. the encoded format is jpeg.
+     */
+    opts.formatHint = "image/png";
+    imageSource = ImageSource::CreateImageSource(buffer, bufferSize, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    sourceInfo = imageSource->GetSourceInfo(errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_EQ(sourceInfo.encodedFormat, "image/jpeg");
+    free(buffer);
+}
+
+/**
+ * @tc.name: JpegImageDecode014
+ * @tc.desc: Decode the same jpeg file twice with the pixel map cache enabled, and a modified file again.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode014, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. enable the pixel map cache and create image source by path.
+     * @tc.expected: step1. create image source success.
+     */
+    PixelMapCache &cache = PixelMapCache::GetInstance();
+    cache.SetBudget(64 * 1024 * 1024);  // 64 MB.
+    cache.ResetStats();
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    /**
+     * @tc.steps: step2. decode the image, then decode it again from a new image source of the same file.
+     * @tc.expected: step2. the second decoding hits the cache and returns the same pixels in its own buffer.
+     */
+    DecodeOptions decodeOpts;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    std::unique_ptr<ImageSource> imageSource2 = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource2.get(), nullptr);
+    std::unique_ptr<PixelMap> cachedPixelMap = imageSource2->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(cachedPixelMap.get(), nullptr);
+    PixelMapCacheStats stats = cache.GetStats();
+    ASSERT_EQ(stats.hits, 1u);
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.entryCount, 1u);
+    ASSERT_NE(cachedPixelMap->GetPixels(), pixelMap->GetPixels());
+    ASSERT_EQ(cachedPixelMap->GetWidth(), pixelMap->GetWidth());
+    ASSERT_EQ(cachedPixelMap->GetHeight(), pixelMap->GetHeight());
+    ASSERT_EQ(cachedPixelMap->GetByteCount(), pixelMap->GetByteCount());
+    ASSERT_EQ(memcmp(cachedPixelMap->GetPixels(), pixelMap->GetPixels(), pixelMap->GetByteCount()), 0);
+    /**
+     * @tc.steps: step3. decode with another desired size.
+     * @tc.expected: step3. the cache misses and a new entry is added.
+     */
+    decodeOpts.desiredSize.width = pixelMap->GetWidth() / 2;
+    decodeOpts.desiredSize.height = pixelMap->GetHeight() / 2;
+    std::unique_ptr<PixelMap> smallPixelMap = imageSource2->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(smallPixelMap.get(), nullptr);
+    stats = cache.GetStats();
+    ASSERT_EQ(stats.misses, 2u);
+    ASSERT_EQ(stats.entryCount, 2u);
+    /**
+     * @tc.steps: step4. decode a copy of the file, then touch it within the same second and decode it again.
+     * @tc.expected: step4. the modified file misses the cache.
+     */
+    {
+        std::ifstream input(IMAGE_INPUT_JPEG_PATH, std::ios::binary);
+        std::ofstream output(IMAGE_OUTPUT_JPEG_MTIME_PATH, std::ios::binary | std::ios::trunc);
+        output << input.rdbuf();
+    }
+    struct timespec times[2] = { { 1, 0 }, { 1, 0 } };  // the access and the modification time.
+    ASSERT_EQ(utimensat(AT_FDCWD, IMAGE_OUTPUT_JPEG_MTIME_PATH.c_str(), times, 0), 0);
+    decodeOpts.desiredSize = { 0, 0 };
+    imageSource = ImageSource::CreateImageSource(IMAGE_OUTPUT_JPEG_MTIME_PATH, opts, errorCode);
+    ASSERT_NE(imageSource.get(), nullptr);
+    pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    times[1].tv_nsec = 500000000;  // half a second later.
+    ASSERT_EQ(utimensat(AT_FDCWD, IMAGE_OUTPUT_JPEG_MTIME_PATH.c_str(), times, 0), 0);
+    imageSource = ImageSource::CreateImageSource(IMAGE_OUTPUT_JPEG_MTIME_PATH, opts, errorCode);
+    ASSERT_NE(imageSource.get(), nullptr);
+    pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    stats = cache.GetStats();
+    ASSERT_EQ(stats.hits, 1u);
+    ASSERT_EQ(stats.misses, 4u);
+    /**
+     * @tc.steps: step5. disable the pixel map cache.
+     * @tc.expected: step5. all entries are dropped.
+     */
+    cache.SetBudget(0);
+    stats = cache.GetStats();
+    ASSERT_EQ(stats.entryCount, 0u);
+    ASSERT_EQ(stats.usedBytes, 0u);
+}
+
+/**
+ * @tc.name: JpegImageDecode015
+ * @tc.desc: Decode jpeg image asynchronously with priorities.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode015, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create image source by file path and decode it synchronously as reference.
+     * @tc.expected: step1. decode success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    std::unique_ptr<PixelMap> refPixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(refPixelMap.get(), nullptr);
+    /**
+     * @tc.steps: step2. decode the image asynchronously with a complete callback.
+     * @tc.expected: step2. the callback is called once and the result equals the reference.
+     */
+    std::atomic<uint32_t> callbackCount(0);
+    std::atomic<uint32_t> callbackError(0);
+    std::shared_ptr<PixelMapFuture> future = imageSource->CreatePixelMapAsync(decodeOpts, DecodePriority::HIGH,
+        [&callbackCount, &callbackError](uint32_t errorCode) {
+            callbackError = errorCode;
+            callbackCount++;
+        });
+    ASSERT_NE(future.get(), nullptr);
+    std::unique_ptr<PixelMap> pixelMap = future->Get(errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(future->IsReady(), true);
+    ASSERT_EQ(pixelMap->GetByteCount(), refPixelMap->GetByteCount());
+    ASSERT_EQ(memcmp(pixelMap->GetPixels(), refPixelMap->GetPixels(), refPixelMap->GetByteCount()), 0);
+    ASSERT_EQ(future->Get(errorCode), nullptr);
+    while (callbackCount == 0) {
+        usleep(DEFAULT_DELAY_UTIME);
+    }
+    ASSERT_EQ(callbackCount, 1u);
+    ASSERT_EQ(callbackError, SUCCESS);
+    /**
+     * @tc.steps: step3. submit prefetch decodings and destroy the image source.
+     * @tc.expected: step3. every decoding is either done or canceled.
+     */
+    const uint32_t prefetchCount = 8;
+    std::vector<std::shared_ptr<PixelMapFuture>> futures;
+    for (uint32_t i = 0; i < prefetchCount; i++) {
+        futures.push_back(imageSource->CreatePixelMapAsync(decodeOpts, DecodePriority::LOW));
+    }
+    imageSource = nullptr;
+    for (auto &prefetch : futures) {
+        ASSERT_NE(prefetch.get(), nullptr);
+        std::unique_ptr<PixelMap> prefetchPixelMap = prefetch->Get(errorCode);
+        ASSERT_EQ(errorCode == SUCCESS || errorCode == ERR_IMAGE_DECODE_CANCELED, true);
+        ASSERT_EQ(prefetchPixelMap != nullptr, errorCode == SUCCESS);
+    }
+}
+
+/**
+ * @tc.name: JpegImageDecode016
+ * @tc.desc: Cancel jpeg image decoding by the cancel token and by the future, without the token of the caller.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode016, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create image source by file path.
+     * @tc.expected: step1. create image source success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    /**
+     * @tc.steps: step2. decode image source with a canceled token.
+     * @tc.expected: step2. decode canceled.
+     */
+    DecodeOptions decodeOpts;
+    decodeOpts.cancelToken = std::make_shared<DecodeCancelToken>();
+    decodeOpts.cancelToken->Cancel();
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, ERR_IMAGE_DECODE_CANCELED);
+    ASSERT_EQ(pixelMap.get(), nullptr);
+    /**
+     * @tc.steps: step3. decode image source again with a new token.
+     * @tc.expected: step3. decode success.
+     */
+    decodeOpts.cancelToken = std::make_shared<DecodeCancelToken>();
+    pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    /**
+     * @tc.steps: step4. decode image source asynchronously and cancel the future at once.
+     * @tc.expected: step4. the decoding is either done or canceled.
+     */
+    DecodeOptions asyncOpts;
+    std::shared_ptr<PixelMapFuture> future = imageSource->CreatePixelMapAsync(asyncOpts, DecodePriority::LOW);
+    ASSERT_NE(future.get(), nullptr);
+    future->Cancel();
+    std::unique_ptr<PixelMap> asyncPixelMap = future->Get(errorCode);
+    ASSERT_EQ(errorCode == SUCCESS || errorCode == ERR_IMAGE_DECODE_CANCELED, true);
+    ASSERT_EQ(asyncPixelMap != nullptr, errorCode == SUCCESS);
+    /**
+     * @tc.steps: step5. decode asynchronously with a token of the caller, cancel the future, then destroy the
+     * source while its decoding is pending.
+     * @tc.expected: step5. the token of the caller is not canceled, a decoding with it still succeeds.
+     */
+    asyncOpts.cancelToken = std::make_shared<DecodeCancelToken>();
+    future = imageSource->CreatePixelMapAsync(asyncOpts, DecodePriority::LOW);
+    ASSERT_NE(future.get(), nullptr);
+    future->Cancel();
+    asyncPixelMap = future->Get(errorCode);
+    ASSERT_EQ(asyncOpts.cancelToken->IsCanceled(), false);
+    future = imageSource->CreatePixelMapAsync(asyncOpts, DecodePriority::LOW);
+    ASSERT_NE(future.get(), nullptr);
+    imageSource.reset();
+    asyncPixelMap = future->Get(errorCode);
+    ASSERT_EQ(asyncOpts.cancelToken->IsCanceled(), false);
+    imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_NE(imageSource.get(), nullptr);
+    pixelMap = imageSource->CreatePixelMap(asyncOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+}
+
+/**
+ * @tc.name: JpegImageDecode017
+ * @tc.desc: Decode jpeg and png images by the decoders kept from the destroyed image sources.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode017, TestSize.Level3)
+{
+    const std::vector<std::string> paths = { IMAGE_INPUT_JPEG_PATH, "/data/local/tmp/image/test.png" };
+    auto decodeFile = [](const std::string &path) {
+        uint32_t errorCode = 0;
+        SourceOptions opts;
+        std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(path, opts, errorCode);
+        if (imageSource == nullptr) {
+            return std::unique_ptr<PixelMap>();
+        }
+        DecodeOptions decodeOpts;
+        return imageSource->CreatePixelMap(decodeOpts, errorCode);
+    };
+    /**
+     * @tc.steps: step1. decode the images by new decoders.
+     * @tc.expected: step1. decode success.
+     */
+    ImageSource::SetDecoderPoolSize(0);
+    std::vector<std::unique_ptr<PixelMap>> expectedPixelMaps;
+    for (const auto &path : paths) {
+        expectedPixelMaps.push_back(decodeFile(path));
+        ASSERT_NE(expectedPixelMaps.back().get(), nullptr);
+    }
+    /**
+     * @tc.steps: step2. decode the images by new sources several times with the decoder pool enabled.
+     * @tc.expected: step2. each decoding by a reused decoder gets the same pixels.
+     */
+    ImageSource::SetDecoderPoolSize(1);
+    const uint32_t rounds = 3;
+    for (uint32_t round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < paths.size(); i++) {
+            std::unique_ptr<PixelMap> pixelMap = decodeFile(paths[i]);
+            ASSERT_NE(pixelMap.get(), nullptr);
+            ASSERT_EQ(pixelMap->IsSameImage(*expectedPixelMaps[i]), true);
+        }
+    }
+    /**
+     * @tc.steps: step3. release the idle decoders and decode again.
+     * @tc.expected: step3. decode success.
+     */
+    ImageSource::ReleaseIdleDecoders();
+    std::unique_ptr<PixelMap> pixelMap = decodeFile(paths[0]);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->IsSameImage(*expectedPixelMaps[0]), true);
+    ImageSource::SetDecoderPoolSize(DEFAULT_DECODER_POOL_SIZE);
+}
+
+/**
+ * @tc.name: JpegImageDecode018
+ * @tc.desc: Decode jpeg image from file path and fd with the data prefetched on a background thread.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode018, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. decode the image without prefetching.
+     * @tc.expected: step1. decode success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    DecodeOptions decodeOpts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    std::unique_ptr<PixelMap> expectedPixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(expectedPixelMap.get(), nullptr);
+    /**
+     * @tc.steps: step2. decode the image by file path twice with a ring smaller than the file.
+     * @tc.expected: step2. decode success and get the same pixels.
+     */
+    const uint32_t prefetchSize = 4096;
+    opts.prefetchSize = prefetchSize;
+    imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    for (uint32_t i = 0; i < 2; i++) {
+        std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(pixelMap.get(), nullptr);
+        ASSERT_EQ(pixelMap->IsSameImage(*expectedPixelMap), true);
+    }
+    /**
+     * @tc.steps: step3. decode the image by fd.
+     * @tc.expected: step3. decode success and get the same pixels.
+     */
+    int fd = open(IMAGE_INPUT_JPEG_PATH.c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+    imageSource = ImageSource::CreateImageSource(fd, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->IsSameImage(*expectedPixelMap), true);
+    /**
+     * @tc.steps: step4. peek and then read each part of a file larger than the ring, as the decoders do.
+     * @tc.expected: step4. the data is the file content, and all of it is read from the ring.
+     */
+    size_t fileSize = 0;
+    ASSERT_EQ(ImageUtils::GetFileSize(IMAGE_INPUT_RESTART_JPEG_PATH, fileSize), true);
+    std::vector<uint8_t> fileData(fileSize);
+    ASSERT_EQ(OHOS::ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_RESTART_JPEG_PATH, fileData.data(), fileSize),
+              true);
+    std::unique_ptr<FileSourceStream> stream = FileSourceStream::CreateSourceStream(IMAGE_INPUT_RESTART_JPEG_PATH);
+    ASSERT_NE(stream.get(), nullptr);
+    stream->SetPrefetchSize(prefetchSize);
+    stream->PrepareSequentialRead();
+    const uint32_t partSize = 300;  // not aligned to the blocks, so some parts span two blocks.
+    std::vector<uint8_t> peekData(partSize);
+    std::vector<uint8_t> readData(partSize);
+    for (size_t offset = 0; offset < fileSize; offset += partSize) {
+        uint32_t size = static_cast<uint32_t>(std::min(static_cast<size_t>(partSize), fileSize - offset));
+        uint32_t readSize = 0;
+        ASSERT_EQ(stream->Peek(size, peekData.data(), partSize, readSize), true);
+        ASSERT_EQ(readSize, size);
+        ASSERT_EQ(stream->Read(size, readData.data(), partSize, readSize), true);
+        ASSERT_EQ(readSize, size);
+        ASSERT_EQ(memcmp(peekData.data(), fileData.data() + offset, size), 0);
+        ASSERT_EQ(memcmp(readData.data(), fileData.data() + offset, size), 0);
+    }
+    ASSERT_EQ(stream->GetPrefetchMissCount(), 0u);
+}
+
+/**
+ * @tc.name: JpegImageDecode019
+ * @tc.desc: Decode jpeg image with restart markers in parallel bands from buffer and serially from file.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode019, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. decode the image from file path, which is decoded serially.
+     * @tc.expected: step1. decode success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    DecodeOptions decodeOpts;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(IMAGE_INPUT_RESTART_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    std::unique_ptr<PixelMap> serialPixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(serialPixelMap.get(), nullptr);
+    /**
+     * @tc.steps: step2. decode the image from buffer, whose bands are decoded in parallel.
+     * @tc.expected: step2. decode success and get the same pixels as the serial decoding.
+     */
+    size_t bufferSize = 0;
+    ASSERT_EQ(ImageUtils::GetFileSize(IMAGE_INPUT_RESTART_JPEG_PATH, bufferSize), true);
+    std::vector<uint8_t> buffer(bufferSize);
+    ASSERT_EQ(OHOS::ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_RESTART_JPEG_PATH, buffer.data(), bufferSize),
+              true);
+    imageSource = ImageSource::CreateImageSource(buffer.data(), bufferSize, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    std::unique_ptr<PixelMap> parallelPixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(parallelPixelMap.get(), nullptr);
+    ASSERT_EQ(parallelPixelMap->IsSameImage(*serialPixelMap), true);
+    /**
+     * @tc.steps: step3. decode the image from buffer on several threads at a time.
+     * @tc.expected: step3. the decodes which get no band thread decode serially, all get the same pixels.
+     */
+    const uint32_t threadCount = 4;
+    std::atomic<uint32_t> sameCount(0);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&buffer, &serialPixelMap, &sameCount]() {
+            uint32_t ret = 0;
+            SourceOptions sourceOpts;
+            std::unique_ptr<ImageSource> source =
+                ImageSource::CreateImageSource(buffer.data(), buffer.size(), sourceOpts, ret);
+            if (source == nullptr) {
+                return;
+            }
+            DecodeOptions options;
+            std::unique_ptr<PixelMap> pixelMap = source->CreatePixelMap(options, ret);
+            if (pixelMap != nullptr && pixelMap->IsSameImage(*serialPixelMap)) {
+                sameCount++;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(sameCount, threadCount);
+}
+
+/**
+ * @tc.name: JpegImageDecode020
+ * @tc.desc: Decode progressive jpeg image by incremental mode, the last scan is rendered before EOI arrives.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode020, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. insert a comment after the last scan of the progressive image, so the scan completes
+     * without EOI, and create an incremental image source.
+     * @tc.expected: step1. create image source success.
+     */
+    size_t fileSize = 0;
+    ASSERT_EQ(ImageUtils::GetFileSize(IMAGE_INPUT_PROGRESSIVE_JPEG_PATH, fileSize), true);
+    std::vector<uint8_t> data(fileSize);
+    ASSERT_EQ(OHOS::ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_PROGRESSIVE_JPEG_PATH, data.data(), fileSize), true);
+    const std::vector<uint8_t> eoi = { 0xFF, 0xD9 };
+    ASSERT_GT(data.size(), eoi.size());
+    ASSERT_EQ(std::equal(eoi.begin(), eoi.end(), data.end() - eoi.size()), true);
+    const std::vector<uint8_t> comment = { 0xFF, 0xFE, 0x00, 0x06, 't', 'e', 's', 't' };
+    data.insert(data.end() - eoi.size(), comment.begin(), comment.end());
+    uint32_t errorCode = 0;
+    IncrementalSourceOptions incOpts;
+    incOpts.incrementalMode = IncrementalMode::INCREMENTAL_DATA;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateIncrementalImageSource(incOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    std::unique_ptr<IncrementalPixelMap> incPixelMap = imageSource->CreateIncrementalPixelMap(0, decodeOpts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(incPixelMap.get(), nullptr);
+    /**
+     * @tc.steps: step2. update all the data but EOI and promote decoding.
+     * @tc.expected: step2. the last scan is rendered, the data is still incomplete.
+     */
+    uint32_t headSize = static_cast<uint32_t>(data.size() - eoi.size());
+    ASSERT_EQ(imageSource->UpdateData(data.data(), headSize, false), SUCCESS);
+    uint8_t decodeProgress = 0;
+    ASSERT_EQ(incPixelMap->PromoteDecoding(decodeProgress), ERR_IMAGE_SOURCE_DATA_INCOMPLETE);
+    uint32_t renderedScans = incPixelMap->GetDecodingStatus().renderedScans;
+    ASSERT_GT(renderedScans, 0u);
+    /**
+     * @tc.steps: step3. update EOI and promote decoding again.
+     * @tc.expected: step3. decode success without rendering any more scan.
+     */
+    ASSERT_EQ(imageSource->UpdateData(data.data() + headSize, eoi.size(), true), SUCCESS);
+    ASSERT_EQ(incPixelMap->PromoteDecoding(decodeProgress), SUCCESS);
+    const IncrementalDecodingStatus &status = incPixelMap->GetDecodingStatus();
+    ASSERT_EQ(status.decodingProgress, IncrementalDecodingStatus::FULL_PROGRESS);
+    ASSERT_EQ(status.renderedScans, renderedScans);
+}
+
+/**
+ * @tc.name: JpegImageDecode021
+ * @tc.desc: Cancel decoding by the decode listener after the header is decoded, then decode the same source again.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode021, TestSize.Level3)
+{
+    const std::vector<std::string> paths = {
+        IMAGE_INPUT_JPEG_PATH, "/data/local/tmp/image/test.png", "/data/local/tmp/image/test.gif",
+        "/data/local/tmp/image/test.webp"
+    };
+    size_t bufferSize = 0;
+    ASSERT_EQ(ImageUtils::GetFileSize(IMAGE_INPUT_RESTART_JPEG_PATH, bufferSize), true);
+    std::vector<uint8_t> buffer(bufferSize);
+    ASSERT_EQ(OHOS::ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_RESTART_JPEG_PATH, buffer.data(), bufferSize),
+              true);
+    std::vector<std::unique_ptr<ImageSource>> imageSources;
+    for (const auto &path : paths) {
+        uint32_t errorCode = 0;
+        SourceOptions opts;
+        imageSources.push_back(ImageSource::CreateImageSource(path, opts, errorCode));
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(imageSources.back().get(), nullptr);
+    }
+    // the jpeg image with restart markers from buffer is decoded by the parallel bands.
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    imageSources.push_back(ImageSource::CreateImageSource(buffer.data(), bufferSize, opts, errorCode));
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSources.back().get(), nullptr);
+
+    for (auto &imageSource : imageSources) {
+        /**
+         * @tc.steps: step1. decode image source with a listener which cancels the decoding once the header
+         * is decoded, so that the decoder stops in its decoding loop.
+         * @tc.expected: step1. decode canceled.
+         */
+        DecodeOptions decodeOpts;
+        decodeOpts.cancelToken = std::make_shared<DecodeCancelToken>();
+        CancelDecodeListener listener(decodeOpts.cancelToken);
+        imageSource->AddDecodeListener(&listener);
+        std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        imageSource->RemoveDecodeListener(&listener);
+        ASSERT_EQ(errorCode, ERR_IMAGE_DECODE_CANCELED);
+        ASSERT_EQ(pixelMap.get(), nullptr);
+        /**
+         * @tc.steps: step2. decode the same image source again with a new token.
+         * @tc.expected: step2. decode success.
+         */
+        decodeOpts.cancelToken = std::make_shared<DecodeCancelToken>();
+        pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(pixelMap.get(), nullptr);
+    }
+}
+
+/**
+ * @tc.name: JpegImageDecode022
+ * @tc.desc: Seek and peek the istream source stream across its read ahead window, and decode jpeg image from
+ *           istream with several read ahead sizes.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageDecode022, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create istream source stream of a known data with a small read ahead window.
+     * @tc.expected: step1. create success.
+     */
+    const uint32_t streamSize = 1000;
+    const uint32_t windowSize = 64;
+    const uint32_t modulus = 251;
+    std::string data(streamSize, '\0');
+    for (uint32_t i = 0; i < streamSize; i++) {
+        data[i] = static_cast<char>(i % modulus);
+    }
+    auto isSameData = [&data](uint32_t offset, const uint8_t *buffer, uint32_t size) {
+        return memcmp(data.data() + offset, buffer, size) == 0;
+    };
+    std::unique_ptr<IstreamSourceStream> stream =
+        IstreamSourceStream::CreateSourceStream(std::make_unique<std::stringstream>(data));
+    ASSERT_NE(stream.get(), nullptr);
+    stream->SetReadAheadSize(windowSize);
+    /**
+     * @tc.steps: step2. read the head, then peek the data across the end of the window.
+     * @tc.expected: step2. get the right data, and the peek doesn't move the position.
+     */
+    uint8_t buffer[streamSize] = { 0 };
+    uint32_t readSize = 0;
+    ASSERT_EQ(stream->Read(10, buffer, sizeof(buffer), readSize), true);
+    ASSERT_EQ(readSize, 10u);
+    ASSERT_EQ(isSameData(0, buffer, readSize), true);
+    ASSERT_EQ(stream->Peek(windowSize - 4, buffer, sizeof(buffer), readSize), true);
+    ASSERT_EQ(readSize, windowSize - 4);
+    ASSERT_EQ(isSameData(10, buffer, readSize), true);
+    ASSERT_EQ(stream->Tell(), 10u);
+    /**
+     * @tc.steps: step3. seek near the end of the window and peek across it by the data stream buffer.
+     * @tc.expected: step3. get the right data.
+     */
+    ASSERT_EQ(stream->Seek(windowSize + 4), true);
+    OHOS::ImagePlugin::DataStreamBuffer streamBuffer;
+    ASSERT_EQ(stream->Peek(windowSize, streamBuffer), true);
+    ASSERT_EQ(streamBuffer.dataSize, windowSize);
+    ASSERT_EQ(isSameData(windowSize + 4, streamBuffer.inputStreamBuffer, streamBuffer.dataSize), true);
+    /**
+     * @tc.steps: step4. seek back before the window and read across it, then seek far after it and read to the end.
+     * @tc.expected: step4. get the right data, and the read after the end fails.
+     */
+    ASSERT_EQ(stream->Seek(5), true);
+    ASSERT_EQ(stream->Read(windowSize + 10, buffer, sizeof(buffer), readSize), true);
+    ASSERT_EQ(readSize, windowSize + 10);
+    ASSERT_EQ(isSameData(5, buffer, readSize), true);
+    ASSERT_EQ(stream->Seek(streamSize - 20), true);
+    ASSERT_EQ(stream->Read(8, streamBuffer), true);
+    ASSERT_EQ(isSameData(streamSize - 20, streamBuffer.inputStreamBuffer, streamBuffer.dataSize), true);
+    ASSERT_EQ(stream->Read(windowSize, buffer, sizeof(buffer), readSize), true);
+    ASSERT_EQ(readSize, 12u);
+    ASSERT_EQ(isSameData(streamSize - 12, buffer, readSize), true);
+    ASSERT_EQ(stream->Tell(), streamSize);
+    ASSERT_EQ(stream->Read(1, buffer, sizeof(buffer), readSize), false);
+    /**
+     * @tc.steps: step5. decode jpeg image from istream with the default, a small and no read ahead window.
+     * @tc.expected: step5. decode success and get the same pixels.
+     */
+    std::unique_ptr<PixelMap> expectedPixelMap;
+    for (uint32_t readAheadSize : { SourceOptions::DEFAULT_READ_AHEAD_SIZE, windowSize, 0u }) {
+        std::unique_ptr<std::fstream> fs = std::make_unique<std::fstream>();
+        fs->open(IMAGE_INPUT_JPEG_PATH, std::fstream::binary | std::fstream::in);
+        ASSERT_EQ(fs->is_open(), true);
+        uint32_t errorCode = 0;
+        SourceOptions opts;
+        opts.readAheadSize = readAheadSize;
+        std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(std::move(fs), opts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(imageSource.get(), nullptr);
+        DecodeOptions decodeOpts;
+        std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(pixelMap.get(), nullptr);
+        if (expectedPixelMap == nullptr) {
+            expectedPixelMap = std::move(pixelMap);
+        } else {
+            ASSERT_EQ(pixelMap->IsSameImage(*expectedPixelMap), true);
+        }
+    }
+}
+
 /**
  * @tc.name: JpgImageCrop001
  * @tc.desc: Crop jpg image from istream source stream
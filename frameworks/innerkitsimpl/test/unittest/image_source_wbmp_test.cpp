@@ -336,4 +336,82 @@ HWTEST_F(ImageSourceWbmpTest, WbmpImageDecode010, TestSize.Level3)
     std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
     ASSERT_NE(errorCode, SUCCESS);
     ASSERT_EQ(pixelMap.get(), nullptr);
-}
\ No newline at end of file
+}
+/**
+ * @tc.name: WbmpImageDecode011
+ * @tc.desc: Decode wbmp image with sample size to ALPHA_8, and a known pattern to RGBA_8888 and ALPHA_8
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceWbmpTest, WbmpImageDecode011, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create image source by correct wbmp file path and wbmp format hit.
+     * @tc.expected: step1. create image source success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = "image/vnd.wap.wbmp";
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_WBMP_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    /**
+     * @tc.steps: step2. decode image source to pixel map with sample size 2 and ALPHA_8.
+     * @tc.expected: step2. decode image source to pixel map success and the size is halved.
+     */
+    DecodeOptions decodeOpts;
+    decodeOpts.sampleSize = 2;
+    decodeOpts.desiredPixelFormat = PixelFormat::ALPHA_8;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), 236);
+    ASSERT_EQ(pixelMap->GetHeight(), 37);
+    ASSERT_EQ(pixelMap->GetAlphaType(), AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
+    /**
+     * @tc.steps: step3. create image source by a 10x2 wbmp buffer, the bits of each row are 1011000001 and
+     * 0000000011, and decode it to RGBA_8888.
+     * @tc.expected: step3. white pixels are opaque white and black pixels are opaque black.
+     */
+    uint8_t patternData[] = { 0x00, 0x00, 0x0A, 0x02, 0xB0, 0x40, 0x00, 0xC0 };
+    const uint8_t patternBits[2][10] = { { 1, 0, 1, 1, 0, 0, 0, 0, 0, 1 }, { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1 } };
+    std::unique_ptr<ImageSource> patternSource = ImageSource::CreateImageSource(patternData, sizeof(patternData),
+        opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(patternSource.get(), nullptr);
+    DecodeOptions patternOpts;
+    patternOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    pixelMap = patternSource->CreatePixelMap(patternOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), 10);
+    ASSERT_EQ(pixelMap->GetHeight(), 2);
+    ASSERT_EQ(pixelMap->GetAlphaType(), AlphaType::IMAGE_ALPHA_TYPE_OPAQUE);
+    for (int32_t y = 0; y < 2; y++) {
+        for (int32_t x = 0; x < 10; x++) {
+            const uint8_t *pixel = pixelMap->GetPixel(x, y);
+            ASSERT_NE(pixel, nullptr);
+            uint8_t value = patternBits[y][x] ? 0xFF : 0x00;
+            ASSERT_EQ(pixel[0], value);
+            ASSERT_EQ(pixel[1], value);
+            ASSERT_EQ(pixel[2], value);
+            ASSERT_EQ(pixel[3], 0xFF);
+        }
+    }
+    /**
+     * @tc.steps: step4. decode the pattern to ALPHA_8.
+     * @tc.expected: step4. white pixels are opaque and black pixels are transparent.
+     */
+    patternOpts.desiredPixelFormat = PixelFormat::ALPHA_8;
+    pixelMap = patternSource->CreatePixelMap(patternOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetPixelFormat(), PixelFormat::ALPHA_8);
+    ASSERT_EQ(pixelMap->GetAlphaType(), AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
+    for (int32_t y = 0; y < 2; y++) {
+        for (int32_t x = 0; x < 10; x++) {
+            const uint8_t *pixel = pixelMap->GetPixel8(x, y);
+            ASSERT_NE(pixel, nullptr);
+            ASSERT_EQ(*pixel, patternBits[y][x] ? 0xFF : 0x00);
+        }
+    }
+}
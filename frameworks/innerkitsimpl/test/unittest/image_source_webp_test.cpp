@@ -495,6 +495,63 @@ HWTEST_F(ImageSourceWebpTest, WebpImageDecode010, TestSize.Level3)
     free(buffer);
 }
 
+/**
+ * @tc.name: WebpImageDecode011
+ * @tc.desc: Decode webp image from incremental source stream with the expected size of the data.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceWebpTest, WebpImageDecode011, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create image source by incremental source stream with the file size as the expected size.
+     * @tc.expected: step1. create image source success.
+     */
+    size_t bufferSize = 0;
+    bool fileRet = ImageUtils::GetFileSize(IMAGE_INPUT_WEBP_PATH, bufferSize);
+    ASSERT_EQ(fileRet, true);
+    uint8_t *buffer = (uint8_t *)malloc(bufferSize);
+    ASSERT_NE(buffer, nullptr);
+    fileRet = ReadFileToBuffer(IMAGE_INPUT_WEBP_PATH, buffer, bufferSize);
+    ASSERT_EQ(fileRet, true);
+    uint32_t errorCode = 0;
+    IncrementalSourceOptions incOpts;
+    incOpts.incrementalMode = IncrementalMode::INCREMENTAL_DATA;
+    incOpts.expectedSize = bufferSize;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateIncrementalImageSource(incOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    /**
+     * @tc.steps: step2. update incremental stream with small data size and promote decode every update.
+     * @tc.expected: step2. decode image source to pixel map success.
+     */
+    DecodeOptions decodeOpts;
+    std::unique_ptr<IncrementalPixelMap> incPixelMap = imageSource->CreateIncrementalPixelMap(0, decodeOpts, errorCode);
+    ASSERT_NE(incPixelMap.get(), nullptr);
+    uint32_t updateSize = 0;
+    while (updateSize < bufferSize) {
+        uint32_t updateOnceSize = std::min(bufferSize - updateSize, static_cast<size_t>(256));
+        bool isCompleted = (updateSize + updateOnceSize == bufferSize);
+        uint32_t ret = imageSource->UpdateData(buffer + updateSize, updateOnceSize, isCompleted);
+        ASSERT_EQ(ret, SUCCESS);
+        uint8_t decodeProgress = 0;
+        incPixelMap->PromoteDecoding(decodeProgress);
+        updateSize += updateOnceSize;
+    }
+    incPixelMap->DetachFromDecoding();
+    IncrementalDecodingStatus status = incPixelMap->GetDecodingStatus();
+    ASSERT_EQ(status.decodingProgress, 100);
+    /**
+     * @tc.steps: step3. decode the whole data by one-time mode.
+     * @tc.expected: step3. the size of the pixel map is the same as the incremental one.
+     */
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), incPixelMap->GetWidth());
+    ASSERT_EQ(pixelMap->GetHeight(), incPixelMap->GetHeight());
+    free(buffer);
+}
+
 /**
  * @tc.name: WebpImageCrop001
  * @tc.desc: Crop webp image from istream source stream
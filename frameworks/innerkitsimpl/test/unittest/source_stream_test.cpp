@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "buffer_source_stream.h"
+#include "directory_ex.h"
+#include "file_source_stream.h"
+#include "image_source.h"
+#include "incremental_source_stream.h"
+#include "istream_source_stream.h"
+#include "media_errors.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+static const std::string TEST_DIR = "/data/test/source_stream";
+static const std::string TEST_FILE_PATH = TEST_DIR + "/test_source_stream.dat";
+static constexpr uint32_t TEST_DATA_SIZE = 100;
+static constexpr uint32_t TEST_FULL_READ_SIZE = 40;
+static constexpr uint32_t TEST_CHUNK_SIZE = 30;
+
+class SourceStreamTest : public testing::Test {
+public:
+    SourceStreamTest() {}
+    ~SourceStreamTest() {}
+    void SetUp();
+    void TearDown();
+
+    static std::vector<uint8_t> MakeTestData();
+    // read into a buffer fully, then the rest by a short read, then nothing at the end of the data.
+    static void CheckReadInto(SourceStream &stream);
+};
+
+void SourceStreamTest::SetUp(void)
+{
+    OHOS::ForceRemoveDirectory(TEST_DIR);
+    OHOS::ForceCreateDirectory(TEST_DIR);
+}
+
+void SourceStreamTest::TearDown(void)
+{
+    OHOS::ForceRemoveDirectory(TEST_DIR);
+}
+
+std::vector<uint8_t> SourceStreamTest::MakeTestData()
+{
+    std::vector<uint8_t> data(TEST_DATA_SIZE);
+    for (uint32_t i = 0; i < TEST_DATA_SIZE; i++) {
+        data[i] = static_cast<uint8_t>(i + 1);
+    }
+    return data;
+}
+
+void SourceStreamTest::CheckReadInto(SourceStream &stream)
+{
+    const std::vector<uint8_t> data = MakeTestData();
+    std::vector<uint8_t> buffer(TEST_DATA_SIZE, 0);
+    uint32_t readSize = 0;
+    ASSERT_EQ(stream.ReadInto(buffer.data(), TEST_FULL_READ_SIZE, readSize), true);
+    ASSERT_EQ(readSize, TEST_FULL_READ_SIZE);
+    ASSERT_EQ(std::equal(data.begin(), data.begin() + TEST_FULL_READ_SIZE, buffer.begin()), true);
+    ASSERT_EQ(stream.Tell(), TEST_FULL_READ_SIZE);
+
+    ASSERT_EQ(stream.ReadInto(buffer.data(), TEST_DATA_SIZE, readSize), true);
+    ASSERT_EQ(readSize, TEST_DATA_SIZE - TEST_FULL_READ_SIZE);
+    ASSERT_EQ(std::equal(data.begin() + TEST_FULL_READ_SIZE, data.end(), buffer.begin()), true);
+    ASSERT_EQ(stream.Tell(), TEST_DATA_SIZE);
+
+    readSize = TEST_DATA_SIZE;
+    ASSERT_EQ(stream.ReadInto(buffer.data(), TEST_DATA_SIZE, readSize), true);
+    ASSERT_EQ(readSize, 0u);
+    ASSERT_EQ(stream.Tell(), TEST_DATA_SIZE);
+    ASSERT_EQ(stream.ReadInto(nullptr, TEST_DATA_SIZE, readSize), false);
+}
+
+/**
+ * @tc.name: SourceStreamReadInto001
+ * @tc.desc: Read a buffer source stream into the buffer of the caller.
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceStreamTest, SourceStreamReadInto001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create a buffer source stream.
+     * @tc.expected: step1. create the stream success.
+     */
+    const std::vector<uint8_t> data = MakeTestData();
+    std::unique_ptr<BufferSourceStream> stream = BufferSourceStream::CreateSourceStream(data.data(), data.size());
+    ASSERT_NE(stream.get(), nullptr);
+    /**
+     * @tc.steps: step2. read fully, then short, then at the end of the data.
+     * @tc.expected: step2. the data is read in order, nothing is read at the end without failure.
+     */
+    CheckReadInto(*stream);
+}
+
+/**
+ * @tc.name: SourceStreamReadInto002
+ * @tc.desc: Read a file source stream into the buffer of the caller.
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceStreamTest, SourceStreamReadInto002, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. write the test data to a file and create a file source stream of it.
+     * @tc.expected: step1. create the stream success.
+     */
+    const std::vector<uint8_t> data = MakeTestData();
+    {
+        std::ofstream file(TEST_FILE_PATH, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), data.size());
+        ASSERT_EQ(file.good(), true);
+    }
+    std::unique_ptr<FileSourceStream> stream = FileSourceStream::CreateSourceStream(TEST_FILE_PATH);
+    ASSERT_NE(stream.get(), nullptr);
+    /**
+     * @tc.steps: step2. read fully, then short, then at the end of the file.
+     * @tc.expected: step2. the data is read in order, nothing is read at the end without failure.
+     */
+    CheckReadInto(*stream);
+}
+
+/**
+ * @tc.name: SourceStreamReadInto003
+ * @tc.desc: Read an istream source stream into the buffer of the caller, by the read ahead window and without it.
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceStreamTest, SourceStreamReadInto003, TestSize.Level3)
+{
+    const std::vector<uint8_t> data = MakeTestData();
+    for (uint32_t readAheadSize : { SourceOptions::DEFAULT_READ_AHEAD_SIZE, 0u }) {
+        /**
+         * @tc.steps: step1. create an istream source stream of the test data.
+         * @tc.expected: step1. create the stream success.
+         */
+        std::unique_ptr<std::istream> input = std::make_unique<std::stringstream>(
+            std::string(data.begin(), data.end()));
+        std::unique_ptr<IstreamSourceStream> stream = IstreamSourceStream::CreateSourceStream(std::move(input));
+        ASSERT_NE(stream.get(), nullptr);
+        stream->SetReadAheadSize(readAheadSize);
+        /**
+         * @tc.steps: step2. read fully, then short, then at the end of the data.
+         * @tc.expected: step2. the data is read in order, nothing is read at the end without failure.
+         */
+        CheckReadInto(*stream);
+    }
+}
+
+/**
+ * @tc.name: SourceStreamReadInto004
+ * @tc.desc: Read an incremental source stream into the buffer of the caller across the updated chunks.
+ * @tc.type: FUNC
+ */
+HWTEST_F(SourceStreamTest, SourceStreamReadInto004, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create an incremental source stream and update the test data by chunks.
+     * @tc.expected: step1. update the data success.
+     */
+    const std::vector<uint8_t> data = MakeTestData();
+    std::unique_ptr<IncrementalSourceStream> stream =
+        IncrementalSourceStream::CreateSourceStream(IncrementalMode::INCREMENTAL_DATA);
+    ASSERT_NE(stream.get(), nullptr);
+    for (uint32_t offset = 0; offset < TEST_DATA_SIZE; offset += TEST_CHUNK_SIZE) {
+        uint32_t size = std::min(TEST_CHUNK_SIZE, TEST_DATA_SIZE - offset);
+        ASSERT_EQ(stream->UpdateData(data.data() + offset, size, offset + size == TEST_DATA_SIZE), SUCCESS);
+    }
+    /**
+     * @tc.steps: step2. read fully, then short, then at the end of the data.
+     * @tc.expected: step2. the data is read in order, nothing is read at the end without failure.
+     */
+    CheckReadInto(*stream);
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_napi_executor.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <uv.h>
+#include <vector>
+#include "decode_task_pool.h"
+#include "hilog/log.h"
+#include "log_tags.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "ImageNapiExecutor" };
+}
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+using namespace HiviewDFX;
+
+// posted by the decode threads, either completed on the js thread or released if the env is gone.
+struct Completion {
+    function<void()> complete;
+    function<void()> release;
+};
+
+// completions posted by the decode threads and called on the js thread of an env.
+class CompletionQueue {
+public:
+    explicit CompletionQueue(napi_env env) : env_(env) {}
+    ~CompletionQueue() = default;
+    bool Init(const shared_ptr<CompletionQueue> &self);
+    // called on the js thread for each task, whose completion is expected later.
+    void AddOutstanding();
+    void Post(Completion &&completion);
+
+private:
+    static void OnAsync(uv_async_t *handle);
+    static void OnEnvCleanup(void *arg);
+    void Drain();
+
+    napi_env env_ = nullptr;
+    uv_async_t *handle_ = nullptr;
+    size_t outstandingCount_ = 0;  // only used on the js thread.
+    mutex mutex_;
+    vector<Completion> completions_;
+    bool isClosed_ = false;
+};
+
+// the envs of a js thread are only used on that thread, a thread may have several envs.
+static thread_local map<napi_env, shared_ptr<CompletionQueue>> g_completionQueues;
+
+bool CompletionQueue::Init(const shared_ptr<CompletionQueue> &self)
+{
+    uv_loop_s *loop = nullptr;
+    if (napi_get_uv_event_loop(env_, &loop) != napi_ok || loop == nullptr) {
+        HiLog::Error(LABEL, "get uv event loop failed.");
+        return false;
+    }
+    handle_ = new (std::nothrow) uv_async_t;
+    if (handle_ == nullptr) {
+        HiLog::Error(LABEL, "create uv async handle failed.");
+        return false;
+    }
+    // the handle keeps the queue alive until it is closed.
+    handle_->data = new (std::nothrow) shared_ptr<CompletionQueue>(self);
+    if (handle_->data == nullptr || uv_async_init(loop, handle_, OnAsync) != 0) {
+        HiLog::Error(LABEL, "init uv async handle failed.");
+        delete static_cast<shared_ptr<CompletionQueue> *>(handle_->data);
+        delete handle_;
+        handle_ = nullptr;
+        return false;
+    }
+    // the handle keeps the loop alive only when there are outstanding tasks.
+    uv_unref(reinterpret_cast<uv_handle_t *>(handle_));
+    napi_add_env_cleanup_hook(env_, OnEnvCleanup, handle_);
+    return true;
+}
+
+void CompletionQueue::AddOutstanding()
+{
+    if (outstandingCount_++ == 0) {
+        uv_ref(reinterpret_cast<uv_handle_t *>(handle_));
+    }
+}
+
+void CompletionQueue::Post(Completion &&completion)
+{
+    {
+        lock_guard<mutex> guard(mutex_);
+        if (!isClosed_) {
+            completions_.push_back(move(completion));
+            uv_async_send(handle_);
+            return;
+        }
+    }
+    HiLog::Error(LABEL, "the env is gone, release the completion.");
+    completion.release();
+}
+
+void CompletionQueue::OnAsync(uv_async_t *handle)
+{
+    auto queue = static_cast<shared_ptr<CompletionQueue> *>(handle->data);
+    if (queue != nullptr && *queue != nullptr) {
+        (*queue)->Drain();
+    }
+}
+
+void CompletionQueue::Drain()
+{
+    vector<Completion> completions;
+    {
+        lock_guard<mutex> guard(mutex_);
+        completions.swap(completions_);
+    }
+    for (auto &completion : completions) {
+        // called outside any napi callback, so a handle scope is needed.
+        napi_handle_scope scope = nullptr;
+        napi_open_handle_scope(env_, &scope);
+        completion.complete();
+        if (scope != nullptr) {
+            napi_close_handle_scope(env_, scope);
+        }
+        if (outstandingCount_ > 0 && --outstandingCount_ == 0) {
+            uv_unref(reinterpret_cast<uv_handle_t *>(handle_));
+        }
+    }
+}
+
+void CompletionQueue::OnEnvCleanup(void *arg)
+{
+    auto handle = static_cast<uv_async_t *>(arg);
+    auto queue = static_cast<shared_ptr<CompletionQueue> *>(handle->data);
+    vector<Completion> completions;
+    {
+        lock_guard<mutex> guard((*queue)->mutex_);
+        (*queue)->isClosed_ = true;
+        completions.swap((*queue)->completions_);
+    }
+    // no js can be called any more, the completions posted later are released by Post.
+    for (auto &completion : completions) {
+        completion.release();
+    }
+    g_completionQueues.erase((*queue)->env_);
+    uv_close(reinterpret_cast<uv_handle_t *>(handle), [](uv_handle_t *closedHandle) {
+        delete static_cast<shared_ptr<CompletionQueue> *>(closedHandle->data);
+        delete reinterpret_cast<uv_async_t *>(closedHandle);
+    });
+}
+
+static shared_ptr<CompletionQueue> GetCompletionQueue(napi_env env)
+{
+    auto iter = g_completionQueues.find(env);
+    if (iter != g_completionQueues.end()) {
+        return iter->second;
+    }
+    auto queue = make_shared<CompletionQueue>(env);
+    if (!queue->Init(queue)) {
+        return nullptr;
+    }
+    g_completionQueues.emplace(env, queue);
+    return queue;
+}
+
+napi_status ImageNapiExecutor::Submit(napi_env env, napi_async_execute_callback execute,
+                                      napi_async_complete_callback complete, void *data, DecodePriority priority,
+                                      const void *owner, ReleaseCallback release)
+{
+    if (execute == nullptr || complete == nullptr || release == nullptr) {
+        return napi_invalid_arg;
+    }
+    shared_ptr<CompletionQueue> queue = GetCompletionQueue(env);
+    if (queue == nullptr) {
+        return napi_generic_failure;
+    }
+    queue->AddOutstanding();
+    DecodeTask task;
+    task.priority = priority;
+    task.owner = owner;
+    task.run = [queue, env, execute, complete, release, data]() {
+        execute(env, data);
+        queue->Post({ [env, complete, data]() { complete(env, napi_ok, data); },
+            [release, data]() { release(data); } });
+    };
+    task.cancel = [queue, env, complete, release, data]() {
+        queue->Post({ [env, complete, data]() { complete(env, napi_cancelled, data); },
+            [release, data]() { release(data); } });
+    };
+    DecodeTaskPool::GetInstance().Submit(move(task));
+    return napi_ok;
+}
+
+void ImageNapiExecutor::CancelTasks(const void *owner)
+{
+    DecodeTaskPool::GetInstance().CancelTasks(owner);
+}
+} // namespace Media
+} // namespace OHOS
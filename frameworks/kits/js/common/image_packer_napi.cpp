@@ -16,6 +16,7 @@
 #include "image_packer_napi.h"
 #include "hilog/log.h"
 #include "media_errors.h"
+#include "image_napi_executor.h"
 #include "image_napi_utils.h"
 #include "image_packer.h"
 #include "image_source.h"
@@ -73,6 +74,7 @@ ImagePackerNapi::ImagePackerNapi()
 
 ImagePackerNapi::~ImagePackerNapi()
 {
+    ImageNapiExecutor::CancelTasks(this);
     if (wrapper_ != nullptr) {
         napi_delete_reference(env_, wrapper_);
     }
@@ -108,7 +110,9 @@ static void CommonCallbackRoutine(napi_env env, ImagePackerAsyncContext* &connec
         napi_delete_reference(env, connect->callbackRef);
     }
 
-    napi_delete_async_work(env, connect->work);
+    if (connect->work != nullptr) {
+        napi_delete_async_work(env, connect->work);
+    }
 
     delete connect;
     connect = nullptr;
@@ -173,8 +177,12 @@ STATIC_COMPLETE_FUNC(Packing)
     napi_get_undefined(env, &result);
     auto context = static_cast<ImagePackerAsyncContext*>(data);
 
-    if (!ImageNapiUtils::CreateArrayBuffer(env, context->resultBuffer,
-                                           context->packedSize, &result)) {
+    if (status == napi_cancelled) {
+        HiLog::Debug(LABEL, "Packing canceled");
+        context->status = ERROR;
+        napi_create_string_utf8(env, "Packing canceled", NAPI_AUTO_LENGTH, &(context->errorMsg));
+    } else if (!ImageNapiUtils::CreateArrayBuffer(env, context->resultBuffer,
+                                                  context->packedSize, &result)) {
         context->status = ERROR;
         HiLog::Error(LABEL, "napi_create_arraybuffer failed!");
         napi_get_undefined(env, &result);
@@ -502,11 +510,11 @@ napi_value ImagePackerNapi::Packing(napi_env env, napi_callback_info info)
         IMG_CREATE_CREATE_ASYNC_WORK(env, status, "PackingError",
             [](napi_env env, void *data) {}, PackingErrorComplete, asyncContext, asyncContext->work);
     } else if (packType == TYPE_IMAGE_SOURCE) {
-        IMG_CREATE_CREATE_ASYNC_WORK(env, status, "Packing",
-            PackingExec, PackingComplete, asyncContext, asyncContext->work);
+        IMG_CREATE_EXECUTOR_WORK(env, status, PackingExec, PackingComplete, asyncContext,
+            DecodePriority::NORMAL, asyncContext->constructor_);
     } else {
-        IMG_CREATE_CREATE_ASYNC_WORK(env, status, "PackingFromPixelMap",
-            PackingFromPixelMapExec, PackingComplete, asyncContext, asyncContext->work);
+        IMG_CREATE_EXECUTOR_WORK(env, status, PackingFromPixelMapExec, PackingComplete, asyncContext,
+            DecodePriority::NORMAL, asyncContext->constructor_);
     }
 
     IMG_NAPI_CHECK_RET_D(IMG_IS_OK(status),
@@ -557,8 +565,8 @@ napi_value ImagePackerNapi::PackingFromPixelMap(napi_env env, napi_callback_info
         napi_get_undefined(env, &result);
     }
 
-    IMG_CREATE_CREATE_ASYNC_WORK(env, status, "PackingFromPixelMap",
-        PackingFromPixelMapExec, PackingComplete, asyncContext, asyncContext->work);
+    IMG_CREATE_EXECUTOR_WORK(env, status, PackingFromPixelMapExec, PackingComplete, asyncContext,
+        DecodePriority::NORMAL, asyncContext->constructor_);
 
     IMG_NAPI_CHECK_RET_D(IMG_IS_OK(status),
         nullptr, HiLog::Error(LABEL, "fail to create async work"));
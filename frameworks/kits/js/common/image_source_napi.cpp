@@ -16,6 +16,7 @@
 #include "image_source_napi.h"
 #include <fcntl.h>
 #include "hilog/log.h"
+#include "image_napi_executor.h"
 #include "image_napi_utils.h"
 #include "media_errors.h"
 #include "string_ex.h"
@@ -71,6 +72,7 @@ struct ImageSourceAsyncContext {
     uint32_t index = 0;
     ImageInfo imageInfo;
     DecodeOptions decodeOpts;
+    DecodePriority priority = DecodePriority::NORMAL;
     std::shared_ptr<ImageSource> rImageSource;
     std::shared_ptr<PixelMap> rPixelMap;
     napi_value error = nullptr;
@@ -131,7 +133,9 @@ static void ImageSourceCallbackRoutine(napi_env env, ImageSourceAsyncContext* &c
         napi_delete_reference(env, context->callbackRef);
     }
 
-    napi_delete_async_work(env, context->work);
+    if (context->work != nullptr) {
+        napi_delete_async_work(env, context->work);
+    }
 
     delete context;
     context = nullptr;
@@ -145,6 +149,13 @@ ImageSourceNapi::ImageSourceNapi()
 
 ImageSourceNapi::~ImageSourceNapi()
 {
+    // the decodings of a released source are not needed any more. the destructor is called explicitly on
+    // release and again on finalize, so the token is dropped here like the native image source.
+    if (cancelToken_ != nullptr) {
+        cancelToken_->Cancel();
+        cancelToken_ = nullptr;
+    }
+    ImageNapiExecutor::CancelTasks(this);
     if (nativeImgSrc != nullptr) {
         nativeImgSrc = nullptr;
     }
@@ -397,6 +408,20 @@ static PixelFormat ParsePixlForamt(int32_t val)
     return PixelFormat::UNKNOWN;
 }
 
+static void ParseDecodePriority(napi_env env, napi_value root, DecodePriority* priority)
+{
+    uint32_t tmpNumber = 0;
+    if (!GET_UINT32_BY_NAME(root, "priority", tmpNumber)) {
+        HiLog::Debug(LABEL, "no priority");
+        return;
+    }
+    if (tmpNumber > static_cast<uint32_t>(DecodePriority::HIGH)) {
+        HiLog::Debug(LABEL, "Invalid priority %{public}u", tmpNumber);
+        return;
+    }
+    *priority = static_cast<DecodePriority>(tmpNumber);
+}
+
 static bool ParseDecodeOptions(napi_env env, napi_value root, DecodeOptions* opts, uint32_t* pIndex, napi_value* error)
 {
     uint32_t tmpNumber = 0;
@@ -712,6 +737,11 @@ static void CreatePixelMapComplete(napi_env env, napi_status status, void *data)
     napi_value result = nullptr;
     auto context = static_cast<ImageSourceAsyncContext*>(data);
 
+    if (status == napi_cancelled) {
+        HiLog::Debug(LABEL, "CreatePixelMap canceled");
+        context->status = ERR_IMAGE_DECODE_CANCELED;
+        napi_create_string_utf8(env, "Decoding canceled", NAPI_AUTO_LENGTH, &(context->error));
+    }
     if (context->status == SUCCESS) {
         result = PixelMapNapi::CreatePixelMap(env, context->rPixelMap);
     } else {
@@ -756,6 +786,7 @@ napi_value ImageSourceNapi::CreatePixelMap(napi_env env, napi_callback_info info
                                     &(asyncContext->index), &(asyncContext->error))) {
                 HiLog::Error(LABEL, "DecodeOptions mismatch");
             }
+            ParseDecodePriority(env, argValue[NUM_0], &(asyncContext->priority));
 
         }
         if (ImageNapiUtils::getType(env, argValue[argCount - 1]) == napi_function) {
@@ -771,9 +802,10 @@ napi_value ImageSourceNapi::CreatePixelMap(napi_env env, napi_callback_info info
         napi_get_undefined(env, &result);
     }
 
+    asyncContext->decodeOpts.cancelToken = imageSourceNapi->cancelToken_;
     ImageNapiUtils::HicheckerReport();
-    IMG_CREATE_CREATE_ASYNC_WORK(env, status, "CreatePixelMap", CreatePixelMapExecute,
-        CreatePixelMapComplete, asyncContext, asyncContext->work);
+    IMG_CREATE_EXECUTOR_WORK(env, status, CreatePixelMapExecute, CreatePixelMapComplete, asyncContext,
+        asyncContext->priority, asyncContext->constructor_);
 
     IMG_NAPI_CHECK_RET_D(IMG_IS_OK(status),
         nullptr, HiLog::Error(LABEL, "fail to create async work"));
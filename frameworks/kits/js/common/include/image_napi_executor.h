@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IMAGE_NAPI_EXECUTOR_H
+#define IMAGE_NAPI_EXECUTOR_H
+
+#include <cstdint>
+#include "image_type.h"
+#include "napi/native_api.h"
+#include "napi/native_node_api.h"
+
+// same as IMG_CREATE_CREATE_ASYNC_WORK, but the execute part runs on the decode threads of the library.
+#define IMG_CREATE_EXECUTOR_WORK(env, status, exec, complete, aContext, priority, owner) \
+do \
+{ \
+    (status) = ImageNapiExecutor::Submit((env), (exec), (complete), static_cast<void*>((aContext).get()), \
+        (priority), (owner), [](void *data) { delete static_cast<decltype((aContext).get())>(data); }); \
+    if ((status) == napi_ok) { \
+        (aContext).release(); \
+    } \
+} while (0)
+
+namespace OHOS {
+namespace Media {
+// runs the heavy part of the js async calls on the decode threads of the library instead of the libuv thread
+// pool, so decoding bursts don't starve the file io of other modules, and the visible images go first.
+// the complete part is called on the js thread, with napi_cancelled if the execute part is canceled.
+// if the env is cleaned up before that, the complete part is not called and the data is released instead.
+class ImageNapiExecutor {
+public:
+    using ReleaseCallback = void (*)(void *data);
+    static napi_status Submit(napi_env env, napi_async_execute_callback execute,
+                              napi_async_complete_callback complete, void *data, DecodePriority priority,
+                              const void *owner, ReleaseCallback release);
+    // cancel the pending tasks of the owner, their complete parts are called later on the js thread.
+    static void CancelTasks(const void *owner);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // IMAGE_NAPI_EXECUTOR_H
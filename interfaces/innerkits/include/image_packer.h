@@ -52,6 +52,18 @@ struct PackOption {
      * Hint to how many images will be packed into the image file.
      */
     uint32_t numberHint = 1;
+
+    /**
+     * Pack to a temporary file, which replaces the file of the path when the packing is finalized successfully,
+     * so the file is either the old one or complete. Only for packing to a file path.
+     */
+    bool isAtomic = false;
+
+    /**
+     * The small writes to a file are combined into a buffer of this size, 0 writes each of them to the file.
+     */
+    static constexpr uint32_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+    uint32_t bufferSize = DEFAULT_BUFFER_SIZE;
 };
 
 class PackerStream;
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IMAGE_PROBE_H
+#define IMAGE_PROBE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "image_type.h"
+#include "media_errors.h"
+
+namespace OHOS {
+namespace Media {
+struct ImageProbeInfo {
+    uint32_t errorCode = ERR_IMAGE_SOURCE_UNRESOLVED;
+    std::string encodedFormat;
+    Size size;
+    // EXIF orientation tag value, 1 (top-left) if the image has no orientation.
+    int32_t orientation = 1;
+    uint32_t frameCount = 1;
+};
+
+struct ImageProbeBuffer {
+    const uint8_t *data = nullptr;
+    uint32_t size = 0;
+};
+
+// reads the basic information of images from their headers only, no ImageSource, decoder plugin or pixel buffer
+// is created. jpeg, png, gif, webp, bmp, wbmp and heif are supported, other formats need an ImageSource.
+// counting gif frames walks all blocks of the file, the other formats only read a few header bytes.
+class ImageProbe {
+public:
+    NATIVEEXPORT static uint32_t Probe(const uint8_t *data, uint32_t size, ImageProbeInfo &info);
+    NATIVEEXPORT static uint32_t Probe(const std::string &pathName, ImageProbeInfo &info);
+    // the fd is read from its current position and is not closed, its position is restored.
+    NATIVEEXPORT static uint32_t Probe(const int fd, ImageProbeInfo &info);
+    // batch probes, the result of each source is returned in the same order, check errorCode of each one.
+    NATIVEEXPORT static std::vector<ImageProbeInfo> Probe(const std::vector<std::string> &pathNames);
+    NATIVEEXPORT static std::vector<ImageProbeInfo> Probe(const std::vector<int> &fds);
+    NATIVEEXPORT static std::vector<ImageProbeInfo> Probe(const std::vector<ImageProbeBuffer> &buffers);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // IMAGE_PROBE_H
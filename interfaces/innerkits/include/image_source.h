@@ -16,18 +16,22 @@
 #ifndef IMAGE_SOURCE_H
 #define IMAGE_SOURCE_H
 
+#include <condition_variable>
 #include <cstdint>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "decode_listener.h"
 #include "image_type.h"
 #include "incremental_pixel_map.h"
 #include "peer_listener.h"
 #include "pixel_map.h"
+#include "pixel_map_future.h"
 
 namespace OHOS {
 namespace MultimediaPlugin {
@@ -43,6 +47,7 @@ class AbsImageFormatAgent;
 class AbsImageDecoder;
 struct PixelDecodeOptions;
 struct PlImageInfo;
+struct DataStreamBuffer;
 } // namespace ImagePlugin
 } // namespace OHOS
 
@@ -51,11 +56,20 @@ namespace Media {
 struct SourceOptions {
     std::string formatHint;
     int32_t baseDensity = 0;
+    // the size of the data read ahead of the decoder on a background thread for the sources of file path or fd,
+    // so that decoding overlaps with the file io on slow storage. 0 disables it.
+    uint32_t prefetchSize = 0;
+    // the size of the data read at least from the input stream at a time for the sources of istream, which serves
+    // the following small reads and peeks of the decoder from memory. 0 disables it.
+    static constexpr uint32_t DEFAULT_READ_AHEAD_SIZE = 16 * 1024;
+    uint32_t readAheadSize = DEFAULT_READ_AHEAD_SIZE;
 };
 
 struct IncrementalSourceOptions {
     SourceOptions sourceOptions;
     IncrementalMode incrementalMode = IncrementalMode::FULL_DATA;
+    // the total size of the data if known, 0 if unknown. the data is then copied once into a reserved buffer.
+    uint32_t expectedSize = 0;
 };
 
 struct NinePatchInfo {
@@ -117,10 +131,17 @@ struct IncrementalDecodingContext {
     std::unique_ptr<ImagePlugin::AbsImageDecoder> decoder;
     ImageDecodingState IncrementalState = ImageDecodingState::UNRESOLVED;
     uint8_t decodingProgress = 0;
+    uint32_t renderedScans = 0;
 };
 
 class SourceStream;
 
+// a decoder reading its own view of the source data, so that it can decode without holding the source lock.
+struct PooledDecoder {
+    std::unique_ptr<SourceStream> stream;
+    std::unique_ptr<ImagePlugin::AbsImageDecoder> decoder;
+};
+
 class ImageSource {
 public:
     ~ImageSource();
@@ -140,8 +161,44 @@ public:
     {
         return CreatePixelMap(0, opts, errorCode);
     }
+    // a decoding with opts.cancelToken stops with ERR_IMAGE_DECODE_CANCELED once the token is canceled.
     NATIVEEXPORT std::unique_ptr<PixelMap> CreatePixelMap(uint32_t index, const DecodeOptions &opts,
                                                           uint32_t &errorCode);
+    // decode on the decode threads of the library, tasks of higher priority run first.
+    // the decodings are canceled with ERR_IMAGE_DECODE_CANCELED by PixelMapFuture::Cancel or when the source is
+    // destroyed.
+    NATIVEEXPORT std::shared_ptr<PixelMapFuture> CreatePixelMapAsync(const DecodeOptions &opts,
+                                                                     DecodePriority priority,
+                                                                     DecodeCompleteCallback callback = nullptr)
+    {
+        return CreatePixelMapAsync(0, opts, priority, std::move(callback));
+    }
+    NATIVEEXPORT std::shared_ptr<PixelMapFuture> CreatePixelMapAsync(uint32_t index, const DecodeOptions &opts,
+                                                                     DecodePriority priority,
+                                                                     DecodeCompleteCallback callback = nullptr);
+    // decode the images of indices in one call, the result i is the image of indices[i], or nullptr with the
+    // error in errorCodes[i]. the images are decoded in ascending index order with one decoder, so the frames of
+    // an animated image are composited in one forward pass instead of from the first frame for each index.
+    NATIVEEXPORT std::vector<std::unique_ptr<PixelMap>> CreatePixelMaps(const std::vector<uint32_t> &indices,
+                                                                        const DecodeOptions &opts,
+                                                                        std::vector<uint32_t> &errorCodes);
+    // decode the first image of each source, the sources are decoded on the decode threads and the caller thread
+    // at the same time. the result i is the image of sources[i], or nullptr with the error in errorCodes[i].
+    NATIVEEXPORT static std::vector<std::unique_ptr<PixelMap>> CreatePixelMaps(
+        const std::vector<ImageSource *> &sources, const DecodeOptions &opts, std::vector<uint32_t> &errorCodes);
+    // the decoders of destroyed sources are kept for the new sources of the same format, at most count for each
+    // format. 0 disables it.
+    NATIVEEXPORT static void SetDecoderPoolSize(uint32_t count);
+    // destroy the kept decoders and their buffers, such as on memory pressure.
+    NATIVEEXPORT static void ReleaseIdleDecoders();
+    // load the decoder plugins of the encoded formats on a background thread, such as during the splash screen,
+    // so the first decoding of each format doesn't pay for loading its plugin.
+    NATIVEEXPORT static uint32_t WarmUpDecoders(const std::vector<std::string> &formats);
+    // wait for the decoder plugins requested by WarmUpDecoders, return false if they are not ready in timeoutMs.
+    NATIVEEXPORT static bool WaitDecodersReady(uint32_t timeoutMs);
+    // the number of decodings running at the same time on the decode threads, which are shared by
+    // CreatePixelMapAsync and the js bindings.
+    NATIVEEXPORT static void SetAsyncDecodeThreads(uint32_t count);
     NATIVEEXPORT std::unique_ptr<IncrementalPixelMap> CreateIncrementalPixelMap(uint32_t index,
                                                                                 const DecodeOptions &opts,
                                                                                 uint32_t &errorCode);
@@ -177,17 +234,27 @@ private:
     using FormatAgentMap = std::map<std::string, ImagePlugin::AbsImageFormatAgent *>;
     using ImageStatusMap = std::map<uint32_t, ImageDecodingStatus>;
     using IncrementalRecordMap = std::map<PixelMap *, IncrementalDecodingContext>;
+    // candidate format agents indexed by the leading byte of the source.
+    using FormatDispatchTable = std::vector<std::vector<FormatAgentMap::iterator>>;
     ImageSource(std::unique_ptr<SourceStream> &&stream, const SourceOptions &opts);
-    uint32_t CheckEncodedFormat(ImagePlugin::AbsImageFormatAgent &agent);
+    uint32_t PeekFormatHeader(ImagePlugin::DataStreamBuffer &header);
+    uint32_t CheckEncodedFormat(ImagePlugin::AbsImageFormatAgent &agent, const ImagePlugin::DataStreamBuffer &header);
     static FormatAgentMap InitClass();
+    static FormatDispatchTable InitDispatchTable();
+    static uint32_t InitMaxHeaderSize();
     uint32_t GetEncodedFormat(const std::string &formatHint, std::string &format);
     uint32_t DecodeImageInfo(uint32_t index, ImageStatusMap::iterator &iter);
     uint32_t DecodeSourceInfo(bool isAcquiredImageNum);
     uint32_t InitMainDecoder();
     ImagePlugin::AbsImageDecoder *CreateDecoder(uint32_t &errorCode);
+    bool AcquirePooledDecoder(PooledDecoder &pooledDecoder);
+    void ReleasePooledDecoder(PooledDecoder &pooledDecoder);
+    void RecycleDecoders();
+    bool IsSkiaSampleDecode();
     void CopyOptionsToPlugin(const DecodeOptions &opts, ImagePlugin::PixelDecodeOptions &plOpts);
     void CopyOptionsToProcOpts(const DecodeOptions &opts, DecodeOptions &procOpts, PixelMap &pixelMap);
-    uint32_t CheckFormatHint(const std::string &formatHint, FormatAgentMap::iterator &formatIter);
+    uint32_t CheckFormatHint(const std::string &formatHint, const ImagePlugin::DataStreamBuffer &header,
+                             FormatAgentMap::iterator &formatIter);
     uint32_t GetSourceInfo();
     uint32_t OnSourceRecognized(bool isAcquiredImageNum);
     uint32_t OnSourceUnresolved();
@@ -197,7 +264,7 @@ private:
     // declare friend class, only IncrementalPixelMap can call PromoteDecoding function.
     friend class IncrementalPixelMap;
     uint32_t PromoteDecoding(uint32_t index, const DecodeOptions &opts, PixelMap &pixelMap, ImageDecodingState &state,
-                             uint8_t &decodeProgress);
+                             uint8_t &decodeProgress, uint32_t &renderedScans);
     void DetachIncrementalDecoding(PixelMap &pixelMap);
     ImageStatusMap::iterator GetValidImageStatus(uint32_t index, uint32_t &errorCode);
     uint32_t AddIncrementalContext(PixelMap &pixelMap, IncrementalRecordMap::iterator &iterator);
@@ -210,11 +277,17 @@ private:
     bool ImageSizeChange(int32_t width, int32_t height, int32_t desiredWidth, int32_t desiredHeight);
     bool ImageConverChange(const Rect &cropRect, ImageInfo &dstImageInfo, ImageInfo &srcImageInfo);
     void Reset();
+    bool BuildCacheKey(uint32_t index, const DecodeOptions &opts, std::string &key);
+    std::unique_ptr<PixelMap> CreatePixelMapFromCache(const std::string &key, const DecodeOptions &opts);
+    void AddPixelMapToCache(const std::string &key, PixelMap &pixelMap);
+    void OnAsyncTaskDone(const std::shared_ptr<DecodeCancelToken> &cancelToken);
 
     const std::string NINE_PATCH = "ninepatch";
     const std::string SKIA_DECODER = "SKIA_DECODER";
     static MultimediaPlugin::PluginServer &pluginServer_;
     static FormatAgentMap formatAgentMap_;
+    static FormatDispatchTable formatDispatchTable_;
+    static uint32_t maxHeaderSize_;
     std::unique_ptr<SourceStream> sourceStreamPtr_;
     SourceDecodingState decodeState_ = SourceDecodingState::UNRESOLVED;
     SourceInfo sourceInfo_;
@@ -224,6 +297,8 @@ private:
     // The main decoder is responsible for ordinary decoding (non-Incremental decoding),
     // as well as decoding SourceInfo and ImageInfo.
     std::unique_ptr<ImagePlugin::AbsImageDecoder> mainDecoder_;
+    // idle decoders of ordinary decoding, each reads an independent view of sourceStreamPtr_.
+    std::vector<PooledDecoder> decoderPool_;
     DecodeOptions opts_;
     std::set<PeerListener *> listeners_;
     DecodeEvent decodeEvent_ = DecodeEvent::EVENT_COMPLETE_DECODE;
@@ -231,9 +306,15 @@ private:
     std::set<DecodeListener *> decodeListeners_;
     std::mutex listenerMutex_;
     std::mutex decodingMutex_;
+    // cancel tokens of the decoding tasks submitted by CreatePixelMapAsync which are not done.
+    std::mutex asyncTaskMutex_;
+    std::condition_variable asyncTaskCond_;
+    std::multiset<std::shared_ptr<DecodeCancelToken>> asyncTaskTokens_;
     bool isIncrementalSource_ = false;
     bool isIncrementalCompleted_ = false;
     MemoryUsagePreference preference_ = MemoryUsagePreference::DEFAULT;
+    // identity of the source data in PixelMapCache keys, empty if the source can't be cached.
+    std::string sourceId_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -16,7 +16,9 @@
 #ifndef IMAGE_TYPE_H
 #define IMAGE_TYPE_H
 
+#include <atomic>
 #include <inttypes.h>
+#include <memory>
 
 namespace OHOS {
 namespace Media {
@@ -121,6 +123,12 @@ enum class MemoryUsagePreference : int32_t {
     LOW_RAM = 1,  // low memory
 };
 
+enum class DecodePriority : int32_t {
+    LOW = 0,     // prefetch
+    NORMAL = 1,
+    HIGH = 2,    // visible
+};
+
 enum class FinalOutputStep : int32_t {
     NO_CHANGE = 0,
     CONVERT_CHANGE = 1,
@@ -154,6 +162,27 @@ struct ImageInfo {
     int32_t baseDensity = 0;
 };
 
+// shared by the caller and the decoding, the decoding checks it between scanline batches, frames and
+// post processing steps, and stops with ERR_IMAGE_DECODE_CANCELED once it is canceled.
+class DecodeCancelToken {
+public:
+    DecodeCancelToken() = default;
+    // canceled together with the parent, canceling this token leaves the parent untouched.
+    explicit DecodeCancelToken(std::shared_ptr<DecodeCancelToken> parent) : parent_(std::move(parent)) {}
+    void Cancel()
+    {
+        isCanceled_.store(true, std::memory_order_relaxed);
+    }
+    bool IsCanceled() const
+    {
+        return isCanceled_.load(std::memory_order_relaxed) || (parent_ != nullptr && parent_->IsCanceled());
+    }
+
+private:
+    std::atomic<bool> isCanceled_ { false };
+    std::shared_ptr<DecodeCancelToken> parent_;
+};
+
 struct DecodeOptions {
     int32_t fitDensity = 0;
     Rect CropRect;
@@ -169,6 +198,7 @@ struct DecodeOptions {
     bool allowPartialImage = true;
     bool editable = false;
     MemoryUsagePreference preference = MemoryUsagePreference::DEFAULT;
+    std::shared_ptr<DecodeCancelToken> cancelToken;
 };
 
 enum class ScaleMode : int32_t {
@@ -40,6 +40,8 @@ struct IncrementalDecodingStatus {
     IncrementalDecodingState state = IncrementalDecodingState::UNRESOLVED;
     uint32_t errorDetail = 0;
     uint8_t decodingProgress = 0;
+    // for progressive images, the number of scans rendered to the pixel map as a full frame preview.
+    uint32_t renderedScans = 0;
 };
 
 class IncrementalPixelMap : public PixelMap, public PeerListener {
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PIXEL_MAP_CACHE_H
+#define PIXEL_MAP_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "image_type.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+// decoded pixels of one image, shared by the cache and the readers which are copying it out.
+struct CachedPixels {
+    ImageInfo info;
+    std::vector<uint8_t> pixels;
+};
+
+struct PixelMapCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t usedBytes = 0;
+    uint64_t budgetBytes = 0;
+    uint32_t entryCount = 0;
+};
+
+// process wide LRU cache of decoded images, consulted by ImageSource::CreatePixelMap before decoding.
+// the key is built from the source identity, the image index and the normalized decode options.
+// the cache is disabled until a byte budget is set.
+class PixelMapCache {
+public:
+    NATIVEEXPORT static PixelMapCache &GetInstance();
+    // set the byte budget, entries are evicted to fit it. 0 disables the cache and drops all entries.
+    NATIVEEXPORT void SetBudget(uint64_t budgetBytes);
+    NATIVEEXPORT uint64_t GetBudget();
+    NATIVEEXPORT bool IsEnabled();
+    NATIVEEXPORT void Clear();
+    NATIVEEXPORT PixelMapCacheStats GetStats();
+    NATIVEEXPORT void ResetStats();
+    // on hit the entry becomes the most recently used one.
+    std::shared_ptr<const CachedPixels> Get(const std::string &key);
+    // LOW_RAM callers keep the cache within a quarter of the budget.
+    void Put(const std::string &key, std::shared_ptr<const CachedPixels> entry, MemoryUsagePreference preference);
+
+private:
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<const CachedPixels>>>;
+    PixelMapCache() = default;
+    ~PixelMapCache() = default;
+    DISALLOW_COPY_AND_MOVE(PixelMapCache);
+    void EvictTo(uint64_t limitBytes);
+
+    std::mutex mutex_;
+    uint64_t budgetBytes_ = 0;
+    uint64_t usedBytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+    LruList lruList_;  // the most recently used entry at front.
+    std::unordered_map<std::string, LruList::iterator> entries_;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // PIXEL_MAP_CACHE_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PIXEL_MAP_FUTURE_H
+#define PIXEL_MAP_FUTURE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "image_type.h"
+#include "media_errors.h"
+#include "nocopyable.h"
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Media {
+// called on a decode thread once the result is ready, the result can then be taken by PixelMapFuture::Get.
+using DecodeCompleteCallback = std::function<void(uint32_t errorCode)>;
+
+// result of ImageSource::CreatePixelMapAsync.
+class PixelMapFuture {
+public:
+    ~PixelMapFuture() = default;
+    NATIVEEXPORT bool IsReady();
+    NATIVEEXPORT void Wait();
+    // return false if the result is not ready after the timeout.
+    NATIVEEXPORT bool WaitFor(uint32_t timeoutMs);
+    // block until the result is ready. the pixel map can be taken only once, nullptr is returned afterwards.
+    NATIVEEXPORT std::unique_ptr<PixelMap> Get(uint32_t &errorCode);
+    // a pending decoding is skipped and a running one stops at its next check, the result is then
+    // ERR_IMAGE_DECODE_CANCELED. a decoding which is about to finish may still succeed.
+    NATIVEEXPORT void Cancel();
+
+private:
+    // declare friend class, only ImageSource can create PixelMapFuture and set its result.
+    friend class ImageSource;
+    DISALLOW_COPY_AND_MOVE(PixelMapFuture);
+    PixelMapFuture(DecodeCompleteCallback callback, std::shared_ptr<DecodeCancelToken> cancelToken)
+        : callback_(std::move(callback)), cancelToken_(std::move(cancelToken)) {}
+    void SetResult(std::unique_ptr<PixelMap> pixelMap, uint32_t errorCode);
+
+    std::mutex mutex_;
+    std::condition_variable readyCond_;
+    bool isReady_ = false;
+    uint32_t errorCode_ = ERR_IMAGE_DECODE_ABNORMAL;
+    std::unique_ptr<PixelMap> pixelMap_;
+    DecodeCompleteCallback callback_;
+    std::shared_ptr<DecodeCancelToken> cancelToken_;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // PIXEL_MAP_FUTURE_H
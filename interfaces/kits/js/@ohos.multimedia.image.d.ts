@@ -424,6 +424,41 @@ declare namespace image {
      * @syscap SystemCapability.Multimedia.Image.ImageSource
      */
     desiredPixelFormat?: PixelMapFormat;
+
+    /**
+     * Priority of the decoding among the pending decodings. The default value is NORMAL.
+     * @since 9
+     * @syscap SystemCapability.Multimedia.Image.ImageSource
+     */
+    priority?: DecodingPriority;
+  }
+
+  /**
+   * Describes the priority of a decoding.
+   * @since 9
+   * @syscap SystemCapability.Multimedia.Image.ImageSource
+   */
+  enum DecodingPriority {
+    /**
+     * Decoded after the others, such as prefetching the images which are not visible yet.
+     * @since 9
+     * @syscap SystemCapability.Multimedia.Image.ImageSource
+     */
+    LOW = 0,
+
+    /**
+     * Default priority.
+     * @since 9
+     * @syscap SystemCapability.Multimedia.Image.ImageSource
+     */
+    NORMAL = 1,
+
+    /**
+     * Decoded before the others, such as the images which are visible.
+     * @since 9
+     * @syscap SystemCapability.Multimedia.Image.ImageSource
+     */
+    HIGH = 2,
   }
 
   /**
@@ -70,6 +70,8 @@ private:
 
     napi_env env_ = nullptr;
     napi_ref wrapper_ = nullptr;
+    // shared by the decodings of the source, which are canceled when the source is released.
+    std::shared_ptr<DecodeCancelToken> cancelToken_ = std::make_shared<DecodeCancelToken>();
 
     bool isRelease = false;
 };
@@ -20,6 +20,7 @@
 #include <string>
 #include "SkCodec.h"
 #include "abs_image_decoder.h"
+#include "bmp_native_decoder.h"
 #include "bmp_stream.h"
 #include "hilog/log.h"
 #include "log_tags.h"
@@ -50,6 +51,7 @@ public:
 private:
     DISALLOW_COPY_AND_MOVE(BmpDecoder);
     bool DecodeHeader();
+    uint32_t DoNativeDecode(DecodeContext &context);
     PlAlphaType ConvertToAlphaType(SkAlphaType alphaType);
     SkColorType ConvertToColorType(PlPixelFormat format, PlPixelFormat &outputFormat);
     uint32_t SetContextPixelsBuffer(uint64_t byteCount, DecodeContext &context);
@@ -58,6 +60,9 @@ private:
     std::unique_ptr<SkCodec> codec_ = nullptr;
     SkImageInfo info_;
     SkColorType desireColor_ = kUnknown_SkColorType;
+    // common uncompressed bitmaps are decoded natively, SkCodec is only the fallback.
+    std::unique_ptr<BmpNativeDecoder> nativeDecoder_ = nullptr;
+    bool allowPartialImage_ = true;
     BmpDecodingState state_ = BmpDecodingState::UNDECIDED;
 };
 } // namespace ImagePlugin
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BMP_NATIVE_DECODER_H
+#define BMP_NATIVE_DECODER_H
+
+#include <cstdint>
+#include <vector>
+#include "image_plugin_type.h"
+#include "input_data_stream.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+static constexpr uint32_t BMP_COLOR_TABLE_MAX = 256;
+
+struct BmpChannelMask {
+    uint32_t mask = 0;
+    uint32_t shift = 0;
+    uint32_t bits = 0;
+};
+
+struct BmpRowParams {
+    uint32_t dstWidth = 0;
+    uint32_t sampleSize = 1;
+    uint32_t startX = 0;
+    // color table packed in the output pixel format, only used by indexed bitmaps.
+    const uint32_t *colorTable = nullptr;
+    BmpChannelMask red;
+    BmpChannelMask green;
+    BmpChannelMask blue;
+    BmpChannelMask alpha;
+};
+
+using BmpRowExpander = void (*)(const uint8_t *src, uint8_t *dst, const BmpRowParams &params);
+
+// decodes uncompressed 1/4/8/16/24/32-bit and BI_BITFIELDS bitmaps without going through SkCodec.
+// RLE compressed bitmaps and unusual headers are left to the SkCodec fallback of BmpDecoder.
+class BmpNativeDecoder {
+public:
+    explicit BmpNativeDecoder(InputDataStream *stream) : stream_(stream) {};
+    ~BmpNativeDecoder() = default;
+    // returns false when the bitmap can not be decoded natively, the stream position is undefined then.
+    bool ParseHeader();
+    // choose the row expander for the desired format, output the format actually used.
+    void SetOutputFormat(PlPixelFormat desiredFormat, uint32_t sampleSize, PlPixelFormat &outputFormat);
+    // decode rows straight into dst, rows which are not needed by sampleSize are skipped without being read.
+    // decodedRows outputs how many output rows have been written when the data is truncated.
+    uint32_t Decode(uint8_t *dst, uint32_t rowBytes, uint32_t &decodedRows);
+    uint32_t GetWidth() const
+    {
+        return width_;
+    }
+    uint32_t GetHeight() const
+    {
+        return height_;
+    }
+    uint32_t GetOutputWidth() const
+    {
+        return GetSampledSize(width_, sampleSize_);
+    }
+    uint32_t GetOutputHeight() const
+    {
+        return GetSampledSize(height_, sampleSize_);
+    }
+    uint32_t GetOutputBytesPerPixel() const
+    {
+        return outputBytesPerPixel_;
+    }
+    bool IsOpaque() const
+    {
+        return rowParams_.alpha.mask == 0;
+    }
+    static uint32_t GetSampledSize(uint32_t size, uint32_t sampleSize);
+
+private:
+    DISALLOW_COPY_AND_MOVE(BmpNativeDecoder);
+    bool ParseInfoHeader(const uint8_t *header, uint32_t headerSize, uint32_t &masksSize);
+    bool ParseMasks(const uint8_t *masks, uint32_t size);
+    bool ReadColorTable(uint32_t offset);
+    void PackColorTable(PlPixelFormat format);
+    bool ReadBytes(uint32_t position, uint8_t *buffer, uint32_t size);
+    const uint8_t *GetSourceRow(uint32_t srcRow);
+    uint32_t GetSampledCoord(uint32_t index, uint32_t size) const;
+    InputDataStream *stream_ = nullptr;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    bool bottomUp_ = true;
+    uint16_t bitsPerPixel_ = 0;
+    uint32_t compression_ = 0;
+    uint32_t pixelOffset_ = 0;
+    uint32_t srcRowBytes_ = 0;
+    uint32_t colorCount_ = 0;
+    uint32_t sampleSize_ = 1;
+    uint32_t outputBytesPerPixel_ = 0;
+    // original palette in B, G, R order, packed into colorTable_ once the output format is known.
+    std::vector<uint8_t> palette_;
+    uint32_t colorTable_[BMP_COLOR_TABLE_MAX] = { 0 };
+    std::vector<uint8_t> rowBuffer_;
+    BmpRowParams rowParams_;
+    BmpRowExpander expander_ = nullptr;
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // BMP_NATIVE_DECODER_H
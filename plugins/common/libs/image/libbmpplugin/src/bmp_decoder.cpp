@@ -40,6 +40,7 @@ void BmpDecoder::Reset()
         stream_->Seek(0);
     }
     codec_.release();
+    nativeDecoder_ = nullptr;
     info_.reset();
     desireColor_ = kUnknown_SkColorType;
 }
@@ -92,6 +93,16 @@ uint32_t BmpDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &
         state_ = BmpDecodingState::BASE_INFO_PARSED;
     }
     PlPixelFormat desiredFormat = opts.desiredPixelFormat;
+    if (nativeDecoder_ != nullptr) {
+        nativeDecoder_->SetOutputFormat(desiredFormat, opts.sampleSize, info.pixelFormat);
+        allowPartialImage_ = opts.allowPartialImage;
+        info.size.width = nativeDecoder_->GetOutputWidth();
+        info.size.height = nativeDecoder_->GetOutputHeight();
+        info.alphaType = nativeDecoder_->IsOpaque() ? PlAlphaType::IMAGE_ALPHA_TYPE_OPAQUE :
+                                                      PlAlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+        state_ = BmpDecodingState::IMAGE_DECODING;
+        return SUCCESS;
+    }
     desireColor_ = ConvertToColorType(desiredFormat, info.pixelFormat);
     info.size.width = info_.width();
     info.size.height = info_.height();
@@ -177,14 +188,17 @@ uint32_t BmpDecoder::Decode(uint32_t index, DecodeContext &context)
         HiLog::Error(LABEL, "Decode failed, invalid index:%{public}u, range:%{public}u", index, BMP_IMAGE_NUM);
         return ERR_IMAGE_INVALID_PARAMETER;
     }
-    if (codec_ == nullptr) {
-        HiLog::Error(LABEL, "Decode failed, codec is null");
-        return ERR_IMAGE_DECODE_FAILED;
-    }
     if (state_ != BmpDecodingState::IMAGE_DECODING) {
         HiLog::Error(LABEL, "Decode failed, invalid state %{public}d", state_);
         return ERR_MEDIA_INVALID_OPERATION;
     }
+    if (nativeDecoder_ != nullptr) {
+        return DoNativeDecode(context);
+    }
+    if (codec_ == nullptr) {
+        HiLog::Error(LABEL, "Decode failed, codec is null");
+        return ERR_IMAGE_DECODE_FAILED;
+    }
 
     SkImageInfo dstInfo = info_.makeColorType(desireColor_);
     if (ImageUtils::CheckMulOverflow(dstInfo.width(), dstInfo.height(), dstInfo.bytesPerPixel())) {
@@ -211,6 +225,40 @@ uint32_t BmpDecoder::Decode(uint32_t index, DecodeContext &context)
     return SUCCESS;
 }
 
+uint32_t BmpDecoder::DoNativeDecode(DecodeContext &context)
+{
+    uint32_t width = nativeDecoder_->GetOutputWidth();
+    uint32_t height = nativeDecoder_->GetOutputHeight();
+    uint32_t bytesPerPixel = nativeDecoder_->GetOutputBytesPerPixel();
+    if (ImageUtils::CheckMulOverflow(width, height, bytesPerPixel)) {
+        HiLog::Error(LABEL, "Decode failed, width:%{public}u, height:%{public}u is too large", width, height);
+        return ERR_IMAGE_DECODE_FAILED;
+    }
+    if (context.pixelsBuffer.buffer == nullptr) {
+        uint64_t byteCount = static_cast<uint64_t>(height) * width * bytesPerPixel;
+        uint32_t res = SetContextPixelsBuffer(byteCount, context);
+        if (res != SUCCESS) {
+            return res;
+        }
+    }
+    uint32_t decodedRows = 0;
+    uint32_t ret = nativeDecoder_->Decode(static_cast<uint8_t *>(context.pixelsBuffer.buffer),
+                                          width * bytesPerPixel, decodedRows);
+    if (ret == ERR_IMAGE_SOURCE_DATA_INCOMPLETE && allowPartialImage_ && decodedRows > 0) {
+        // rows have not been decoded are left zero filled.
+        HiLog::Info(LABEL, "Decode partial image, decoded rows:%{public}u", decodedRows);
+        context.ifPartialOutput = true;
+        ret = SUCCESS;
+    }
+    if (ret != SUCCESS) {
+        HiLog::Error(LABEL, "Decode failed, native decode ret=%{public}u", ret);
+        state_ = BmpDecodingState::IMAGE_ERROR;
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    state_ = BmpDecodingState::IMAGE_DECODED;
+    return SUCCESS;
+}
+
 uint32_t BmpDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context)
 {
     // currently not support increment decode
@@ -219,6 +267,17 @@ uint32_t BmpDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext
 
 bool BmpDecoder::DecodeHeader()
 {
+    auto nativeDecoder = make_unique<BmpNativeDecoder>(stream_);
+    if (nativeDecoder->ParseHeader()) {
+        info_ = SkImageInfo::MakeUnknown(nativeDecoder->GetWidth(), nativeDecoder->GetHeight());
+        nativeDecoder_ = std::move(nativeDecoder);
+        return true;
+    }
+    // RLE and unusual headers, decode by SkCodec.
+    if (!stream_->Seek(0)) {
+        HiLog::Error(LABEL, "seek to the beginning of the stream failed");
+        return false;
+    }
     codec_ = SkCodec::MakeFromStream(make_unique<BmpStream>(stream_));
     if (codec_ == nullptr) {
         HiLog::Error(LABEL, "create codec from stream failed");
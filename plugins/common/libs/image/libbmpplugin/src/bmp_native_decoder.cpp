@@ -0,0 +1,529 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bmp_native_decoder.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "hilog/log.h"
+#include "log_tags.h"
+#include "media_errors.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace OHOS::HiviewDFX;
+using namespace Media;
+static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "BmpNativeDecoder" };
+namespace {
+constexpr uint32_t BMP_FILE_HEADER_SIZE = 14;
+constexpr uint32_t BMP_INFO_HEADER_SIZE = 40;
+constexpr uint32_t BMP_INFO_V2_HEADER_SIZE = 52;
+constexpr uint32_t BMP_INFO_V3_HEADER_SIZE = 56;
+constexpr uint32_t BMP_INFO_V4_HEADER_SIZE = 108;
+constexpr uint32_t BMP_INFO_V5_HEADER_SIZE = 124;
+constexpr uint32_t BMP_RGB_MASKS_SIZE = 12;
+constexpr uint32_t BMP_PALETTE_ENTRY_SIZE = 4;
+constexpr uint32_t BMP_COMPRESSION_RGB = 0;
+constexpr uint32_t BMP_COMPRESSION_BITFIELDS = 3;
+constexpr uint32_t BMP_ROW_ALIGN_BITS = 32;
+constexpr uint32_t BMP_ROW_ALIGN_BYTES = 4;
+constexpr uint32_t BMP_PIXEL_OFFSET_POS = 10;
+constexpr uint32_t BMP_INFO_SIZE_POS = 14;
+constexpr uint32_t BMP_WIDTH_POS = 4;
+constexpr uint32_t BMP_HEIGHT_POS = 8;
+constexpr uint32_t BMP_PLANES_POS = 12;
+constexpr uint32_t BMP_BITS_POS = 14;
+constexpr uint32_t BMP_COMPRESSION_POS = 16;
+constexpr uint32_t BMP_COLORS_USED_POS = 32;
+constexpr uint32_t BMP_RED_MASK_POS = 0;
+constexpr uint32_t BMP_GREEN_MASK_POS = 4;
+constexpr uint32_t BMP_BLUE_MASK_POS = 8;
+constexpr uint32_t BMP_ALPHA_MASK_POS = 12;
+constexpr uint32_t BMP_MASK_SIZE = 4;
+constexpr uint32_t BMP_RGB555_RED_MASK = 0x7C00;
+constexpr uint32_t BMP_RGB555_GREEN_MASK = 0x03E0;
+constexpr uint32_t BMP_RGB555_BLUE_MASK = 0x001F;
+constexpr uint32_t BMP_BGRA_RED_MASK = 0x00FF0000;
+constexpr uint32_t BMP_BGRA_GREEN_MASK = 0x0000FF00;
+constexpr uint32_t BMP_BGRA_BLUE_MASK = 0x000000FF;
+constexpr uint32_t BMP_BGRA_ALPHA_MASK = 0xFF000000;
+constexpr uint16_t BITS_1 = 1;
+constexpr uint16_t BITS_4 = 4;
+constexpr uint16_t BITS_8 = 8;
+constexpr uint16_t BITS_16 = 16;
+constexpr uint16_t BITS_24 = 24;
+constexpr uint16_t BITS_32 = 32;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint32_t BYTE_MASK = 0xFF;
+constexpr uint8_t OPAQUE_ALPHA = 0xFF;
+constexpr uint32_t SHIFT_8 = 8;
+constexpr uint32_t SHIFT_16 = 16;
+constexpr uint32_t SHIFT_24 = 24;
+constexpr uint32_t BLUE_INDEX = 0;
+constexpr uint32_t GREEN_INDEX = 1;
+constexpr uint32_t RED_INDEX = 2;
+constexpr uint32_t ALPHA_INDEX = 3;
+constexpr uint32_t RGB565_RED_SHIFT = 11;
+constexpr uint32_t RGB565_GREEN_SHIFT = 5;
+constexpr uint32_t RGB565_RED_DROP = 3;
+constexpr uint32_t RGB565_GREEN_DROP = 2;
+constexpr uint32_t RGB565_BLUE_DROP = 3;
+constexpr uint32_t BYTES_PER_PIXEL_2 = 2;
+constexpr uint32_t BYTES_PER_PIXEL_3 = 3;
+constexpr uint32_t BYTES_PER_PIXEL_4 = 4;
+
+inline uint16_t ReadLE16(const uint8_t *data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << SHIFT_8));
+}
+
+inline uint32_t ReadLE32(const uint8_t *data)
+{
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << SHIFT_8) |
+           (static_cast<uint32_t>(data[2]) << SHIFT_16) | (static_cast<uint32_t>(data[3]) << SHIFT_24);
+}
+
+struct RgbaPacker {
+    static constexpr uint32_t BYTES = BYTES_PER_PIXEL_4;
+    static inline void Pack(uint8_t *dst, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
+    {
+        dst[0] = red;
+        dst[1] = green;
+        dst[2] = blue;
+        dst[3] = alpha;
+    }
+};
+
+struct BgraPacker {
+    static constexpr uint32_t BYTES = BYTES_PER_PIXEL_4;
+    static inline void Pack(uint8_t *dst, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
+    {
+        dst[0] = blue;
+        dst[1] = green;
+        dst[2] = red;
+        dst[3] = alpha;
+    }
+};
+
+struct Rgb565Packer {
+    static constexpr uint32_t BYTES = BYTES_PER_PIXEL_2;
+    static inline void Pack(uint8_t *dst, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
+    {
+        uint16_t color = static_cast<uint16_t>(((red >> RGB565_RED_DROP) << RGB565_RED_SHIFT) |
+                                               ((green >> RGB565_GREEN_DROP) << RGB565_GREEN_SHIFT) |
+                                               (blue >> RGB565_BLUE_DROP));
+        *reinterpret_cast<uint16_t *>(dst) = color;
+    }
+};
+
+inline uint8_t GetMaskedChannel(uint32_t pixel, const BmpChannelMask &channel)
+{
+    uint32_t value = (pixel & channel.mask) >> channel.shift;
+    if (channel.bits >= BYTE_BITS) {
+        return static_cast<uint8_t>(value >> (channel.bits - BYTE_BITS));
+    }
+    uint32_t maxValue = (1u << channel.bits) - 1;
+    return static_cast<uint8_t>((value * BYTE_MASK + (maxValue >> 1)) / maxValue);
+}
+
+template <typename Packer, uint32_t BITS>
+void ExpandIndexedRow(const uint8_t *src, uint8_t *dst, const BmpRowParams &params)
+{
+    constexpr uint32_t indexMask = (1u << BITS) - 1;
+    uint32_t x = params.startX;
+    for (uint32_t i = 0; i < params.dstWidth; i++, x += params.sampleSize) {
+        uint32_t bitOffset = x * BITS;
+        uint32_t index = (src[bitOffset / BYTE_BITS] >> (BYTE_BITS - BITS - (bitOffset % BYTE_BITS))) & indexMask;
+        // the color table has been packed in the output format, copy it directly.
+        memcpy(dst, &params.colorTable[index], Packer::BYTES);
+        dst += Packer::BYTES;
+    }
+}
+
+template <typename Packer>
+void ExpandBgrRow(const uint8_t *src, uint8_t *dst, const BmpRowParams &params)
+{
+    const uint8_t *pixel = src + params.startX * BYTES_PER_PIXEL_3;
+    uint32_t step = params.sampleSize * BYTES_PER_PIXEL_3;
+    for (uint32_t i = 0; i < params.dstWidth; i++, pixel += step) {
+        Packer::Pack(dst, pixel[RED_INDEX], pixel[GREEN_INDEX], pixel[BLUE_INDEX], OPAQUE_ALPHA);
+        dst += Packer::BYTES;
+    }
+}
+
+template <typename Packer, bool HAS_ALPHA>
+void ExpandBgraRow(const uint8_t *src, uint8_t *dst, const BmpRowParams &params)
+{
+    const uint8_t *pixel = src + params.startX * BYTES_PER_PIXEL_4;
+    uint32_t step = params.sampleSize * BYTES_PER_PIXEL_4;
+    for (uint32_t i = 0; i < params.dstWidth; i++, pixel += step) {
+        Packer::Pack(dst, pixel[RED_INDEX], pixel[GREEN_INDEX], pixel[BLUE_INDEX],
+                     HAS_ALPHA ? pixel[ALPHA_INDEX] : OPAQUE_ALPHA);
+        dst += Packer::BYTES;
+    }
+}
+
+template <typename Packer, uint32_t BYTES>
+void ExpandMaskRow(const uint8_t *src, uint8_t *dst, const BmpRowParams &params)
+{
+    const uint8_t *pixel = src + params.startX * BYTES;
+    uint32_t step = params.sampleSize * BYTES;
+    bool hasAlpha = params.alpha.mask != 0;
+    for (uint32_t i = 0; i < params.dstWidth; i++, pixel += step) {
+        uint32_t value = (BYTES == BYTES_PER_PIXEL_2) ? ReadLE16(pixel) : ReadLE32(pixel);
+        Packer::Pack(dst, GetMaskedChannel(value, params.red), GetMaskedChannel(value, params.green),
+                     GetMaskedChannel(value, params.blue),
+                     hasAlpha ? GetMaskedChannel(value, params.alpha) : OPAQUE_ALPHA);
+        dst += Packer::BYTES;
+    }
+}
+
+bool IsStandardBgraMasks(const BmpRowParams &params)
+{
+    return params.red.mask == BMP_BGRA_RED_MASK && params.green.mask == BMP_BGRA_GREEN_MASK &&
+           params.blue.mask == BMP_BGRA_BLUE_MASK && (params.alpha.mask == 0 || params.alpha.mask == BMP_BGRA_ALPHA_MASK);
+}
+
+template <typename Packer>
+BmpRowExpander ChooseExpander(uint16_t bitsPerPixel, const BmpRowParams &params)
+{
+    switch (bitsPerPixel) {
+        case BITS_1:
+            return ExpandIndexedRow<Packer, BITS_1>;
+        case BITS_4:
+            return ExpandIndexedRow<Packer, BITS_4>;
+        case BITS_8:
+            return ExpandIndexedRow<Packer, BITS_8>;
+        case BITS_16:
+            return ExpandMaskRow<Packer, BYTES_PER_PIXEL_2>;
+        case BITS_24:
+            return ExpandBgrRow<Packer>;
+        case BITS_32: {
+            if (!IsStandardBgraMasks(params)) {
+                return ExpandMaskRow<Packer, BYTES_PER_PIXEL_4>;
+            }
+            if (params.alpha.mask != 0) {
+                return ExpandBgraRow<Packer, true>;
+            }
+            return ExpandBgraRow<Packer, false>;
+        }
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+template <typename Packer>
+void PackTable(const std::vector<uint8_t> &palette, uint32_t colorCount, uint32_t *colorTable)
+{
+    for (uint32_t i = 0; i < BMP_COLOR_TABLE_MAX; i++) {
+        uint8_t *entry = reinterpret_cast<uint8_t *>(&colorTable[i]);
+        if (i >= colorCount) {
+            // out of range indexes are decoded as opaque black.
+            Packer::Pack(entry, 0, 0, 0, OPAQUE_ALPHA);
+            continue;
+        }
+        const uint8_t *color = palette.data() + i * BMP_PALETTE_ENTRY_SIZE;
+        Packer::Pack(entry, color[RED_INDEX], color[GREEN_INDEX], color[BLUE_INDEX], OPAQUE_ALPHA);
+    }
+}
+
+bool InitChannelMask(uint32_t mask, BmpChannelMask &channel)
+{
+    channel.mask = mask;
+    channel.shift = 0;
+    channel.bits = 0;
+    if (mask == 0) {
+        return true;
+    }
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        channel.shift++;
+    }
+    while ((mask & 1) != 0) {
+        mask >>= 1;
+        channel.bits++;
+    }
+    // non-contiguous masks are left to SkCodec.
+    return mask == 0;
+}
+} // namespace
+
+uint32_t BmpNativeDecoder::GetSampledSize(uint32_t size, uint32_t sampleSize)
+{
+    if (sampleSize <= 1) {
+        return size;
+    }
+    // same as skia sampling: never scale to zero, drop the incomplete tail block.
+    return std::max(size / sampleSize, 1u);
+}
+
+uint32_t BmpNativeDecoder::GetSampledCoord(uint32_t index, uint32_t size) const
+{
+    if (sampleSize_ <= 1) {
+        return index;
+    }
+    if (size < sampleSize_) {
+        return size / 2;  // take the middle one.
+    }
+    return index * sampleSize_ + sampleSize_ / 2;
+}
+
+bool BmpNativeDecoder::ReadBytes(uint32_t position, uint8_t *buffer, uint32_t size)
+{
+    if (stream_ == nullptr || !stream_->Seek(position)) {
+        return false;
+    }
+    uint32_t readSize = 0;
+    if (!stream_->Read(size, buffer, size, readSize) || readSize != size) {
+        return false;
+    }
+    return true;
+}
+
+bool BmpNativeDecoder::ParseHeader()
+{
+    // one more masks block in case of a BITMAPINFOHEADER followed by BI_BITFIELDS masks.
+    uint8_t header[BMP_FILE_HEADER_SIZE + BMP_INFO_V5_HEADER_SIZE + BMP_RGB_MASKS_SIZE] = { 0 };
+    if (!ReadBytes(0, header, BMP_FILE_HEADER_SIZE + BMP_MASK_SIZE)) {
+        HiLog::Error(LABEL, "read bmp file header failed");
+        return false;
+    }
+    if (header[0] != 'B' || header[1] != 'M') {
+        HiLog::Debug(LABEL, "not a windows bitmap, fallback to skia");
+        return false;
+    }
+    pixelOffset_ = ReadLE32(header + BMP_PIXEL_OFFSET_POS);
+    uint32_t infoSize = ReadLE32(header + BMP_INFO_SIZE_POS);
+    if (infoSize != BMP_INFO_HEADER_SIZE && infoSize != BMP_INFO_V2_HEADER_SIZE &&
+        infoSize != BMP_INFO_V3_HEADER_SIZE && infoSize != BMP_INFO_V4_HEADER_SIZE &&
+        infoSize != BMP_INFO_V5_HEADER_SIZE) {
+        HiLog::Debug(LABEL, "unusual info header size:%{public}u, fallback to skia", infoSize);
+        return false;
+    }
+    const uint8_t *info = header + BMP_FILE_HEADER_SIZE;
+    if (!ReadBytes(BMP_FILE_HEADER_SIZE, header + BMP_FILE_HEADER_SIZE, infoSize)) {
+        HiLog::Error(LABEL, "read bmp info header failed, size:%{public}u", infoSize);
+        return false;
+    }
+    if (infoSize == BMP_INFO_HEADER_SIZE && ReadLE32(info + BMP_COMPRESSION_POS) == BMP_COMPRESSION_BITFIELDS &&
+        !ReadBytes(BMP_FILE_HEADER_SIZE + infoSize, header + BMP_FILE_HEADER_SIZE + infoSize, BMP_RGB_MASKS_SIZE)) {
+        HiLog::Error(LABEL, "read bmp bitfields masks failed");
+        return false;
+    }
+    uint32_t masksSize = 0;
+    if (!ParseInfoHeader(info, infoSize, masksSize)) {
+        return false;
+    }
+    return ReadColorTable(BMP_FILE_HEADER_SIZE + infoSize + masksSize);
+}
+
+bool BmpNativeDecoder::ParseInfoHeader(const uint8_t *header, uint32_t headerSize, uint32_t &masksSize)
+{
+    int32_t width = static_cast<int32_t>(ReadLE32(header + BMP_WIDTH_POS));
+    int32_t height = static_cast<int32_t>(ReadLE32(header + BMP_HEIGHT_POS));
+    uint16_t planes = ReadLE16(header + BMP_PLANES_POS);
+    bitsPerPixel_ = ReadLE16(header + BMP_BITS_POS);
+    compression_ = ReadLE32(header + BMP_COMPRESSION_POS);
+    uint32_t colorsUsed = ReadLE32(header + BMP_COLORS_USED_POS);
+    if (width <= 0 || height == 0 || height == INT32_MIN || planes != 1) {
+        HiLog::Error(LABEL, "invalid bmp header, width:%{public}d, height:%{public}d, planes:%{public}u", width,
+                     height, planes);
+        return false;
+    }
+    width_ = static_cast<uint32_t>(width);
+    bottomUp_ = (height > 0);
+    height_ = static_cast<uint32_t>(bottomUp_ ? height : -height);
+    if (bitsPerPixel_ != BITS_1 && bitsPerPixel_ != BITS_4 && bitsPerPixel_ != BITS_8 && bitsPerPixel_ != BITS_16 &&
+        bitsPerPixel_ != BITS_24 && bitsPerPixel_ != BITS_32) {
+        HiLog::Debug(LABEL, "unsupported bits per pixel:%{public}u, fallback to skia", bitsPerPixel_);
+        return false;
+    }
+    rowParams_ = BmpRowParams();
+    if (compression_ == BMP_COMPRESSION_RGB) {
+        if (bitsPerPixel_ == BITS_16) {
+            InitChannelMask(BMP_RGB555_RED_MASK, rowParams_.red);
+            InitChannelMask(BMP_RGB555_GREEN_MASK, rowParams_.green);
+            InitChannelMask(BMP_RGB555_BLUE_MASK, rowParams_.blue);
+        } else if (bitsPerPixel_ == BITS_32) {
+            // the fourth byte of BI_RGB 32-bit pixels is reserved, treat them as opaque.
+            InitChannelMask(BMP_BGRA_RED_MASK, rowParams_.red);
+            InitChannelMask(BMP_BGRA_GREEN_MASK, rowParams_.green);
+            InitChannelMask(BMP_BGRA_BLUE_MASK, rowParams_.blue);
+        }
+    } else if (compression_ == BMP_COMPRESSION_BITFIELDS) {
+        if (bitsPerPixel_ != BITS_16 && bitsPerPixel_ != BITS_32) {
+            HiLog::Error(LABEL, "invalid bitfields bmp, bits per pixel:%{public}u", bitsPerPixel_);
+            return false;
+        }
+        if (headerSize == BMP_INFO_HEADER_SIZE) {
+            masksSize = BMP_RGB_MASKS_SIZE;
+        }
+        if (!ParseMasks(header + BMP_INFO_HEADER_SIZE, (headerSize >= BMP_INFO_V3_HEADER_SIZE) ?
+            (BMP_RGB_MASKS_SIZE + BMP_MASK_SIZE) : BMP_RGB_MASKS_SIZE)) {
+            return false;
+        }
+    } else {
+        // RLE4, RLE8, embedded jpeg/png and alpha bitfields.
+        HiLog::Debug(LABEL, "unsupported compression:%{public}u, fallback to skia", compression_);
+        return false;
+    }
+    uint64_t rowBits = static_cast<uint64_t>(width_) * bitsPerPixel_;
+    uint64_t rowBytes = (rowBits + BMP_ROW_ALIGN_BITS - 1) / BMP_ROW_ALIGN_BITS * BMP_ROW_ALIGN_BYTES;
+    if (rowBytes > UINT32_MAX) {
+        HiLog::Error(LABEL, "bmp row is too large, width:%{public}u", width_);
+        return false;
+    }
+    srcRowBytes_ = static_cast<uint32_t>(rowBytes);
+    if (bitsPerPixel_ <= BITS_8) {
+        uint32_t maxColors = 1u << bitsPerPixel_;
+        colorCount_ = (colorsUsed == 0 || colorsUsed > maxColors) ? maxColors : colorsUsed;
+    } else {
+        colorCount_ = 0;
+    }
+    return true;
+}
+
+bool BmpNativeDecoder::ParseMasks(const uint8_t *masks, uint32_t size)
+{
+    bool ret = InitChannelMask(ReadLE32(masks + BMP_RED_MASK_POS), rowParams_.red) &&
+               InitChannelMask(ReadLE32(masks + BMP_GREEN_MASK_POS), rowParams_.green) &&
+               InitChannelMask(ReadLE32(masks + BMP_BLUE_MASK_POS), rowParams_.blue);
+    if (size > BMP_RGB_MASKS_SIZE) {
+        ret = ret && InitChannelMask(ReadLE32(masks + BMP_ALPHA_MASK_POS), rowParams_.alpha);
+    }
+    if (!ret || rowParams_.red.mask == 0 || rowParams_.green.mask == 0 || rowParams_.blue.mask == 0) {
+        HiLog::Debug(LABEL, "unusual bitfields masks, fallback to skia");
+        return false;
+    }
+    if (bitsPerPixel_ == BITS_16 && ((rowParams_.red.mask | rowParams_.green.mask | rowParams_.blue.mask |
+        rowParams_.alpha.mask) >> BITS_16) != 0) {
+        HiLog::Error(LABEL, "bitfields masks out of 16-bit pixel range");
+        return false;
+    }
+    return true;
+}
+
+bool BmpNativeDecoder::ReadColorTable(uint32_t offset)
+{
+    uint64_t tableEnd = static_cast<uint64_t>(offset) + static_cast<uint64_t>(colorCount_) * BMP_PALETTE_ENTRY_SIZE;
+    if (pixelOffset_ < tableEnd) {
+        HiLog::Debug(LABEL, "pixel offset %{public}u overlaps headers, fallback to skia", pixelOffset_);
+        return false;
+    }
+    if (colorCount_ == 0) {
+        palette_.clear();
+        return true;
+    }
+    palette_.resize(colorCount_ * BMP_PALETTE_ENTRY_SIZE);
+    if (!ReadBytes(offset, palette_.data(), palette_.size())) {
+        HiLog::Error(LABEL, "read bmp color table failed, colors:%{public}u", colorCount_);
+        return false;
+    }
+    return true;
+}
+
+void BmpNativeDecoder::PackColorTable(PlPixelFormat format)
+{
+    if (colorCount_ == 0) {
+        return;
+    }
+    switch (format) {
+        case PlPixelFormat::BGRA_8888:
+            PackTable<BgraPacker>(palette_, colorCount_, colorTable_);
+            break;
+        case PlPixelFormat::RGB_565:
+            PackTable<Rgb565Packer>(palette_, colorCount_, colorTable_);
+            break;
+        default:
+            PackTable<RgbaPacker>(palette_, colorCount_, colorTable_);
+            break;
+    }
+}
+
+void BmpNativeDecoder::SetOutputFormat(PlPixelFormat desiredFormat, uint32_t sampleSize, PlPixelFormat &outputFormat)
+{
+    sampleSize_ = (sampleSize == 0) ? 1 : sampleSize;
+    if (desiredFormat == PlPixelFormat::BGRA_8888) {
+        outputFormat = PlPixelFormat::BGRA_8888;
+        expander_ = ChooseExpander<BgraPacker>(bitsPerPixel_, rowParams_);
+        outputBytesPerPixel_ = BgraPacker::BYTES;
+    } else if (desiredFormat == PlPixelFormat::RGB_565 && IsOpaque()) {
+        outputFormat = PlPixelFormat::RGB_565;
+        expander_ = ChooseExpander<Rgb565Packer>(bitsPerPixel_, rowParams_);
+        outputBytesPerPixel_ = Rgb565Packer::BYTES;
+    } else {
+        // ALPHA_8 and the others are not supported by bmp, use the default RGBA.
+        outputFormat = PlPixelFormat::RGBA_8888;
+        expander_ = ChooseExpander<RgbaPacker>(bitsPerPixel_, rowParams_);
+        outputBytesPerPixel_ = RgbaPacker::BYTES;
+    }
+    PackColorTable(outputFormat);
+    rowParams_.dstWidth = GetOutputWidth();
+    rowParams_.sampleSize = (width_ < sampleSize_) ? 1 : sampleSize_;
+    rowParams_.startX = GetSampledCoord(0, width_);
+    rowParams_.colorTable = colorTable_;
+}
+
+const uint8_t *BmpNativeDecoder::GetSourceRow(uint32_t srcRow)
+{
+    uint64_t position = static_cast<uint64_t>(pixelOffset_) + static_cast<uint64_t>(srcRow) * srcRowBytes_;
+    if (position + srcRowBytes_ > UINT32_MAX) {
+        return nullptr;
+    }
+    // buffer source, use the row in place without any copy.
+    uint8_t *data = stream_->GetDataPtr();
+    if (stream_->GetStreamType() == BUFFER_SOURCE_TYPE && data != nullptr) {
+        if (position + srcRowBytes_ > stream_->GetStreamSize()) {
+            return nullptr;
+        }
+        return data + position;
+    }
+    if (rowBuffer_.size() < srcRowBytes_) {
+        rowBuffer_.resize(srcRowBytes_);
+    }
+    if (!ReadBytes(static_cast<uint32_t>(position), rowBuffer_.data(), srcRowBytes_)) {
+        return nullptr;
+    }
+    return rowBuffer_.data();
+}
+
+uint32_t BmpNativeDecoder::Decode(uint8_t *dst, uint32_t rowBytes, uint32_t &decodedRows)
+{
+    decodedRows = 0;
+    if (dst == nullptr || expander_ == nullptr) {
+        HiLog::Error(LABEL, "decode failed, output buffer or row expander is null");
+        return ERR_MEDIA_INVALID_OPERATION;
+    }
+    uint32_t outputHeight = GetOutputHeight();
+    // walk the rows in file order, so that bottom-up bitmaps are written backwards into place
+    // and the source is only read forward, rows dropped by sampling are seeked over.
+    for (uint32_t i = 0; i < outputHeight; i++) {
+        uint32_t dstRow = bottomUp_ ? (outputHeight - 1 - i) : i;
+        uint32_t imageRow = GetSampledCoord(dstRow, height_);
+        uint32_t srcRow = bottomUp_ ? (height_ - 1 - imageRow) : imageRow;
+        const uint8_t *src = GetSourceRow(srcRow);
+        if (src == nullptr) {
+            HiLog::Error(LABEL, "bmp data incomplete, decoded rows:%{public}u, total:%{public}u", decodedRows,
+                         outputHeight);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        expander_(src, dst + static_cast<uint64_t>(dstRow) * rowBytes, rowParams_);
+        decodedRows++;
+    }
+    return SUCCESS;
+}
+} // namespace ImagePlugin
+} // namespace OHOS
@@ -42,6 +42,10 @@ public:
     ~GifDecoder() override;
     void SetSource(InputDataStream &sourceStream) override;
     void Reset() override;
+    bool IsReusable() override
+    {
+        return true;
+    }
     uint32_t SetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info) override;
     uint32_t Decode(uint32_t index, DecodeContext &context) override;
     uint32_t PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context) override;
@@ -79,10 +83,12 @@ private:
     InputDataStream *inputStreamPtr_ = nullptr;
     GifFileType *gifPtr_ = nullptr;
     uint32_t *localPixelMapBuffer_ = nullptr;
+    uint64_t localPixelMapBufferSize_ = 0;  // kept by Reset for the next source.
     uint32_t bgColor_ = 0;
     int32_t lastPixelMapIndex_ = -1;
     bool isLoadAllFrame_ = false;
     int32_t savedFrameIndex_ = -1;
+    std::shared_ptr<Media::DecodeCancelToken> cancelToken_;
 };
 } // namespace ImagePlugin
 } // namespace OHOS
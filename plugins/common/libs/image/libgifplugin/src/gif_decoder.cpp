@@ -56,6 +56,7 @@ GifDecoder::GifDecoder()
 GifDecoder::~GifDecoder()
 {
     Reset();
+    FreeLocalPixelMapBuffer();
 }
 
 void GifDecoder::SetSource(InputDataStream &sourceStream)
@@ -124,6 +125,7 @@ uint32_t GifDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &
     info.alphaType = PlAlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
     // only support RGBA pixel format for performance.
     info.pixelFormat = PlPixelFormat::RGBA_8888;
+    cancelToken_ = opts.cancelToken;
     return SUCCESS;
 }
 
@@ -183,7 +185,7 @@ void GifDecoder::Reset()
         DGifCloseFile(gifPtr_, nullptr);
         gifPtr_ = nullptr;
     }
-    FreeLocalPixelMapBuffer();  // free local pixelmap buffer
+    // the local pixelmap buffer is kept, the first frame of the next decoding refills it.
     inputStreamPtr_ = nullptr;
     isLoadAllFrame_ = false;
     lastPixelMapIndex_ = -1;
@@ -232,7 +234,11 @@ int32_t GifDecoder::InputStreamReader(GifFileType *gif, GifByteType *bytes, int3
         HiLog::Error(LABEL, "[InputStreamReader]callback buffer is null");
         return dataSize;
     }
-    inputStream->Read(size, bytes, size, dataSize);
+    // giflib owns the buffer, read straight into it, a short read at the end of the data is fine.
+    if (!inputStream->ReadInto(bytes, static_cast<uint32_t>(size), dataSize)) {
+        HiLog::Error(LABEL, "[InputStreamReader]read source stream failed");
+        return 0;
+    }
     return dataSize;
 }
 
@@ -266,6 +272,12 @@ uint32_t GifDecoder::CheckIndex(uint32_t index)
 uint32_t GifDecoder::OverlapFrame(uint32_t startIndex, uint32_t endIndex)
 {
     for (uint32_t frameIndex = startIndex; frameIndex <= endIndex; frameIndex++) {
+        if (cancelToken_ != nullptr && cancelToken_->IsCanceled()) {
+            // the frames before are overlapped, the next decoding continues from here.
+            lastPixelMapIndex_ = static_cast<int32_t>(frameIndex) - 1;
+            HiLog::Info(LABEL, "[OverlapFrame]decoding canceled at frame %{public}u", frameIndex);
+            return ERR_IMAGE_DECODE_CANCELED;
+        }
         const SavedImage *savedImage = gifPtr_->SavedImages + frameIndex;
         if (savedImage == nullptr) {
             HiLog::Error(LABEL, "[OverlapFrame]image frame %{public}u data is invalid", frameIndex);
@@ -332,31 +344,34 @@ bool GifDecoder::IsFramePreviousCoveredCurrent(const SavedImage *preSavedImage,
 
 uint32_t GifDecoder::AllocateLocalPixelMapBuffer()
 {
-    if (localPixelMapBuffer_ == nullptr) {
-        int32_t bgWidth = gifPtr_->SWidth;
-        int32_t bgHeight = gifPtr_->SHeight;
-        uint64_t pixelMapBufferSize = static_cast<uint64_t>(bgWidth) * bgHeight * sizeof(uint32_t);
-        // create local pixelmap buffer, next frame depends on the previous
-        if (pixelMapBufferSize > PIXEL_MAP_MAX_RAM_SIZE) {
-            HiLog::Error(LABEL, "[AllocateLocalPixelMapBuffer]pixelmap buffer size %{public}llu out of max size",
-                         static_cast<unsigned long long>(pixelMapBufferSize));
-            return ERR_IMAGE_TOO_LARGE;
-        }
+    int32_t bgWidth = gifPtr_->SWidth;
+    int32_t bgHeight = gifPtr_->SHeight;
+    uint64_t pixelMapBufferSize = static_cast<uint64_t>(bgWidth) * bgHeight * sizeof(uint32_t);
+    // create local pixelmap buffer, next frame depends on the previous
+    if (pixelMapBufferSize > PIXEL_MAP_MAX_RAM_SIZE) {
+        HiLog::Error(LABEL, "[AllocateLocalPixelMapBuffer]pixelmap buffer size %{public}llu out of max size",
+                     static_cast<unsigned long long>(pixelMapBufferSize));
+        return ERR_IMAGE_TOO_LARGE;
+    }
+    // the buffer of the last decoding is reused if it is large enough.
+    if (localPixelMapBuffer_ == nullptr || localPixelMapBufferSize_ < pixelMapBufferSize) {
+        FreeLocalPixelMapBuffer();
         localPixelMapBuffer_ = reinterpret_cast<uint32_t *>(malloc(pixelMapBufferSize));
         if (localPixelMapBuffer_ == nullptr) {
             HiLog::Error(LABEL, "[AllocateLocalPixelMapBuffer]allocate local pixelmap buffer memory error");
             return ERR_IMAGE_MALLOC_ABNORMAL;
         }
+        localPixelMapBufferSize_ = pixelMapBufferSize;
+    }
 #ifdef _WIN32
-        memset(localPixelMapBuffer_, bgColor_, pixelMapBufferSize);
+    memset(localPixelMapBuffer_, bgColor_, pixelMapBufferSize);
 #else
-        if (memset_s(localPixelMapBuffer_, pixelMapBufferSize, bgColor_, pixelMapBufferSize) != EOK) {
-            HiLog::Error(LABEL, "[DisposeFirstPixelMap]memset local pixelmap buffer background failed");
-            FreeLocalPixelMapBuffer();
-            return ERR_IMAGE_MALLOC_ABNORMAL;
-        }
-#endif
+    if (memset_s(localPixelMapBuffer_, pixelMapBufferSize, bgColor_, pixelMapBufferSize) != EOK) {
+        HiLog::Error(LABEL, "[DisposeFirstPixelMap]memset local pixelmap buffer background failed");
+        FreeLocalPixelMapBuffer();
+        return ERR_IMAGE_MALLOC_ABNORMAL;
     }
+#endif
     return SUCCESS;
 }
 
@@ -366,6 +381,7 @@ void GifDecoder::FreeLocalPixelMapBuffer()
         free(localPixelMapBuffer_);
         localPixelMapBuffer_ = nullptr;
     }
+    localPixelMapBufferSize_ = 0;
 }
 
 uint32_t GifDecoder::PaddingBgColor(const SavedImage *savedImage)
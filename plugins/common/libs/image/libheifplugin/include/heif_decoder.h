@@ -42,6 +42,8 @@ private:
     DISALLOW_COPY_AND_MOVE(HeifDecoder);
     bool AllocHeapBuffer(DecodeContext &context);
     bool IsHeifImageParaValid(PlSize heifSize, uint32_t bytesPerPixel);
+    PlSize GetTargetSize(const PixelDecodeOptions &opts, const PlSize &imageSize);
+    void SelectOutputSize(const PixelDecodeOptions &opts, PlSize &size);
     std::unique_ptr<HeifDecoderInterface> heifDecoderInterface_ = nullptr;
     PlSize heifSize_;
     int32_t bytesPerPixel_ = 0;
@@ -16,6 +16,7 @@
 #ifndef HEIF_DECODER_INTERFACE_H
 #define HEIF_DECODER_INTERFACE_H
 
+#include <vector>
 #include "abs_image_decoder.h"
 #include "image_plugin_type.h"
 #include "input_data_stream.h"
@@ -30,6 +31,17 @@ public:
     virtual void SetAllowPartial(const bool isAllowPartialImage) = 0;
     virtual bool ConversionSupported(const PlPixelFormat &plPixelFormat, int32_t &bytesPerPixel) = 0;
     virtual uint32_t OnGetPixels(const PlSize &dstSize, const uint32_t dstRowBytes, DecodeContext &context) = 0;
+    // sizes can be output without decoding the primary image at full resolution, such as embedded thumbnail
+    // items or reduced resolution decoding, empty if not supported.
+    virtual void GetSupportedSizes(std::vector<PlSize> &sizes)
+    {
+        sizes.clear();
+    }
+    // select the size of OnGetPixels output, one of GetSupportedSizes or the primary image size.
+    virtual bool SetOutputSize(const PlSize &size)
+    {
+        return false;
+    }
 };
 } // namespace ImagePlugin
 } // namespace OHOS
@@ -14,6 +14,8 @@
  */
 
 #include "heif_decoder.h"
+#include <algorithm>
+#include <vector>
 #include "media_errors.h"
 #include "securec.h"
 
@@ -46,6 +48,7 @@ uint32_t HeifDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions
         HiLog::Error(LABEL, "get image size failed, ret=%{public}u", ret);
         return ret;
     }
+    SelectOutputSize(opts, info.size);
     heifSize_ = info.size;
 
     if (heifDecoderInterface_->ConversionSupported(opts.desiredPixelFormat, bytesPerPixel_)) {
@@ -107,6 +110,52 @@ uint32_t HeifDecoder::GetImageSize(uint32_t index, PlSize &size)
     return SUCCESS;
 }
 
+PlSize HeifDecoder::GetTargetSize(const PixelDecodeOptions &opts, const PlSize &imageSize)
+{
+    // the crop rect is in coordinates of the primary image, so it must be decoded at full resolution.
+    if (opts.CropRect.width > 0 && opts.CropRect.height > 0) {
+        return imageSize;
+    }
+    if (opts.desiredSize.width > 0 && opts.desiredSize.height > 0) {
+        return opts.desiredSize;
+    }
+    PlSize target = imageSize;
+    if (opts.sampleSize > PixelDecodeOptions::DEFAULT_SAMPLE_SIZE) {
+        target.width = std::max(imageSize.width / opts.sampleSize, 1u);
+        target.height = std::max(imageSize.height / opts.sampleSize, 1u);
+    }
+    return target;
+}
+
+void HeifDecoder::SelectOutputSize(const PixelDecodeOptions &opts, PlSize &size)
+{
+    std::vector<PlSize> supportedSizes;
+    heifDecoderInterface_->GetSupportedSizes(supportedSizes);
+    if (supportedSizes.empty()) {
+        return;
+    }
+    // pick the smallest one still not smaller than the target, post process only needs to scale down then.
+    PlSize target = GetTargetSize(opts, size);
+    PlSize selected = size;
+    for (const PlSize &candidate : supportedSizes) {
+        if (candidate.width < target.width || candidate.height < target.height) {
+            continue;
+        }
+        if (static_cast<uint64_t>(candidate.width) * candidate.height <
+            static_cast<uint64_t>(selected.width) * selected.height) {
+            selected = candidate;
+        }
+    }
+    if (!heifDecoderInterface_->SetOutputSize(selected)) {
+        // decode the primary image at full resolution as before.
+        HiLog::Debug(LABEL, "set output size %{public}u x %{public}u failed", selected.width, selected.height);
+        return;
+    }
+    HiLog::Debug(LABEL, "output size %{public}u x %{public}u, image size %{public}u x %{public}u", selected.width,
+                 selected.height, size.width, size.height);
+    size = selected;
+}
+
 uint32_t HeifDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context)
 {
     // currently not support increment decode
@@ -21,6 +21,7 @@
 #include "abs_image_decoder.h"
 #include "abs_image_decompress_component.h"
 #include "hilog/log.h"
+#include "jpeg_parallel_decoder.h"
 #include "jpeg_utils.h"
 #include "jpeglib.h"
 #include "log_tags.h"
@@ -47,6 +48,10 @@ public:
     ~JpegDecoder() override;
     void SetSource(InputDataStream &sourceStream) override;
     void Reset() override;
+    bool IsReusable() override
+    {
+        return true;
+    }
     uint32_t SetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info) override;
     uint32_t Decode(uint32_t index, DecodeContext &context) override;
     uint32_t GetImageSize(uint32_t index, PlSize &size) override;
@@ -65,6 +70,8 @@ private:
     J_COLOR_SPACE GetDecodeFormat(PlPixelFormat format, PlPixelFormat &outputFormat);
     void CreateHwDecompressor();
     uint32_t DoSwDecode(DecodeContext &context);
+    uint32_t DoBufferedDecode(uint8_t *base, uint32_t rowStride);
+    int GetLastCompletedScan();
     void FinishOldDecompress();
     uint32_t DecodeHeader();
     uint32_t StartDecompress(const PixelDecodeOptions &opts);
@@ -81,6 +88,11 @@ private:
     AbsImageDecompressComponent *hwJpegDecompress_ = nullptr;
     JpegDecodingState state_ = JpegDecodingState::UNDECIDED;
     uint32_t streamPosition_ = 0;  // may be changed by other decoders, record it and restore if needed.
+    // progressive images of incomplete source are decoded in buffered image mode, each completed scan is
+    // rendered to the output as a full frame.
+    bool isOutputPassStarted_ = false;
+    int lastCompletedScan_ = 0;
+    uint32_t renderedScans_ = 0;
     PlPixelFormat outputFormat_ = PlPixelFormat::UNKNOWN;
     PixelDecodeOptions opts_;
     EXIFInfo exifInfo_;
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JPEG_PARALLEL_DECODER_H
+#define JPEG_PARALLEL_DECODER_H
+
+#include <cstdint>
+#include <vector>
+#include "abs_image_decoder.h"
+#include "input_data_stream.h"
+#include "jpeg_utils.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+// a horizontal band of MCU rows decoded by one thread.
+struct JpegBand {
+    uint32_t firstMcuRow = 0;   // first MCU row written to the output.
+    uint32_t endMcuRow = 0;     // MCU row after the last one written to the output.
+    uint32_t decodeFirstMcuRow = 0;  // decoding starts one MCU row earlier for upsampling context.
+    uint32_t decodeEndMcuRow = 0;
+};
+
+// decodes baseline jpeg with restart markers on several threads. the restart markers split the scan into
+// independent segments, each band of whole MCU rows is rebuilt to a small jpeg stream and decoded on its own.
+// only used when the whole source is in memory, any failure is left to the serial decoding.
+// the band threads of all the decodes in the process are bounded, a decode gets fewer bands or none when the
+// others use them up.
+class JpegParallelDecoder {
+public:
+    // info is the decompress struct of the serial decoding which has started decompress.
+    JpegParallelDecoder(const jpeg_decompress_struct &info, const uint8_t *data, uint32_t size,
+                        const PixelDecodeOptions &opts)
+        : info_(info), data_(data), size_(size), opts_(opts) {};
+    ~JpegParallelDecoder() = default;
+    static bool IsSupported(const jpeg_decompress_struct &info, InputDataStream &stream);
+    uint32_t Decode(uint8_t *base, uint32_t rowStride);
+
+private:
+    DISALLOW_COPY_AND_MOVE(JpegParallelDecoder);
+    bool ParseHeaders();
+    bool ScanRestartMarkers();
+    bool SplitBands(uint32_t bandCount);
+    uint32_t GetSegmentStart(uint32_t mcuRow) const;
+    uint32_t GetSegmentEnd(uint32_t mcuRow) const;
+    bool BuildBandStream(const JpegBand &band, std::vector<uint8_t> &stream) const;
+    uint32_t DecodeBand(const JpegBand &band, uint8_t *base, uint32_t rowStride) const;
+    const jpeg_decompress_struct &info_;
+    const uint8_t *data_ = nullptr;
+    uint32_t size_ = 0;
+    const PixelDecodeOptions &opts_;
+    uint32_t sofHeightOffset_ = 0;
+    uint32_t headerSize_ = 0;  // bytes from SOI to the end of SOS header.
+    uint32_t scanEnd_ = 0;     // offset of EOI marker.
+    uint32_t mcuPixelRows_ = 0;
+    uint32_t mcuRowsPerUnit_ = 0;  // the least MCU rows which always start at restart markers.
+    std::vector<uint32_t> restartOffsets_;
+    std::vector<JpegBand> bands_;
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // JPEG_PARALLEL_DECODER_H
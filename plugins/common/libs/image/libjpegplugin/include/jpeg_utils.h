@@ -32,6 +32,8 @@ namespace ImagePlugin {
 static constexpr uint8_t SET_JUMP_VALUE = 1;
 static constexpr uint8_t RW_LINE_NUM = 1;
 static constexpr uint16_t JPEG_BUFFER_SIZE = 1024;
+static constexpr uint8_t JPEG_MARKER_PREFIX = 0xFF;
+static constexpr uint32_t JPEG_EOI_SIZE = 2;
 static constexpr uint32_t JPEG_IMAGE_NUM = 1;
 static constexpr uint32_t PRINTF_SUCCESS = 0;
 
@@ -53,6 +55,8 @@ struct JpegSrcMgr : jpeg_source_mgr {
     InputDataStream *inputStream = nullptr;
     uint16_t bufferSize = JPEG_BUFFER_SIZE;
     ImagePlugin::DataStreamBuffer streamData;
+    // the data is copied here for the streams which have to copy anyway, instead of a buffer of the stream.
+    uint8_t buffer[JPEG_BUFFER_SIZE] = { 0 };
 };
 
 // redefine jpeg destination manager struct.
@@ -306,9 +306,26 @@ uint32_t JpegDecoder::DoSwDecode(DecodeContext &context)
         HiLog::Error(LABEL, "decode image buffer is null.");
         return ERR_IMAGE_INVALID_PARAMETER;
     }
+    if (decodeInfo_.buffered_image) {
+        return DoBufferedDecode(base, rowStride);
+    }
+    if (decodeInfo_.output_scanline == 0 && JpegParallelDecoder::IsSupported(decodeInfo_, *srcMgr_.inputStream)) {
+        JpegParallelDecoder parallelDecoder(decodeInfo_, srcMgr_.inputStream->GetDataPtr(),
+                                            static_cast<uint32_t>(srcMgr_.inputStream->GetStreamSize()), opts_);
+        // the serial decompress is untouched, it will be recreated on next decoding.
+        uint32_t ret = parallelDecoder.Decode(base, rowStride);
+        if (ret == Media::SUCCESS || ret == ERR_IMAGE_DECODE_CANCELED) {
+            return ret;
+        }
+        HiLog::Debug(LABEL, "parallel decode unavailable, decode serially.");
+    }
     srcMgr_.inputStream->Seek(streamPosition_);
     uint8_t *buffer = nullptr;
     while (decodeInfo_.output_scanline < decodeInfo_.output_height) {
+        if (opts_.IsCanceled()) {
+            HiLog::Info(LABEL, "decoding canceled, total read num:%{public}u.", decodeInfo_.output_scanline);
+            return ERR_IMAGE_DECODE_CANCELED;
+        }
         buffer = base + rowStride * decodeInfo_.output_scanline;
         uint32_t readLineNum = jpeg_read_scanlines(&decodeInfo_, &buffer, RW_LINE_NUM);
         if (readLineNum < RW_LINE_NUM) {
@@ -322,6 +339,72 @@ uint32_t JpegDecoder::DoSwDecode(DecodeContext &context)
     return Media::SUCCESS;
 }
 
+int JpegDecoder::GetLastCompletedScan()
+{
+    // absorb all the available data, the coefficients of every scan are kept by libjpeg.
+    int status = JPEG_SUSPENDED;
+    do {
+        status = jpeg_consume_input(&decodeInfo_);
+        if (status == JPEG_SCAN_COMPLETED || status == JPEG_REACHED_EOI) {
+            lastCompletedScan_ = decodeInfo_.input_scan_number;
+        }
+    } while (status != JPEG_SUSPENDED && status != JPEG_REACHED_EOI);
+    return lastCompletedScan_;
+}
+
+uint32_t JpegDecoder::DoBufferedDecode(uint8_t *base, uint32_t rowStride)
+{
+    srcMgr_.inputStream->Seek(streamPosition_);
+    if (!isOutputPassStarted_) {
+        // skip the scans completed since last output, only the latest one is rendered.
+        int scanNumber = GetLastCompletedScan();
+        if (scanNumber <= static_cast<int>(renderedScans_)) {
+            streamPosition_ = srcMgr_.inputStream->Tell();
+            // the last scan may be rendered before EOI arrives, then nothing is left to output.
+            if (jpeg_input_complete(&decodeInfo_) &&
+                static_cast<int>(renderedScans_) == decodeInfo_.input_scan_number) {
+                return Media::SUCCESS;
+            }
+            HiLog::Debug(LABEL, "no completed scan to output, rendered scans:%{public}u.", renderedScans_);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        if (jpeg_start_output(&decodeInfo_, scanNumber) != TRUE) {
+            streamPosition_ = srcMgr_.inputStream->Tell();
+            HiLog::Error(LABEL, "start output of scan %{public}d suspended.", scanNumber);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        isOutputPassStarted_ = true;
+    }
+    uint8_t *buffer = nullptr;
+    while (decodeInfo_.output_scanline < decodeInfo_.output_height) {
+        if (opts_.IsCanceled()) {
+            HiLog::Info(LABEL, "decoding of scan %{public}d canceled.", decodeInfo_.output_scan_number);
+            return ERR_IMAGE_DECODE_CANCELED;
+        }
+        buffer = base + rowStride * decodeInfo_.output_scanline;
+        uint32_t readLineNum = jpeg_read_scanlines(&decodeInfo_, &buffer, RW_LINE_NUM);
+        if (readLineNum < RW_LINE_NUM) {
+            streamPosition_ = srcMgr_.inputStream->Tell();
+            HiLog::Error(LABEL, "read line of scan %{public}d fail, total read num:%{public}u.",
+                         decodeInfo_.output_scan_number, decodeInfo_.output_scanline);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+    }
+    if (jpeg_finish_output(&decodeInfo_) != TRUE) {
+        streamPosition_ = srcMgr_.inputStream->Tell();
+        HiLog::Debug(LABEL, "finish output of scan %{public}d suspended.", decodeInfo_.output_scan_number);
+        return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+    }
+    streamPosition_ = srcMgr_.inputStream->Tell();
+    isOutputPassStarted_ = false;
+    renderedScans_ = static_cast<uint32_t>(decodeInfo_.output_scan_number);
+    HiLog::Debug(LABEL, "scan %{public}u rendered to output.", renderedScans_);
+    if (jpeg_input_complete(&decodeInfo_) && decodeInfo_.output_scan_number == decodeInfo_.input_scan_number) {
+        return Media::SUCCESS;
+    }
+    return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+}
+
 uint32_t JpegDecoder::Decode(uint32_t index, DecodeContext &context)
 {
     if (index >= JPEG_IMAGE_NUM) {
@@ -350,7 +433,7 @@ uint32_t JpegDecoder::Decode(uint32_t index, DecodeContext &context)
         state_ = JpegDecodingState::IMAGE_DECODING;
     }
     // only state JpegDecodingState::IMAGE_DECODING can go here.
-    if (hwJpegDecompress_ != nullptr) {
+    if (hwJpegDecompress_ != nullptr && !decodeInfo_.buffered_image) {
         srcMgr_.inputStream->Seek(streamPosition_);
         uint32_t ret = hwJpegDecompress_->Decompress(&decodeInfo_, srcMgr_.inputStream, context);
         if (ret == Media::SUCCESS) {
@@ -376,7 +459,12 @@ uint32_t JpegDecoder::Decode(uint32_t index, DecodeContext &context)
 
 void JpegDecoder::Reset()
 {
+    // back to the idle state, the permanent memory of libjpeg is kept for the next source.
+    if (state_ > JpegDecodingState::SOURCE_INITED) {
+        jpeg_abort_decompress(&decodeInfo_);
+    }
     srcMgr_.inputStream = nullptr;
+    state_ = JpegDecodingState::UNDECIDED;
 }
 
 uint32_t JpegDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &progContext)
@@ -398,6 +486,13 @@ uint32_t JpegDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext
     // get promote decode progress, in percentage: 0~100.
     progContext.totalProcessProgress =
         decodeInfo_.output_height == 0 ? 0 : (decodeInfo_.output_scanline * NUM_100) / decodeInfo_.output_height;
+    if (decodeInfo_.buffered_image) {
+        // the full frame is rendered again for every scan, it is done only after the last scan.
+        progContext.renderedScans = renderedScans_;
+        if (ret != Media::SUCCESS && progContext.totalProcessProgress >= NUM_100) {
+            progContext.totalProcessProgress = NUM_100 - 1;
+        }
+    }
     HiLog::Debug(LABEL, "incremental decode progress %{public}u.", progContext.totalProcessProgress);
     return ret;
 }
@@ -420,8 +515,8 @@ void JpegDecoder::FinishOldDecompress()
     if (state_ < JpegDecodingState::IMAGE_DECODING) {
         return;
     }
-    jpeg_destroy_decompress(&decodeInfo_);
-    CreateDecoder();
+    // abort instead of recreating the decompress struct, which keeps the error manager and the permanent memory.
+    jpeg_abort_decompress(&decodeInfo_);
 }
 
 bool JpegDecoder::IsMarker(uint8_t rawMarkerPrefix, uint8_t rawMarkderCode, uint8_t markerCode)
@@ -556,6 +651,13 @@ uint32_t JpegDecoder::StartDecompress(const PixelDecodeOptions &opts)
             return ERR_IMAGE_UNKNOWN_FORMAT;
         }
     }
+    // progressive image can't be output before all the scans arrive, so for incomplete source decode it in
+    // buffered image mode, which renders each completed scan as a full frame preview.
+    decodeInfo_.buffered_image =
+        (jpeg_has_multiple_scans(&decodeInfo_) && !srcMgr_.inputStream->IsStreamCompleted()) ? TRUE : FALSE;
+    isOutputPassStarted_ = false;
+    lastCompletedScan_ = 0;
+    renderedScans_ = 0;
     srcMgr_.inputStream->Seek(streamPosition_);
     if (jpeg_start_decompress(&decodeInfo_) != TRUE) {
         streamPosition_ = srcMgr_.inputStream->Tell();
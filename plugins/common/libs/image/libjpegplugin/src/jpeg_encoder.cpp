@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include "jerror.h"
 #include "jpeg_encoder.h"
 #include "media_errors.h"
@@ -38,6 +39,9 @@ constexpr uint8_t INDEX_ZERO = 0;
 constexpr uint8_t INDEX_ONE = 1;
 constexpr uint8_t INDEX_TWO = 2;
 constexpr uint8_t SHIFT_MASK = 1;
+// a rough compressed size in bytes per pixel is (quality + EXPECTED_SIZE_BASE) / EXPECTED_SIZE_DIVISOR.
+constexpr uint64_t EXPECTED_SIZE_BASE = 20;
+constexpr uint64_t EXPECTED_SIZE_DIVISOR = 160;
 
 JpegDstMgr::JpegDstMgr(OutputDataStream *stream) : outputStream(stream)
 {
@@ -178,6 +182,13 @@ uint32_t JpegEncoder::SetCommonConfig()
     jpeg_set_defaults(&encodeInfo_);
     int32_t quality = encodeOpts_.quality;
     jpeg_set_quality(&encodeInfo_, quality, TRUE);
+    // let the output stream reserve the space for the data at once.
+    if (dstMgr_.outputStream != nullptr) {
+        uint64_t pixels = static_cast<uint64_t>(encodeInfo_.image_width) * encodeInfo_.image_height;
+        uint64_t expectedSize = pixels * (static_cast<uint64_t>(quality) + EXPECTED_SIZE_BASE) /
+            EXPECTED_SIZE_DIVISOR;
+        dstMgr_.outputStream->SetExpectedSize(static_cast<uint32_t>(std::min<uint64_t>(expectedSize, UINT32_MAX)));
+    }
     return SUCCESS;
 }
 
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_parallel_decoder.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include "media_errors.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace OHOS::HiviewDFX;
+using namespace Media;
+static constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "JpegParallelDecoder" };
+namespace {
+// small images decode fast enough serially, threads are not worth starting.
+constexpr uint64_t PARALLEL_MIN_PIXELS = 1024 * 1024;
+constexpr uint32_t PARALLEL_MAX_THREADS = 8;
+constexpr uint32_t PARALLEL_MIN_BANDS = 2;
+constexpr uint32_t MARKER_SIZE = 2;
+constexpr uint32_t MARKER_LENGTH_SIZE = 2;
+constexpr uint32_t SOF_HEIGHT_OFFSET = 5;  // marker, length and precision are before the height.
+constexpr uint32_t BYTE_SHIFT = 8;
+constexpr uint8_t BYTE_MASK = 0xFF;
+constexpr uint8_t JPG_MARKER_PREFIX = 0XFF;
+constexpr uint8_t JPG_MARKER_STUFF = 0X00;
+constexpr uint8_t JPG_MARKER_SOI = 0XD8;
+constexpr uint8_t JPG_MARKER_EOI = 0XD9;
+constexpr uint8_t JPG_MARKER_SOS = 0XDA;
+constexpr uint8_t JPG_MARKER_SOF0 = 0XC0;
+constexpr uint8_t JPG_MARKER_SOF1 = 0XC1;
+constexpr uint8_t JPG_MARKER_RST0 = 0XD0;
+constexpr uint8_t JPG_MARKER_RSTN = 0XD7;
+constexpr uint32_t JPG_RESTART_MARKER_NUM = 8;
+
+// the band threads started by all the decodes, the calling threads decoding the first bands are not counted.
+std::atomic<uint32_t> g_bandThreads(0);
+
+uint32_t ReadBigEndian16(const uint8_t *data)
+{
+    return (static_cast<uint32_t>(data[0]) << BYTE_SHIFT) | data[1];
+}
+
+uint64_t GreatestCommonDivisor(uint64_t a, uint64_t b)
+{
+    while (b != 0) {
+        uint64_t remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+// reserve at most wanted band threads without exceeding limit in total, return the number reserved.
+uint32_t ReserveBandThreads(uint32_t wanted, uint32_t limit)
+{
+    uint32_t running = g_bandThreads.load();
+    uint32_t reserved = 0;
+    do {
+        reserved = (running < limit) ? std::min(wanted, limit - running) : 0;
+        if (reserved == 0) {
+            return 0;
+        }
+    } while (!g_bandThreads.compare_exchange_weak(running, running + reserved));
+    return reserved;
+}
+
+void ReleaseBandThreads(uint32_t count)
+{
+    g_bandThreads.fetch_sub(count);
+}
+} // namespace
+
+bool JpegParallelDecoder::IsSupported(const jpeg_decompress_struct &info, InputDataStream &stream)
+{
+    if (stream.GetStreamType() != BUFFER_SOURCE_TYPE || stream.GetDataPtr() == nullptr ||
+        !stream.IsStreamCompleted()) {
+        return false;
+    }
+    // single scan baseline image only, the whole scan is split by restart markers.
+    if (info.restart_interval == 0 || info.progressive_mode || info.comps_in_scan != info.num_components ||
+        info.quantize_colors) {
+        return false;
+    }
+    if (info.comps_in_scan == 1 && (info.cur_comp_info[0]->v_samp_factor != info.max_v_samp_factor ||
+        info.cur_comp_info[0]->h_samp_factor != info.max_h_samp_factor)) {
+        return false;
+    }
+    if (info.output_width != info.image_width || info.output_height != info.image_height) {
+        return false;
+    }
+    if (static_cast<uint64_t>(info.output_width) * info.output_height < PARALLEL_MIN_PIXELS) {
+        return false;
+    }
+    return std::thread::hardware_concurrency() > 1;
+}
+
+uint32_t JpegParallelDecoder::Decode(uint8_t *base, uint32_t rowStride)
+{
+    if (base == nullptr || data_ == nullptr) {
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    if (!ParseHeaders() || !ScanRestartMarkers()) {
+        HiLog::Debug(LABEL, "restart markers are not usable for parallel decoding.");
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    uint32_t maxThreads = std::min(std::thread::hardware_concurrency(), PARALLEL_MAX_THREADS);
+    uint32_t threadCount = (maxThreads > 1) ? ReserveBandThreads(maxThreads - 1, maxThreads - 1) : 0;
+    if (threadCount == 0) {
+        HiLog::Debug(LABEL, "no band thread is available.");
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    if (!SplitBands(threadCount + 1)) {
+        ReleaseBandThreads(threadCount);
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    // the image may have fewer bands than the threads reserved.
+    ReleaseBandThreads(threadCount - static_cast<uint32_t>(bands_.size() - 1));
+    threadCount = static_cast<uint32_t>(bands_.size() - 1);
+    std::vector<uint32_t> results(bands_.size(), SUCCESS);
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < bands_.size(); i++) {
+        workers.emplace_back([this, i, base, rowStride, &results]() {
+            results[i] = DecodeBand(bands_[i], base, rowStride);
+        });
+    }
+    results[0] = DecodeBand(bands_[0], base, rowStride);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    ReleaseBandThreads(threadCount);
+    if (std::find(results.begin(), results.end(), ERR_IMAGE_DECODE_CANCELED) != results.end()) {
+        HiLog::Info(LABEL, "decoding of jpeg bands canceled.");
+        return ERR_IMAGE_DECODE_CANCELED;
+    }
+    if (std::find_if(results.begin(), results.end(), [](uint32_t ret) { return ret != SUCCESS; }) !=
+        results.end()) {
+        HiLog::Error(LABEL, "decode jpeg bands failed.");
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    HiLog::Debug(LABEL, "decode jpeg in %{public}zu bands.", bands_.size());
+    return SUCCESS;
+}
+
+bool JpegParallelDecoder::ParseHeaders()
+{
+    if (size_ < MARKER_SIZE || data_[0] != JPG_MARKER_PREFIX || data_[1] != JPG_MARKER_SOI) {
+        return false;
+    }
+    uint32_t pos = MARKER_SIZE;
+    while (pos + MARKER_SIZE + MARKER_LENGTH_SIZE <= size_) {
+        if (data_[pos] != JPG_MARKER_PREFIX) {
+            return false;
+        }
+        uint8_t code = data_[pos + 1];
+        if (code == JPG_MARKER_PREFIX) {
+            pos++;  // fill bytes.
+            continue;
+        }
+        uint32_t length = ReadBigEndian16(data_ + pos + MARKER_SIZE);
+        if (code == JPG_MARKER_SOF0 || code == JPG_MARKER_SOF1) {
+            sofHeightOffset_ = pos + SOF_HEIGHT_OFFSET;
+        }
+        pos += MARKER_SIZE + length;
+        if (code == JPG_MARKER_SOS) {
+            headerSize_ = pos;
+            return sofHeightOffset_ != 0 && headerSize_ <= size_;
+        }
+    }
+    return false;
+}
+
+bool JpegParallelDecoder::ScanRestartMarkers()
+{
+    restartOffsets_.clear();
+    uint32_t pos = headerSize_;
+    while (pos + 1 < size_) {
+        auto next = static_cast<const uint8_t *>(memchr(data_ + pos, JPG_MARKER_PREFIX, size_ - pos - 1));
+        if (next == nullptr) {
+            break;
+        }
+        pos = static_cast<uint32_t>(next - data_);
+        uint8_t code = data_[pos + 1];
+        if (code == JPG_MARKER_STUFF || code == JPG_MARKER_PREFIX) {
+            pos += (code == JPG_MARKER_STUFF) ? MARKER_SIZE : 1;
+            continue;
+        }
+        if (code >= JPG_MARKER_RST0 && code <= JPG_MARKER_RSTN) {
+            restartOffsets_.push_back(pos);
+            pos += MARKER_SIZE;
+            continue;
+        }
+        if (code != JPG_MARKER_EOI) {
+            // DNL or more scans follow, can not be split.
+            return false;
+        }
+        scanEnd_ = pos;
+        uint64_t mcuCount = static_cast<uint64_t>(info_.MCUs_per_row) * info_.MCU_rows_in_scan;
+        uint64_t intervalCount = (mcuCount + info_.restart_interval - 1) / info_.restart_interval;
+        return restartOffsets_.size() + 1 == intervalCount;
+    }
+    // truncated data, leave the partial output to serial decoding.
+    return false;
+}
+
+bool JpegParallelDecoder::SplitBands(uint32_t bandCount)
+{
+    uint64_t mcusPerRow = info_.MCUs_per_row;
+    uint64_t restartInterval = info_.restart_interval;
+    // least common multiple of both, divided by MCUs per row.
+    mcuRowsPerUnit_ = static_cast<uint32_t>(restartInterval / GreatestCommonDivisor(mcusPerRow, restartInterval));
+    mcuPixelRows_ = DCTSIZE * info_.max_v_samp_factor;
+    uint32_t mcuRows = info_.MCU_rows_in_scan;
+    uint32_t unitCount = (mcuRows + mcuRowsPerUnit_ - 1) / mcuRowsPerUnit_;
+    bandCount = std::min(bandCount, unitCount);
+    if (bandCount < PARALLEL_MIN_BANDS) {
+        return false;
+    }
+    bands_.clear();
+    for (uint32_t i = 0; i < bandCount; i++) {
+        JpegBand band;
+        band.firstMcuRow = (unitCount * i / bandCount) * mcuRowsPerUnit_;
+        band.endMcuRow = std::min((unitCount * (i + 1) / bandCount) * mcuRowsPerUnit_, mcuRows);
+        // one more unit on each side, so upsampling of the boundary rows sees the same neighbours.
+        band.decodeFirstMcuRow = (band.firstMcuRow == 0) ? 0 : band.firstMcuRow - mcuRowsPerUnit_;
+        band.decodeEndMcuRow = std::min(band.endMcuRow + mcuRowsPerUnit_, mcuRows);
+        bands_.push_back(band);
+    }
+    return true;
+}
+
+uint32_t JpegParallelDecoder::GetSegmentStart(uint32_t mcuRow) const
+{
+    uint64_t interval = static_cast<uint64_t>(mcuRow) * info_.MCUs_per_row / info_.restart_interval;
+    return (interval == 0) ? headerSize_ : restartOffsets_[interval - 1] + MARKER_SIZE;
+}
+
+uint32_t JpegParallelDecoder::GetSegmentEnd(uint32_t mcuRow) const
+{
+    if (mcuRow >= info_.MCU_rows_in_scan) {
+        return scanEnd_;
+    }
+    uint64_t interval = static_cast<uint64_t>(mcuRow) * info_.MCUs_per_row / info_.restart_interval;
+    return restartOffsets_[interval - 1];
+}
+
+bool JpegParallelDecoder::BuildBandStream(const JpegBand &band, std::vector<uint8_t> &stream) const
+{
+    uint32_t segmentStart = GetSegmentStart(band.decodeFirstMcuRow);
+    uint32_t segmentEnd = GetSegmentEnd(band.decodeEndMcuRow);
+    if (segmentStart > segmentEnd) {
+        return false;
+    }
+    stream.resize(headerSize_ + (segmentEnd - segmentStart) + MARKER_SIZE);
+    uint8_t *dst = stream.data();
+    memcpy(dst, data_, headerSize_);
+    uint32_t firstRow = band.decodeFirstMcuRow * mcuPixelRows_;
+    uint32_t height = std::min(band.decodeEndMcuRow * mcuPixelRows_, info_.image_height) - firstRow;
+    dst[sofHeightOffset_] = static_cast<uint8_t>(height >> BYTE_SHIFT);
+    dst[sofHeightOffset_ + 1] = static_cast<uint8_t>(height & BYTE_MASK);
+    memcpy(dst + headerSize_, data_ + segmentStart, segmentEnd - segmentStart);
+    // the band starts a new scan, restart markers are numbered from RST0 again.
+    auto first = std::lower_bound(restartOffsets_.begin(), restartOffsets_.end(), segmentStart);
+    auto last = std::lower_bound(first, restartOffsets_.end(), segmentEnd);
+    uint32_t index = 0;
+    for (auto iter = first; iter != last; ++iter, ++index) {
+        dst[headerSize_ + (*iter - segmentStart) + 1] = JPG_MARKER_RST0 + (index % JPG_RESTART_MARKER_NUM);
+    }
+    dst[stream.size() - MARKER_SIZE] = JPG_MARKER_PREFIX;
+    dst[stream.size() - 1] = JPG_MARKER_EOI;
+    return true;
+}
+
+uint32_t JpegParallelDecoder::DecodeBand(const JpegBand &band, uint8_t *base, uint32_t rowStride) const
+{
+    std::vector<uint8_t> stream;
+    if (!BuildBandStream(band, stream)) {
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    std::vector<uint8_t> skipRow(rowStride);
+    uint32_t skipRows = (band.firstMcuRow - band.decodeFirstMcuRow) * mcuPixelRows_;
+    uint32_t outputFirstRow = band.firstMcuRow * mcuPixelRows_;
+    uint32_t outputEndRow = std::min(band.endMcuRow * mcuPixelRows_, info_.output_height);
+    jpeg_decompress_struct decodeInfo;
+    ErrorMgr jerr;
+    decodeInfo.err = jpeg_std_error(&jerr);
+    jerr.error_exit = ErrorExit;
+    jerr.output_message = OutputErrorMessage;
+    jpeg_create_decompress(&decodeInfo);
+    if (setjmp(jerr.setjmp_buffer)) {
+        jpeg_destroy_decompress(&decodeInfo);
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    jpeg_mem_src(&decodeInfo, stream.data(), stream.size());
+    if (jpeg_read_header(&decodeInfo, TRUE) != JPEG_HEADER_OK) {
+        jpeg_destroy_decompress(&decodeInfo);
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    decodeInfo.out_color_space = info_.out_color_space;
+    decodeInfo.dct_method = info_.dct_method;
+    decodeInfo.do_fancy_upsampling = info_.do_fancy_upsampling;
+    decodeInfo.do_block_smoothing = info_.do_block_smoothing;
+    if (!jpeg_start_decompress(&decodeInfo) || decodeInfo.output_width != info_.output_width ||
+        decodeInfo.output_components != info_.output_components) {
+        jpeg_destroy_decompress(&decodeInfo);
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    uint32_t ret = SUCCESS;
+    uint8_t *row = skipRow.data();
+    uint32_t endRow = skipRows + (outputEndRow - outputFirstRow);
+    while (decodeInfo.output_scanline < endRow) {
+        uint32_t scanline = decodeInfo.output_scanline;
+        // checked at each MCU row, the restart intervals inside a row are not visible through the scanlines.
+        if (scanline % mcuPixelRows_ == 0 && opts_.IsCanceled()) {
+            ret = ERR_IMAGE_DECODE_CANCELED;
+            break;
+        }
+        row = (scanline < skipRows) ? skipRow.data() :
+            (base + static_cast<uint64_t>(rowStride) * (outputFirstRow + scanline - skipRows));
+        if (jpeg_read_scanlines(&decodeInfo, &row, RW_LINE_NUM) != RW_LINE_NUM) {
+            ret = ERR_IMAGE_DECODE_ABNORMAL;
+            break;
+        }
+    }
+    // any warning means the data was repaired somehow, the serial result may differ.
+    if (ret == SUCCESS && jerr.num_warnings != 0) {
+        ret = ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    jpeg_destroy_decompress(&decodeInfo);
+    return ret;
+}
+} // namespace ImagePlugin
+} // namespace OHOS
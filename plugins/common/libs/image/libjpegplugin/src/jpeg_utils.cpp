@@ -78,7 +78,24 @@ boolean FillInputBuffer(j_decompress_ptr dinfo)
         return FALSE;
     }
     src->inputStream->Seek(preReadPos);
-    if (!src->inputStream->Read(src->bufferSize, src->streamData)) {
+    if (src->inputStream->GetContiguousSize() < src->bufferSize) {
+        // the stream would copy or merge the data for a borrowed buffer, so copy it into our own buffer.
+        uint32_t readSize = 0;
+        if (!src->inputStream->ReadInto(src->buffer, src->bufferSize, readSize)) {
+            HiLog::Error(LABEL, "fill input buffer error, read source stream failed.");
+            return FALSE;
+        }
+        if (readSize == 0 && src->inputStream->IsStreamCompleted()) {
+            // no more data, insert a fake EOI marker like the stdio source of libjpeg.
+            WARNMS(dinfo, JWRN_JPEG_EOF);
+            src->buffer[0] = JPEG_MARKER_PREFIX;
+            src->buffer[1] = JPEG_EOI;
+            readSize = JPEG_EOI_SIZE;
+        }
+        src->streamData.inputStreamBuffer = src->buffer;
+        src->streamData.bufferSize = src->bufferSize;
+        src->streamData.dataSize = readSize;
+    } else if (!src->inputStream->Read(src->bufferSize, src->streamData)) {
         HiLog::Error(LABEL, "fill input buffer error, read source stream failed.");
         return FALSE;
     }
@@ -16,6 +16,7 @@
 #ifndef PNG_DECODER_H
 #define PNG_DECODER_H
 
+#include <vector>
 #include "abs_image_decoder.h"
 #include "hilog/log.h"
 #include "input_data_stream.h"
@@ -53,6 +54,10 @@ public:
     PngDecoder &operator=(const PngDecoder &) = delete;
     void SetSource(InputDataStream &sourceStream) override;
     void Reset() override;
+    bool IsReusable() override
+    {
+        return true;
+    }
     uint32_t SetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info) override;
     uint32_t Decode(uint32_t index, DecodeContext &context) override;
     uint32_t PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context) override;
@@ -70,6 +75,7 @@ private:
     uint32_t PushCurrentToDecode(InputDataStream *stream);
     uint32_t IncrementalReadRows(InputDataStream *stream);
     uint32_t PushAllToDecode(InputDataStream *stream, size_t bufferSize, size_t length);
+    bool IsDecodeCanceled() const;
     static void GetAllRows(png_structp pngPtr, png_bytep row, png_uint_32 rowNum, int pass);
     static void GetInterlacedRows(png_structp pngPtr, png_bytep row, png_uint_32 rowNum, int pass);
     static int32_t ReadUserChunk(png_structp png_ptr, png_unknown_chunkp chunk);
@@ -103,6 +109,8 @@ private:
     uint32_t outputRowsNum_ = 0;
     PngDecodingState state_ = PngDecodingState::UNDECIDED;
     uint32_t streamPosition_ = 0;  // may be changed by other decoders, record it and restore if needed.
+    // the data read from the streams which copy anyway, reused instead of a buffer of the stream per read.
+    std::vector<uint8_t> readBuffer_;
     PlPixelFormat outputFormat_ = PlPixelFormat::UNKNOWN;
     PlAlphaType alphaType_ = PlAlphaType::IMAGE_ALPHA_TYPE_UNKNOWN;
     PixelDecodeOptions opts_;
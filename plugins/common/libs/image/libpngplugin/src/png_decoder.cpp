@@ -60,6 +60,18 @@ PngDecoder::~PngDecoder()
 
 void PngDecoder::SetSource(InputDataStream &sourceStream)
 {
+    // a reused decoder needs a new png struct, which can't be rewound.
+    if (state_ > PngDecodingState::SOURCE_INITED) {
+        if (!FinishOldDecompress()) {
+            HiLog::Error(LABEL, "finish old decompress fail on set source.");
+        }
+        // the nine patch belongs to the last source.
+        if (ninePatch_.patch_ != nullptr) {
+            free(ninePatch_.patch_);
+            ninePatch_.patch_ = nullptr;
+            ninePatch_.patchSize_ = 0;
+        }
+    }
     inputStreamPtr_ = &sourceStream;
     state_ = PngDecodingState::SOURCE_INITED;
 }
@@ -289,6 +301,10 @@ uint32_t PngDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext
         if (ret != ERR_IMAGE_SOURCE_DATA_INCOMPLETE) {
             HiLog::Error(LABEL, "Incremental decode fail, ret:%{public}u", ret);
         }
+        if (ret == ERR_IMAGE_DECODE_CANCELED) {
+            // part of a chunk may have been consumed, the decoding can't be resumed.
+            state_ = PngDecodingState::IMAGE_ERROR;
+        }
     } else {
         if (outputRowsNum_ != pngImageInfo_.height) {
             HiLog::Debug(LABEL, "Incremental decode incomplete, outputRowsNum:%{public}u, height:%{public}u",
@@ -472,6 +488,10 @@ uint32_t PngDecoder::ProcessData(png_structp pngStructPtr, png_infop infoStructP
         return ERR_IMAGE_INVALID_PARAMETER;
     }
     while (totalSize > 0) {
+        if (IsDecodeCanceled()) {
+            HiLog::Info(LABEL, "decoding canceled, output rows:%{public}u.", outputRowsNum_);
+            return ERR_IMAGE_DECODE_CANCELED;
+        }
         size_t readSize = (bufferSize < totalSize) ? bufferSize : totalSize;
         uint32_t ret = IncrementalRead(sourceStream, readSize, streamData);
         if (ret != SUCCESS) {
@@ -534,7 +554,20 @@ uint32_t PngDecoder::IncrementalRead(InputDataStream *stream, uint32_t desiredSi
     }
 
     uint32_t curPos = stream->Tell();
-    if (!stream->Read(desiredSize, outData)) {
+    if (stream->GetContiguousSize() < desiredSize) {
+        // the stream would copy or merge the data for a borrowed buffer, so copy it into our own buffer.
+        if (readBuffer_.size() < desiredSize) {
+            readBuffer_.resize(desiredSize);
+        }
+        uint32_t readSize = 0;
+        if (!stream->ReadInto(readBuffer_.data(), desiredSize, readSize) || readSize == 0) {
+            HiLog::Debug(LABEL, "read data fail.");
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        outData.inputStreamBuffer = readBuffer_.data();
+        outData.bufferSize = readBuffer_.size();
+        outData.dataSize = readSize;
+    } else if (!stream->Read(desiredSize, outData)) {
         HiLog::Debug(LABEL, "read data fail.");
         return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
     }
@@ -737,13 +770,13 @@ uint32_t PngDecoder::PushAllToDecode(InputDataStream *stream, size_t bufferSize,
         return ERR_IMAGE_INVALID_PARAMETER;
     }
     DataStreamBuffer ReadData;
-    if (ProcessData(pngStructPtr_, pngInfoPtr_, stream, ReadData, bufferSize, length) != SUCCESS) {
+    uint32_t ret = ProcessData(pngStructPtr_, pngInfoPtr_, stream, ReadData, bufferSize, length);
+    if (ret != SUCCESS) {
         HiLog::Error(LABEL, "ProcessData return false, bufferSize:%{public}zu, length:%{public}zu.", bufferSize,
                      length);
-        return ERR_IMAGE_DECODE_ABNORMAL;
+        return (ret == ERR_IMAGE_DECODE_CANCELED) ? ret : ERR_IMAGE_DECODE_ABNORMAL;
     }
     bool iend = false;
-    uint32_t ret = 0;
     while (true) {
         // Parse chunk length and type.
         ret = IncrementalRead(stream, CHUNK_SIZE, ReadData);
@@ -766,6 +799,12 @@ uint32_t PngDecoder::PushAllToDecode(InputDataStream *stream, size_t bufferSize,
     return ret;
 }
 
+bool PngDecoder::IsDecodeCanceled() const
+{
+    // only the rows decoding can be canceled, the header parsing is short.
+    return state_ == PngDecodingState::IMAGE_DECODING && opts_.IsCanceled();
+}
+
 uint32_t PngDecoder::IncrementalReadRows(InputDataStream *stream)
 {
     if (stream == nullptr) {
@@ -829,6 +868,10 @@ uint32_t PngDecoder::PushCurrentToDecode(InputDataStream *stream)
     DataStreamBuffer ReadData;
     uint32_t ret = 0;
     while (incrementalLength_ < idatLength_) {
+        if (IsDecodeCanceled()) {
+            HiLog::Info(LABEL, "push current stream canceled, output rows:%{public}u.", outputRowsNum_);
+            return ERR_IMAGE_DECODE_CANCELED;
+        }
         const size_t targetSize = std::min(DECODE_BUFFER_SIZE, idatLength_ - incrementalLength_);
         ret = IncrementalRead(stream, targetSize, ReadData);
         if (ret != SUCCESS) {
@@ -850,6 +893,10 @@ uint32_t PngDecoder::PushCurrentToDecode(InputDataStream *stream)
         idatLength_ = png_get_uint_32(chunk) + CHUNK_DATA_LEN;
         incrementalLength_ = 0;
         while (incrementalLength_ < idatLength_) {
+            if (IsDecodeCanceled()) {
+                HiLog::Info(LABEL, "push current stream canceled, output rows:%{public}u.", outputRowsNum_);
+                return ERR_IMAGE_DECODE_CANCELED;
+            }
             const size_t targetSize = std::min(DECODE_BUFFER_SIZE, idatLength_ - incrementalLength_);
             ret = IncrementalRead(stream, targetSize, ReadData);
             if (ret != SUCCESS) {
@@ -955,7 +1002,7 @@ uint32_t PngDecoder::DoOneTimeDecode(DecodeContext &context)
 
 bool PngDecoder::FinishOldDecompress()
 {
-    if (state_ < PngDecodingState::IMAGE_DECODING) {
+    if (state_ <= PngDecodingState::SOURCE_INITED) {
         return true;
     }
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WBMP_DECODER_H
+#define WBMP_DECODER_H
+
+#include <cstdint>
+#include <vector>
+#include "abs_image_decoder.h"
+#include "hilog/log.h"
+#include "log_tags.h"
+#include "plugin_class_base.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+enum class WbmpDecodingState : int32_t {
+    UNDECIDED = 0,
+    SOURCE_INITED = 1,
+    BASE_INFO_PARSED = 2,
+    IMAGE_DECODING = 3,
+    IMAGE_ERROR = 4,
+    IMAGE_DECODED = 5
+};
+
+class WbmpDecoder : public AbsImageDecoder, public OHOS::MultimediaPlugin::PluginClassBase {
+public:
+    WbmpDecoder() = default;
+    virtual ~WbmpDecoder() override {};
+    void SetSource(InputDataStream &sourceStream) override;
+    void Reset() override;
+    uint32_t SetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info) override;
+    uint32_t Decode(uint32_t index, DecodeContext &context) override;
+    uint32_t GetImageSize(uint32_t index, PlSize &size) override;
+    uint32_t PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context) override;
+    static uint32_t GetSampledSize(uint32_t size, uint32_t sampleSize);
+
+private:
+    DISALLOW_COPY_AND_MOVE(WbmpDecoder);
+    bool DecodeHeader();
+    uint32_t DoDecode(uint8_t *dst, uint32_t rowBytes, uint32_t &decodedRows);
+    void ExpandRow(const uint8_t *src, uint8_t *dst);
+    const uint8_t *GetSourceRow(uint32_t srcRow);
+    uint32_t GetSampledCoord(uint32_t index, uint32_t size) const;
+    uint32_t ConvertToOutputFormat(PlPixelFormat format, PlPixelFormat &outputFormat);
+    uint32_t SetContextPixelsBuffer(uint64_t byteCount, DecodeContext &context);
+    uint32_t SetShareMemBuffer(uint64_t byteCount, DecodeContext &context);
+    InputDataStream *stream_ = nullptr;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t dataOffset_ = 0;
+    uint32_t srcRowBytes_ = 0;
+    uint32_t sampleSize_ = 1;
+    uint32_t outputBytesPerPixel_ = 0;
+    bool allowPartialImage_ = true;
+    std::vector<uint8_t> rowBuffer_;
+    WbmpDecodingState state_ = WbmpDecodingState::UNDECIDED;
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // WBMP_DECODER_H
@@ -0,0 +1,520 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wbmp_decoder.h"
+#include <algorithm>
+#include <cstring>
+#include "image_utils.h"
+#include "media_errors.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace OHOS::HiviewDFX;
+using namespace Media;
+using namespace std;
+static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "WbmpDecoder" };
+namespace {
+constexpr uint32_t WBMP_IMAGE_NUM = 1;
+constexpr uint32_t WBMP_HEADER_MAX_SIZE = 32;
+constexpr uint32_t WBMP_MAX_SIZE = 0xFFFF;
+constexpr uint8_t WBMP_FIX_HEADER_MASK = 0x9F;
+constexpr uint8_t MBF_SHIFT_BITS = 7;
+constexpr uint8_t MBF_LOW_BIT_MASK = 0x7F;
+constexpr uint8_t MBF_HIGH_BIT_MASK = 0x80;
+constexpr uint64_t MBF_OVERFLOW_MASK = 0xFE00000000000000;
+constexpr uint32_t BITS_PER_BYTE = 8;
+constexpr uint32_t BYTE_INDEX_SHIFT = 3;
+constexpr uint32_t BIT_INDEX_MASK = 7;
+// one nibble of the source row spreads to four pixels at a time.
+constexpr uint32_t NIBBLE_PIXELS = 4;
+constexpr uint32_t NIBBLE_COUNT = 16;
+constexpr uint32_t NIBBLE_MASK = 0xF;
+constexpr uint32_t WHITE_NIBBLE = 0xF;
+constexpr uint32_t ALPHA_8_BYTES = 1;
+constexpr uint32_t RGB_565_BYTES = 2;
+constexpr uint32_t RGBA_8888_BYTES = 4;
+
+template <typename T>
+struct WbmpNibbleTable {
+    T pixels[NIBBLE_COUNT][NIBBLE_PIXELS];
+};
+
+// bit 1 is white and bit 0 is black, the most significant bit is the leftmost pixel.
+template <typename T>
+WbmpNibbleTable<T> MakeNibbleTable(T black, T white)
+{
+    WbmpNibbleTable<T> table;
+    for (uint32_t nibble = 0; nibble < NIBBLE_COUNT; nibble++) {
+        for (uint32_t i = 0; i < NIBBLE_PIXELS; i++) {
+            bool isWhite = (nibble >> (NIBBLE_PIXELS - 1 - i)) & 1;
+            table.pixels[nibble][i] = isWhite ? white : black;
+        }
+    }
+    return table;
+}
+
+uint32_t MakeOpaquePixel(uint8_t value)
+{
+    // same bytes in RGBA and BGRA order, only alpha differs from the color channels.
+    uint8_t bytes[RGBA_8888_BYTES] = { value, value, value, UINT8_MAX };
+    uint32_t pixel = 0;
+    memcpy(&pixel, bytes, sizeof(pixel));
+    return pixel;
+}
+
+const WbmpNibbleTable<uint8_t> &GetAlpha8Table()
+{
+    static const WbmpNibbleTable<uint8_t> table = MakeNibbleTable<uint8_t>(0, UINT8_MAX);
+    return table;
+}
+
+const WbmpNibbleTable<uint16_t> &GetRgb565Table()
+{
+    static const WbmpNibbleTable<uint16_t> table = MakeNibbleTable<uint16_t>(0, UINT16_MAX);
+    return table;
+}
+
+const WbmpNibbleTable<uint32_t> &GetRgba8888Table()
+{
+    static const WbmpNibbleTable<uint32_t> table = MakeNibbleTable<uint32_t>(MakeOpaquePixel(0),
+                                                                             MakeOpaquePixel(UINT8_MAX));
+    return table;
+}
+
+template <typename T>
+void ExpandUnitRow(const uint8_t *src, uint8_t *dst, uint32_t width, const WbmpNibbleTable<T> &table)
+{
+    uint32_t x = 0;
+    for (; x + NIBBLE_PIXELS <= width; x += NIBBLE_PIXELS) {
+        uint32_t shift = NIBBLE_PIXELS - (x & NIBBLE_PIXELS);
+        uint32_t nibble = (src[x >> BYTE_INDEX_SHIFT] >> shift) & NIBBLE_MASK;
+        memcpy(dst + x * sizeof(T), table.pixels[nibble], sizeof(table.pixels[nibble]));
+    }
+    if (x < width) {
+        uint32_t shift = NIBBLE_PIXELS - (x & NIBBLE_PIXELS);
+        uint32_t nibble = (src[x >> BYTE_INDEX_SHIFT] >> shift) & NIBBLE_MASK;
+        memcpy(dst + x * sizeof(T), table.pixels[nibble], (width - x) * sizeof(T));
+    }
+}
+
+template <typename T>
+void ExpandSampledRow(const uint8_t *src, uint8_t *dst, uint32_t dstWidth, uint32_t startX, uint32_t sampleSize,
+                      const WbmpNibbleTable<T> &table)
+{
+    const T colors[] = { table.pixels[0][0], table.pixels[WHITE_NIBBLE][0] };
+    T *out = reinterpret_cast<T *>(dst);
+    uint32_t x = startX;
+    for (uint32_t i = 0; i < dstWidth; i++, x += sampleSize) {
+        uint32_t bit = (src[x >> BYTE_INDEX_SHIFT] >> (BIT_INDEX_MASK - (x & BIT_INDEX_MASK))) & 1;
+        out[i] = colors[bit];
+    }
+}
+
+bool ReadByte(const uint8_t *data, uint32_t dataSize, uint32_t &offset, uint8_t &value)
+{
+    if (offset >= dataSize) {
+        return false;
+    }
+    value = data[offset];
+    offset++;
+    return true;
+}
+
+// read a multi-byte integer, 7 bits per byte and the high bit marks the continuation.
+bool ReadMultiByteInt(const uint8_t *data, uint32_t dataSize, uint32_t &offset, uint64_t &value)
+{
+    uint64_t result = 0;
+    uint8_t byte = 0;
+    do {
+        if (result & MBF_OVERFLOW_MASK) {
+            return false;
+        }
+        if (!ReadByte(data, dataSize, offset, byte)) {
+            return false;
+        }
+        result = (result << MBF_SHIFT_BITS) | (byte & MBF_LOW_BIT_MASK);
+    } while (byte & MBF_HIGH_BIT_MASK);
+    value = result;
+    return true;
+}
+} // namespace
+
+void WbmpDecoder::SetSource(InputDataStream &sourceStream)
+{
+    stream_ = &sourceStream;
+    state_ = WbmpDecodingState::SOURCE_INITED;
+}
+
+void WbmpDecoder::Reset()
+{
+    if (stream_ != nullptr) {
+        stream_->Seek(0);
+    }
+    width_ = 0;
+    height_ = 0;
+    dataOffset_ = 0;
+    srcRowBytes_ = 0;
+    sampleSize_ = 1;
+}
+
+uint32_t WbmpDecoder::GetImageSize(uint32_t index, PlSize &size)
+{
+    if (index >= WBMP_IMAGE_NUM) {
+        HiLog::Error(LABEL, "GetImageSize failed, invalid index:%{public}u, range:%{public}u", index, WBMP_IMAGE_NUM);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    if (state_ < WbmpDecodingState::SOURCE_INITED) {
+        HiLog::Error(LABEL, "GetImageSize failed, invalid state:%{public}d", state_);
+        return ERR_MEDIA_INVALID_OPERATION;
+    }
+    if (state_ >= WbmpDecodingState::BASE_INFO_PARSED) {
+        size.width = width_;
+        size.height = height_;
+        return SUCCESS;
+    }
+    if (!DecodeHeader()) {
+        HiLog::Error(LABEL, "GetImageSize failed, decode header failed, state=%{public}d", state_);
+        return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+    }
+    size.width = width_;
+    size.height = height_;
+    state_ = WbmpDecodingState::BASE_INFO_PARSED;
+    return SUCCESS;
+}
+
+uint32_t WbmpDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info)
+{
+    if (index >= WBMP_IMAGE_NUM) {
+        HiLog::Error(LABEL, "SetDecodeOptions failed, invalid index:%{public}u, range:%{public}u", index,
+                     WBMP_IMAGE_NUM);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    if (state_ < WbmpDecodingState::SOURCE_INITED) {
+        HiLog::Error(LABEL, "SetDecodeOptions failed, invalid state %{public}d", state_);
+        return ERR_MEDIA_INVALID_OPERATION;
+    }
+    if (state_ >= WbmpDecodingState::IMAGE_DECODING) {
+        Reset();
+        state_ = WbmpDecodingState::SOURCE_INITED;
+    }
+    if (state_ < WbmpDecodingState::BASE_INFO_PARSED) {
+        if (!DecodeHeader()) {
+            HiLog::Error(LABEL, "SetDecodeOptions failed, decode header failed, state=%{public}d", state_);
+            return ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+        }
+        state_ = WbmpDecodingState::BASE_INFO_PARSED;
+    }
+    outputBytesPerPixel_ = ConvertToOutputFormat(opts.desiredPixelFormat, info.pixelFormat);
+    sampleSize_ = std::max(opts.sampleSize, 1u);
+    allowPartialImage_ = opts.allowPartialImage;
+    info.size.width = GetSampledSize(width_, sampleSize_);
+    info.size.height = GetSampledSize(height_, sampleSize_);
+    // black pixels are transparent in ALPHA_8, which holds the alpha only.
+    info.alphaType = (info.pixelFormat == PlPixelFormat::ALPHA_8) ? PlAlphaType::IMAGE_ALPHA_TYPE_PREMUL :
+        PlAlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    state_ = WbmpDecodingState::IMAGE_DECODING;
+    return SUCCESS;
+}
+
+uint32_t WbmpDecoder::SetShareMemBuffer(uint64_t byteCount, DecodeContext &context)
+{
+    int fd = AshmemCreate("WBMP RawData", byteCount);
+    if (fd < 0) {
+        return ERR_SHAMEM_DATA_ABNORMAL;
+    }
+    int result = AshmemSetProt(fd, PROT_READ | PROT_WRITE);
+    if (result < 0) {
+        ::close(fd);
+        return ERR_SHAMEM_DATA_ABNORMAL;
+    }
+    void* ptr = ::mmap(nullptr, byteCount, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        ::close(fd);
+        return ERR_SHAMEM_DATA_ABNORMAL;
+    }
+    context.pixelsBuffer.buffer = ptr;
+    void *fdBuffer = new int32_t();
+    if (fdBuffer == nullptr) {
+        ::munmap(ptr, byteCount);
+        ::close(fd);
+        context.pixelsBuffer.buffer = nullptr;
+        return ERR_SHAMEM_DATA_ABNORMAL;
+    }
+    *static_cast<int32_t *>(fdBuffer) = fd;
+    context.pixelsBuffer.context = fdBuffer;
+    context.pixelsBuffer.bufferSize = byteCount;
+    context.allocatorType = AllocatorType::SHARE_MEM_ALLOC;
+    context.freeFunc = nullptr;
+    return SUCCESS;
+}
+
+uint32_t WbmpDecoder::SetContextPixelsBuffer(uint64_t byteCount, DecodeContext &context)
+{
+    if (context.allocatorType == Media::AllocatorType::SHARE_MEM_ALLOC) {
+#if !defined(_WIN32) && !defined(_APPLE)
+        uint32_t res = SetShareMemBuffer(byteCount, context);
+        if (res != SUCCESS) {
+            return res;
+        }
+#endif
+    } else {
+        if (byteCount <= 0) {
+            HiLog::Error(LABEL, "Decode failed, byteCount is invalid value");
+            return ERR_MEDIA_INVALID_VALUE;
+        }
+        void *outputBuffer = malloc(byteCount);
+        if (outputBuffer == nullptr) {
+            HiLog::Error(LABEL, "Decode failed, alloc output buffer size:[%{public}llu] error",
+                         static_cast<unsigned long long>(byteCount));
+            return ERR_IMAGE_MALLOC_ABNORMAL;
+        }
+#ifdef _WIN32
+        memset(outputBuffer, 0, byteCount);
+#else
+        if (memset_s(outputBuffer, byteCount, 0, byteCount) != EOK) {
+            HiLog::Error(LABEL, "Decode failed, memset buffer failed");
+            free(outputBuffer);
+            outputBuffer = nullptr;
+            return ERR_IMAGE_DECODE_FAILED;
+        }
+#endif
+        context.pixelsBuffer.buffer = outputBuffer;
+        context.pixelsBuffer.bufferSize = byteCount;
+        context.pixelsBuffer.context = nullptr;
+        context.allocatorType = AllocatorType::HEAP_ALLOC;
+        context.freeFunc = nullptr;
+    }
+    return SUCCESS;
+}
+
+uint32_t WbmpDecoder::Decode(uint32_t index, DecodeContext &context)
+{
+    if (index >= WBMP_IMAGE_NUM) {
+        HiLog::Error(LABEL, "Decode failed, invalid index:%{public}u, range:%{public}u", index, WBMP_IMAGE_NUM);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    if (state_ != WbmpDecodingState::IMAGE_DECODING) {
+        HiLog::Error(LABEL, "Decode failed, invalid state %{public}d", state_);
+        return ERR_MEDIA_INVALID_OPERATION;
+    }
+    uint32_t width = GetSampledSize(width_, sampleSize_);
+    uint32_t height = GetSampledSize(height_, sampleSize_);
+    if (ImageUtils::CheckMulOverflow(width, height, outputBytesPerPixel_)) {
+        HiLog::Error(LABEL, "Decode failed, width:%{public}u, height:%{public}u is too large", width, height);
+        return ERR_IMAGE_DECODE_FAILED;
+    }
+    if (context.pixelsBuffer.buffer == nullptr) {
+        uint64_t byteCount = static_cast<uint64_t>(height) * width * outputBytesPerPixel_;
+        uint32_t res = SetContextPixelsBuffer(byteCount, context);
+        if (res != SUCCESS) {
+            return res;
+        }
+    }
+    uint32_t decodedRows = 0;
+    uint32_t ret = DoDecode(static_cast<uint8_t *>(context.pixelsBuffer.buffer), width * outputBytesPerPixel_,
+                            decodedRows);
+    if (ret == ERR_IMAGE_SOURCE_DATA_INCOMPLETE && allowPartialImage_ && decodedRows > 0) {
+        // rows have not been decoded are left zero filled.
+        HiLog::Info(LABEL, "Decode partial image, decoded rows:%{public}u", decodedRows);
+        context.ifPartialOutput = true;
+        ret = SUCCESS;
+    }
+    if (ret != SUCCESS) {
+        HiLog::Error(LABEL, "Decode failed, ret=%{public}u", ret);
+        state_ = WbmpDecodingState::IMAGE_ERROR;
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    state_ = WbmpDecodingState::IMAGE_DECODED;
+    return SUCCESS;
+}
+
+uint32_t WbmpDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context)
+{
+    // currently not support increment decode
+    return ERR_IMAGE_DATA_UNSUPPORT;
+}
+
+uint32_t WbmpDecoder::DoDecode(uint8_t *dst, uint32_t rowBytes, uint32_t &decodedRows)
+{
+    decodedRows = 0;
+    if (dst == nullptr) {
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    uint32_t dstHeight = GetSampledSize(height_, sampleSize_);
+    for (uint32_t row = 0; row < dstHeight; row++) {
+        // rows skipped by sampleSize are never read.
+        const uint8_t *src = GetSourceRow(GetSampledCoord(row, height_));
+        if (src == nullptr) {
+            HiLog::Error(LABEL, "read row data failed, decoded rows:%{public}u", row);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        ExpandRow(src, dst + static_cast<uint64_t>(row) * rowBytes);
+        decodedRows = row + 1;
+    }
+    return SUCCESS;
+}
+
+void WbmpDecoder::ExpandRow(const uint8_t *src, uint8_t *dst)
+{
+    if (sampleSize_ == 1) {
+        switch (outputBytesPerPixel_) {
+            case ALPHA_8_BYTES:
+                ExpandUnitRow(src, dst, width_, GetAlpha8Table());
+                break;
+            case RGB_565_BYTES:
+                ExpandUnitRow(src, dst, width_, GetRgb565Table());
+                break;
+            default:
+                ExpandUnitRow(src, dst, width_, GetRgba8888Table());
+                break;
+        }
+        return;
+    }
+    uint32_t dstWidth = GetSampledSize(width_, sampleSize_);
+    uint32_t startX = GetSampledCoord(0, width_);
+    switch (outputBytesPerPixel_) {
+        case ALPHA_8_BYTES:
+            ExpandSampledRow(src, dst, dstWidth, startX, sampleSize_, GetAlpha8Table());
+            break;
+        case RGB_565_BYTES:
+            ExpandSampledRow(src, dst, dstWidth, startX, sampleSize_, GetRgb565Table());
+            break;
+        default:
+            ExpandSampledRow(src, dst, dstWidth, startX, sampleSize_, GetRgba8888Table());
+            break;
+    }
+}
+
+const uint8_t *WbmpDecoder::GetSourceRow(uint32_t srcRow)
+{
+    uint64_t position = static_cast<uint64_t>(dataOffset_) + static_cast<uint64_t>(srcRow) * srcRowBytes_;
+    if (position + srcRowBytes_ > UINT32_MAX) {
+        return nullptr;
+    }
+    // buffer source, use the row in place without any copy.
+    uint8_t *data = stream_->GetDataPtr();
+    if (stream_->GetStreamType() == BUFFER_SOURCE_TYPE && data != nullptr) {
+        if (position + srcRowBytes_ > stream_->GetStreamSize()) {
+            return nullptr;
+        }
+        return data + position;
+    }
+    if (rowBuffer_.size() < srcRowBytes_) {
+        rowBuffer_.resize(srcRowBytes_);
+    }
+    if (!stream_->Seek(static_cast<uint32_t>(position))) {
+        return nullptr;
+    }
+    uint32_t readSize = 0;
+    if (!stream_->Read(srcRowBytes_, rowBuffer_.data(), srcRowBytes_, readSize) || readSize != srcRowBytes_) {
+        return nullptr;
+    }
+    return rowBuffer_.data();
+}
+
+uint32_t WbmpDecoder::GetSampledSize(uint32_t size, uint32_t sampleSize)
+{
+    if (sampleSize <= 1) {
+        return size;
+    }
+    // same as skia sampling: never scale to zero, drop the incomplete tail block.
+    return std::max(size / sampleSize, 1u);
+}
+
+uint32_t WbmpDecoder::GetSampledCoord(uint32_t index, uint32_t size) const
+{
+    if (sampleSize_ <= 1) {
+        return index;
+    }
+    if (size < sampleSize_) {
+        return size / 2;  // take the middle one.
+    }
+    return index * sampleSize_ + sampleSize_ / 2;
+}
+
+bool WbmpDecoder::DecodeHeader()
+{
+    if (stream_ == nullptr || !stream_->Seek(0)) {
+        HiLog::Error(LABEL, "seek to the beginning of the stream failed");
+        return false;
+    }
+    uint8_t header[WBMP_HEADER_MAX_SIZE] = { 0 };
+    uint32_t headerSize = WBMP_HEADER_MAX_SIZE;
+    size_t streamSize = stream_->GetStreamSize();
+    if (streamSize > 0 && streamSize < headerSize) {
+        // tiny images may be shorter than the max header size.
+        headerSize = static_cast<uint32_t>(streamSize);
+    }
+    uint32_t readSize = 0;
+    if (!stream_->Peek(headerSize, header, WBMP_HEADER_MAX_SIZE, readSize) || readSize == 0) {
+        HiLog::Error(LABEL, "read header data failed");
+        return false;
+    }
+    uint32_t offset = 0;
+    uint8_t value = 0;
+    // only type 0 is defined, the fix header must not carry extension headers.
+    if (!ReadByte(header, readSize, offset, value) || value != 0) {
+        HiLog::Error(LABEL, "unsupported wbmp type:%{public}u", value);
+        return false;
+    }
+    if (!ReadByte(header, readSize, offset, value) || (value & WBMP_FIX_HEADER_MASK)) {
+        HiLog::Error(LABEL, "unsupported wbmp fix header:%{public}u", value);
+        return false;
+    }
+    uint64_t width = 0;
+    uint64_t height = 0;
+    if (!ReadMultiByteInt(header, readSize, offset, width) || width == 0 || width > WBMP_MAX_SIZE ||
+        !ReadMultiByteInt(header, readSize, offset, height) || height == 0 || height > WBMP_MAX_SIZE) {
+        HiLog::Error(LABEL, "invalid wbmp size");
+        return false;
+    }
+    width_ = static_cast<uint32_t>(width);
+    height_ = static_cast<uint32_t>(height);
+    dataOffset_ = offset;
+    srcRowBytes_ = (width_ + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+    return true;
+}
+
+uint32_t WbmpDecoder::ConvertToOutputFormat(PlPixelFormat format, PlPixelFormat &outputFormat)
+{
+    switch (format) {
+        case PlPixelFormat::BGRA_8888: {
+            outputFormat = PlPixelFormat::BGRA_8888;
+            return RGBA_8888_BYTES;
+        }
+        case PlPixelFormat::ALPHA_8: {
+            outputFormat = PlPixelFormat::ALPHA_8;
+            return ALPHA_8_BYTES;
+        }
+        case PlPixelFormat::RGB_565: {
+            outputFormat = PlPixelFormat::RGB_565;
+            return RGB_565_BYTES;
+        }
+        case PlPixelFormat::UNKNOWN:
+        case PlPixelFormat::RGBA_8888: {
+            outputFormat = PlPixelFormat::RGBA_8888;
+            return RGBA_8888_BYTES;
+        }
+        default: {
+            break;
+        }
+    }
+    HiLog::Debug(LABEL, "unsupported convert to format:%{public}d, set default RGBA", format);
+    outputFormat = PlPixelFormat::RGBA_8888;
+    return RGBA_8888_BYTES;
+}
+} // namespace ImagePlugin
+} // namespace OHOS
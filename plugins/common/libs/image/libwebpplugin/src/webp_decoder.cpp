@@ -14,6 +14,7 @@
  */
 
 #include "webp_decoder.h"
+#include <algorithm>
 #include "media_errors.h"
 #include "multimedia_templates.h"
 #include "securec.h"
@@ -30,6 +31,7 @@ constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "WebpDecoder"
 constexpr int32_t WEBP_IMAGE_NUM = 1;
 constexpr int32_t EXTERNAL_MEMORY = 1;
 constexpr size_t DECODE_VP8CHUNK_MIN_SIZE = 4096;
+constexpr size_t DECODE_SLICE_SIZE = 64 * 1024;
 } // namespace
 
 WebpDecoder::WebpDecoder()
@@ -277,7 +279,19 @@ uint32_t WebpDecoder::DoCommonDecode(DecodeContext &context)
         return ERR_IMAGE_DECODE_FAILED;
     }
 
-    VP8StatusCode status = WebPIUpdate(idec, dataBuffer_.inputStreamBuffer, static_cast<size_t>(dataBuffer_.dataSize));
+    // the data is fed by slices, so that a canceled decoding stops between them.
+    VP8StatusCode status = VP8_STATUS_SUSPENDED;
+    size_t totalSize = static_cast<size_t>(dataBuffer_.dataSize);
+    size_t fedSize = 0;
+    do {
+        if (opts_.IsCanceled()) {
+            HiLog::Info(LABEL, "decoding canceled, fed size:%{public}zu, total size:%{public}zu.", fedSize, totalSize);
+            state_ = WebpDecodingState::IMAGE_ERROR;
+            return ERR_IMAGE_DECODE_CANCELED;
+        }
+        fedSize = std::min(totalSize, fedSize + DECODE_SLICE_SIZE);
+        status = WebPIUpdate(idec, dataBuffer_.inputStreamBuffer, fedSize);
+    } while (status == VP8_STATUS_SUSPENDED && fedSize < totalSize);
     if (status == VP8_STATUS_OK) {
         state_ = WebpDecodingState::IMAGE_DECODED;
         return SUCCESS;
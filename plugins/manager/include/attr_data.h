@@ -74,6 +74,8 @@ public:
     uint32_t GetValue(uint32_t &value) const;
     uint32_t GetValue(std::string &value) const;
     uint32_t GetValue(const std::string *&value) const;
+    uint32_t GetValue(const std::set<uint32_t> *&value) const;
+    uint32_t GetValue(const std::set<std::string> *&value) const;
 
     static constexpr uint8_t RANGE_ARRAY_SIZE = 2;
     static constexpr uint8_t LOWER_BOUND_INDEX = 0;
@@ -80,6 +80,10 @@ struct ProgDecodeContext {
     // input total process progress after last decoding step,
     // output total process progress after current decoding step.
     uint8_t totalProcessProgress = 0;
+
+    // Out: the number of scans rendered to the full frame output, only for progressive images.
+    // 0 means no full frame is ready, the output holds the rows decoded so far.
+    uint32_t renderedScans = 0;
 };
 
 struct PixelDecodeOptions {
@@ -93,6 +97,11 @@ struct PixelDecodeOptions {
     PlAlphaType desireAlphaType = PlAlphaType::IMAGE_ALPHA_TYPE_PREMUL;
     bool allowPartialImage = true;
     bool editable = false;
+    std::shared_ptr<Media::DecodeCancelToken> cancelToken;
+    bool IsCanceled() const
+    {
+        return cancelToken != nullptr && cancelToken->IsCanceled();
+    }
 };
 
 class AbsImageDecoder {
@@ -110,6 +119,13 @@ public:
     // reset the decoder, clear all the decoder's status data cache.
     virtual void Reset() = 0;
 
+    // whether the decoder can start a new source by SetSource after Reset, so that it can be kept for the
+    // following image sources. the Reset of such decoder drops the source stream and keeps the scratch buffers.
+    virtual bool IsReusable()
+    {
+        return false;
+    }
+
     // judge a image source has a property or not.
     virtual bool HasProperty(std::string key)
     {
@@ -52,6 +52,21 @@ public:
     // need to copy desiredSize bytes from the InputDataStream to outBuffer and without extracting it.
     virtual bool Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) = 0;
 
+    // copy at most bufferSize bytes to outBuffer and extract them, fewer bytes are copied at the end of the data,
+    // and none after it with true returned. unlike Read, it neither needs a buffer managed by the InputDataStream
+    // nor fails on a short read. the default one reads by Read, which fails at the end of the data.
+    virtual bool ReadInto(uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize)
+    {
+        return Read(bufferSize, outBuffer, bufferSize, readSize);
+    }
+
+    // the largest size from the current position, that Read with DataStreamBuffer outputs without copying.
+    // 0 means the InputDataStream copies for each read, ReadInto a buffer of the caller is cheaper then.
+    virtual uint32_t GetContiguousSize()
+    {
+        return 0;
+    }
+
     // get the position of the current byte in the InputDataStream.
     virtual uint32_t Tell() = 0;
 
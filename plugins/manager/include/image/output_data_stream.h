@@ -25,6 +25,8 @@ public:
     virtual ~OutputDataStream() {}
     virtual bool Write(const uint8_t *buffer, uint32_t size) = 0;
     virtual void Flush() {}
+    // the size the data is expected to be, for example estimated by an encoder before writing, 0 if unknown.
+    virtual void SetExpectedSize(uint32_t size) {}
 };
 } // namespace ImagePlugin
 } // namespace OHOS
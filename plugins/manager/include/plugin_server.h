@@ -16,7 +16,10 @@
 #ifndef PLUGIN_SERVER_H
 #define PLUGIN_SERVER_H
 
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -41,7 +44,16 @@ enum class PluginFWType : int32_t {
 
 class PluginServer final : public NoCopyable {
 public:
-    uint32_t Register(std::vector<std::string> &&pluginPaths);
+    // cacheDir is a directory writable by the process, such as the cache dir of the application, where the parsed
+    // metadata of the plugin paths is cached for the next registration. an empty cacheDir disables the cache.
+    uint32_t Register(std::vector<std::string> &&pluginPaths, const std::string &cacheDir = "");
+    // register the interface functions of a plugin package linked into the process. the package is still described
+    // by its metadata in the plugin paths, but its objects are created by these functions without loading a library.
+    using StaticStartFunc = bool (*)();
+    using StaticStopFunc = void (*)();
+    using StaticCreateFunc = PluginClassBase *(*)(const std::string &className);
+    uint32_t RegisterStaticPlugin(const std::string &packageName, StaticStartFunc startFunc, StaticStopFunc stopFunc,
+                                  StaticCreateFunc createFunc);
 
     template<typename T>
     inline T *CreateObject(const std::string &className, uint32_t &errorCode)
@@ -153,9 +165,38 @@ public:
         return PluginServerGetClassInfo(interfaceID, serviceType, capabilities, classesInfo);
     }
 
+    // resolve the plugins of the service for each capabilities on a background thread, so their libraries are
+    // loaded and started before the first CreateObject. no object is created, and the resolved plugins stay
+    // loaded. an empty list resolves the plugin of the service without any capability.
+    template<typename T>
+    inline uint32_t WarmUp(uint16_t serviceType, const std::vector<std::map<std::string, AttrData>> &capabilitiesList)
+    {
+        uint16_t interfaceID = GetInterfaceId<T>();
+        return WarmUp(interfaceID, serviceType, capabilitiesList);
+    }
+
+    // whether the plugin of the class resolved for the capabilities is loaded and started.
+    template<typename T>
+    inline bool IsPluginActive(uint16_t serviceType, const std::map<std::string, AttrData> &capabilities)
+    {
+        uint16_t interfaceID = GetInterfaceId<T>();
+        return IsPluginActive(interfaceID, serviceType, capabilities);
+    }
+
+    // whether all the warm up requested before is done.
+    bool IsWarmUpDone();
+    // wait for all the warm up requested before, return false if it is not done in timeoutMs.
+    bool WaitWarmUp(uint32_t timeoutMs);
+
     DECLARE_DELAYED_REF_SINGLETON(PluginServer);
 
 private:
+    struct WarmUpTask {
+        uint16_t interfaceID = 0;
+        uint16_t serviceType = 0;
+        std::map<std::string, AttrData> capabilities;
+    };
+
     template<typename T>
     inline T *ConvertToServiceInterface(PluginClassBase *pluginBase)
     {
@@ -185,10 +226,19 @@ private:
                           const std::map<std::string, AttrData> &capabilities,
                           std::vector<ClassInfo> &classesInfo);
     PluginFWType AnalyzeFWType(const std::string &canonicalPath);
+    uint32_t WarmUp(uint16_t interfaceID, uint16_t serviceType,
+                    const std::vector<std::map<std::string, AttrData>> &capabilitiesList);
+    bool IsPluginActive(uint16_t interfaceID, uint16_t serviceType,
+                        const std::map<std::string, AttrData> &capabilities);
+    void WarmUpLoop();
 
     PlatformAdp &platformAdp_;
     PluginFw &pluginFw_;
     GstPluginFw &gstPluginFw_;
+    std::mutex warmUpMutex_;
+    std::condition_variable warmUpCond_;
+    std::deque<WarmUpTask> warmUpTasks_;
+    bool isWarmingUp_ = false;  // the warm up thread is running.
 };
 } // namespace MultimediaPlugin
 } // namespace OHOS
@@ -579,6 +579,28 @@ uint32_t AttrData::GetValue(const string *&value) const
     return SUCCESS;
 }
 
+uint32_t AttrData::GetValue(const set<uint32_t> *&value) const
+{
+    if (type_ != AttrDataType::ATTR_DATA_UINT32_SET) {
+        HiLog::Error(LABEL, "Get uint32Set value: not a uint32Set AttrData type: %{public}d.", type_);
+        return ERR_INVALID_PARAMETER;
+    }
+
+    value = value_.uint32Set;
+    return SUCCESS;
+}
+
+uint32_t AttrData::GetValue(const set<string> *&value) const
+{
+    if (type_ != AttrDataType::ATTR_DATA_STRING_SET) {
+        HiLog::Error(LABEL, "Get stringSet value: not a stringSet AttrData type: %{public}d.", type_);
+        return ERR_INVALID_PARAMETER;
+    }
+
+    value = value_.stringSet;
+    return SUCCESS;
+}
+
 // ------------------------------- private method -------------------------------
 uint32_t AttrData::InitStringAttrData(const AttrData &data)
 {
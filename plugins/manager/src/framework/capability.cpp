@@ -14,6 +14,8 @@
  */
 
 #include "capability.h"
+#include <algorithm>
+#include <unordered_map>
 #include "hilog/log.h"
 #include "json_helper.h"
 #include "log_tags.h"
@@ -25,17 +27,33 @@ using nlohmann::json;
 using std::map;
 using std::size_t;
 using std::string;
+using std::unordered_map;
+using std::vector;
 using namespace OHOS::HiviewDFX;
 
 static constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "Capability" };
 const string Capability::CAPABILITY_BOOL_TRUE = "true";
 const string Capability::CAPABILITY_BOOL_FALSE = "false";
+// the id of the keys and string values that no class registers.
+static constexpr uint32_t UNKNOWN_ID = 0;
+
+// the ids of the capability keys and string values. ids are only added in the register, which is mutually
+// exclusive with the createObject process, so the lookups of the requests need no lock.
+static unordered_map<string, uint32_t> &GetAttrIds()
+{
+    static unordered_map<string, uint32_t> attrIds;
+    return attrIds;
+}
 
 Capability::Capability(const map<string, AttrData> &caps) : caps_(caps)
-{}
+{
+    InternCaps();
+}
 
 Capability::Capability(map<string, AttrData> &&caps) : caps_(std::move(caps))
-{}
+{
+    InternCaps();
+}
 
 uint32_t Capability::SetCapability(const json &capsInfo)
 {
@@ -68,18 +86,34 @@ uint32_t Capability::SetCapability(const json &capsInfo)
         caps_.emplace(std::move(name), std::move(attrData));
     }
 
+    InternCaps();
     return SUCCESS;
 }
 
+void Capability::InternRequest(const map<string, AttrData> &caps, InternedCaps &interned)
+{
+    InternCaps(caps, false, interned);
+}
+
 bool Capability::IsCompatible(const map<string, AttrData> &caps) const
 {
-    for (const auto &capability : caps) {
-        auto iter = caps_.find(capability.first);
-        if (iter == caps_.end()) {
+    InternedCaps interned;
+    InternRequest(caps, interned);
+    return IsCompatible(interned);
+}
+
+bool Capability::IsCompatible(const InternedCaps &caps) const
+{
+    // both are sorted by keyId, so the search goes on from the last matched key.
+    auto iter = internedCaps_.begin();
+    for (const auto &request : caps) {
+        iter = std::lower_bound(iter, internedCaps_.end(), request.keyId,
+                                [](const InternedAttr &attr, uint32_t keyId) { return attr.keyId < keyId; });
+        if (iter == internedCaps_.end() || iter->keyId != request.keyId) {
             return false;
         }
 
-        if (!iter->second.InRange(capability.second)) {
+        if (!InRange(*iter, request)) {
             return false;
         }
     }
@@ -317,5 +351,220 @@ uint32_t Capability::AnalyzeStringSet(const json &capInfo, AttrData &attrData)
 
     return SUCCESS;
 }
+
+void Capability::InternCaps()
+{
+    InternCaps(caps_, true, internedCaps_);
+}
+
+void Capability::InternCaps(const map<string, AttrData> &caps, bool isRegister, InternedCaps &interned)
+{
+    interned.clear();
+    interned.reserve(caps.size());
+    for (const auto &capability : caps) {
+        InternedAttr attr;
+        attr.keyId = GetId(capability.first, isRegister);
+        if (!InternAttr(capability.second, isRegister, attr)) {
+            // matches nothing, the same as the unexpected type of AttrData.
+            attr.type = AttrDataType::ATTR_DATA_TYPE_INVALID;
+        }
+        interned.push_back(std::move(attr));
+    }
+
+    std::sort(interned.begin(), interned.end(),
+              [](const InternedAttr &lhs, const InternedAttr &rhs) { return lhs.keyId < rhs.keyId; });
+}
+
+bool Capability::InternAttr(const AttrData &attrData, bool isRegister, InternedAttr &interned)
+{
+    interned.type = attrData.GetType();
+    switch (interned.type) {
+        case AttrDataType::ATTR_DATA_NULL: {
+            return true;
+        }
+        case AttrDataType::ATTR_DATA_BOOL: {
+            bool value = false;
+            if (attrData.GetValue(value) != SUCCESS) {
+                return false;
+            }
+            interned.value[0] = value ? 1 : 0;
+            return true;
+        }
+        case AttrDataType::ATTR_DATA_UINT32: {
+            return attrData.GetValue(interned.value[0]) == SUCCESS;
+        }
+        case AttrDataType::ATTR_DATA_STRING: {
+            const string *value = nullptr;
+            if (attrData.GetValue(value) != SUCCESS || value == nullptr) {
+                return false;
+            }
+            interned.value[0] = GetId(*value, isRegister);
+            return true;
+        }
+        case AttrDataType::ATTR_DATA_UINT32_SET: {
+            const std::set<uint32_t> *values = nullptr;
+            if (attrData.GetValue(values) != SUCCESS || values == nullptr) {
+                return false;
+            }
+            interned.setValue.assign(values->begin(), values->end());
+            return true;
+        }
+        case AttrDataType::ATTR_DATA_STRING_SET: {
+            const std::set<string> *values = nullptr;
+            if (attrData.GetValue(values) != SUCCESS || values == nullptr) {
+                return false;
+            }
+            interned.setValue.reserve(values->size());
+            for (const string &value : *values) {
+                interned.setValue.push_back(GetId(value, isRegister));
+            }
+            std::sort(interned.setValue.begin(), interned.setValue.end());
+            return true;
+        }
+        case AttrDataType::ATTR_DATA_UINT32_RANGE: {
+            return attrData.GetMinValue(interned.value[AttrData::LOWER_BOUND_INDEX]) == SUCCESS &&
+                   attrData.GetMaxValue(interned.value[AttrData::UPPER_BOUND_INDEX]) == SUCCESS;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+uint32_t Capability::GetId(const string &str, bool isRegister)
+{
+    unordered_map<string, uint32_t> &attrIds = GetAttrIds();
+    auto iter = attrIds.find(str);
+    if (iter != attrIds.end()) {
+        return iter->second;
+    }
+
+    if (!isRegister) {
+        return UNKNOWN_ID;
+    }
+
+    uint32_t id = static_cast<uint32_t>(attrIds.size()) + 1;
+    attrIds.emplace(str, id);
+    return id;
+}
+
+// the same rules as AttrData::InRange, on the interned values.
+bool Capability::InRange(const InternedAttr &capability, const InternedAttr &request)
+{
+    switch (request.type) {
+        case AttrDataType::ATTR_DATA_NULL: {
+            return capability.type == AttrDataType::ATTR_DATA_NULL;
+        }
+        case AttrDataType::ATTR_DATA_BOOL: {
+            return capability.type == AttrDataType::ATTR_DATA_BOOL && capability.value[0] == request.value[0];
+        }
+        case AttrDataType::ATTR_DATA_UINT32: {
+            return InRange(capability, request.value[0]);
+        }
+        case AttrDataType::ATTR_DATA_STRING: {
+            if (capability.type == AttrDataType::ATTR_DATA_STRING) {
+                return capability.value[0] == request.value[0];
+            }
+            return capability.type == AttrDataType::ATTR_DATA_STRING_SET &&
+                   std::binary_search(capability.setValue.begin(), capability.setValue.end(), request.value[0]);
+        }
+        case AttrDataType::ATTR_DATA_UINT32_SET: {
+            return InRangeUint32Set(capability, request.setValue);
+        }
+        case AttrDataType::ATTR_DATA_STRING_SET: {
+            if (request.setValue.empty()) {
+                return false;
+            }
+            if (capability.type == AttrDataType::ATTR_DATA_STRING) {
+                return request.setValue.front() == capability.value[0] &&
+                       request.setValue.back() == capability.value[0];
+            }
+            return capability.type == AttrDataType::ATTR_DATA_STRING_SET &&
+                   std::includes(capability.setValue.begin(), capability.setValue.end(), request.setValue.begin(),
+                                 request.setValue.end());
+        }
+        case AttrDataType::ATTR_DATA_UINT32_RANGE: {
+            return InRangeUint32Range(capability, request.value[AttrData::LOWER_BOUND_INDEX],
+                                      request.value[AttrData::UPPER_BOUND_INDEX]);
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool Capability::InRange(const InternedAttr &capability, uint32_t value)
+{
+    switch (capability.type) {
+        case AttrDataType::ATTR_DATA_UINT32: {
+            return value == capability.value[0];
+        }
+        case AttrDataType::ATTR_DATA_UINT32_SET: {
+            return std::binary_search(capability.setValue.begin(), capability.setValue.end(), value);
+        }
+        case AttrDataType::ATTR_DATA_UINT32_RANGE: {
+            return value >= capability.value[AttrData::LOWER_BOUND_INDEX] &&
+                   value <= capability.value[AttrData::UPPER_BOUND_INDEX];
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool Capability::InRangeUint32Set(const InternedAttr &capability, const vector<uint32_t> &values)
+{
+    if (values.empty()) {
+        return false;
+    }
+
+    switch (capability.type) {
+        case AttrDataType::ATTR_DATA_UINT32: {
+            return values.front() == capability.value[0] && values.back() == capability.value[0];
+        }
+        case AttrDataType::ATTR_DATA_UINT32_SET: {
+            return std::includes(capability.setValue.begin(), capability.setValue.end(), values.begin(),
+                                 values.end());
+        }
+        case AttrDataType::ATTR_DATA_UINT32_RANGE: {
+            return values.front() >= capability.value[AttrData::LOWER_BOUND_INDEX] &&
+                   values.back() <= capability.value[AttrData::UPPER_BOUND_INDEX];
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool Capability::InRangeUint32Range(const InternedAttr &capability, uint32_t lowerBound, uint32_t upperBound)
+{
+    if (lowerBound > upperBound) {
+        return false;
+    }
+
+    switch (capability.type) {
+        case AttrDataType::ATTR_DATA_UINT32: {
+            return lowerBound == upperBound && upperBound == capability.value[0];
+        }
+        case AttrDataType::ATTR_DATA_UINT32_SET: {
+            // every value of the range is in the set.
+            auto begin = capability.setValue.begin();
+            auto end = capability.setValue.end();
+            auto lowerIter = std::lower_bound(begin, end, lowerBound);
+            auto upperIter = std::lower_bound(lowerIter, end, upperBound);
+            if (lowerIter == end || *lowerIter != lowerBound || upperIter == end || *upperIter != upperBound) {
+                return false;
+            }
+            return static_cast<uint32_t>(upperIter - lowerIter) == (upperBound - lowerBound);
+        }
+        case AttrDataType::ATTR_DATA_UINT32_RANGE: {
+            return lowerBound >= capability.value[AttrData::LOWER_BOUND_INDEX] &&
+                   upperBound <= capability.value[AttrData::UPPER_BOUND_INDEX];
+        }
+        default: {
+            return false;
+        }
+    }
+}
 } // namespace MultimediaPlugin
 } // namespace OHOS
@@ -18,6 +18,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "json.hpp"
 #include "attr_data.h"
 #include "plugin_errors.h"
@@ -30,8 +31,24 @@ public:
     explicit Capability(const std::map<std::string, AttrData> &caps);
     explicit Capability(std::map<std::string, AttrData> &&caps);
     ~Capability() = default;
+    // a capability whose key and string values are interned into ids, the set values are sorted,
+    // so the capabilities are matched by comparing integers.
+    struct InternedAttr {
+        uint32_t keyId = 0;
+        AttrDataType type = AttrDataType::ATTR_DATA_NULL;
+        // the bool, uint32 or string id value, or the lower and upper bound of a range.
+        uint32_t value[AttrData::RANGE_ARRAY_SIZE] = { 0, 0 };
+        std::vector<uint32_t> setValue;
+    };
+    // sorted by keyId.
+    using InternedCaps = std::vector<InternedAttr>;
+
     uint32_t SetCapability(const nlohmann::json &capsInfo);
+    // interns the capabilities of a request once, to match it with multiple classes.
+    // the keys and string values that no class registers get an id that matches nothing.
+    static void InternRequest(const std::map<std::string, AttrData> &caps, InternedCaps &interned);
     bool IsCompatible(const std::map<std::string, AttrData> &caps) const;
+    bool IsCompatible(const InternedCaps &caps) const;
     const AttrData *GetCapability(const std::string &key) const;
     const std::map<std::string, AttrData> &GetCapability() const;
 
@@ -43,6 +60,14 @@ private:
     uint32_t AnalyzeUint32Set(const nlohmann::json &capInfo, AttrData &attrData);
     uint32_t AnalyzeUint32Range(const nlohmann::json &capInfo, AttrData &attrData);
     uint32_t AnalyzeStringSet(const nlohmann::json &capInfo, AttrData &attrData);
+    void InternCaps();
+    static void InternCaps(const std::map<std::string, AttrData> &caps, bool isRegister, InternedCaps &interned);
+    static bool InternAttr(const AttrData &attrData, bool isRegister, InternedAttr &interned);
+    static uint32_t GetId(const std::string &str, bool isRegister);
+    static bool InRange(const InternedAttr &capability, const InternedAttr &request);
+    static bool InRange(const InternedAttr &capability, uint32_t value);
+    static bool InRangeUint32Set(const InternedAttr &capability, const std::vector<uint32_t> &values);
+    static bool InRangeUint32Range(const InternedAttr &capability, uint32_t lowerBound, uint32_t upperBound);
 
     static constexpr uint32_t SET_MIN_VALUE_NUM = 1;
     static const std::string CAPABILITY_BOOL_TRUE;
@@ -50,6 +75,7 @@ private:
     static std::map<std::string, AttrDataType> typeMap_;
     using CapsMap = std::map<std::string, AttrData>;
     CapsMap caps_;
+    InternedCaps internedCaps_;
 };
 } // namespace MultimediaPlugin
 } // namespace OHOS
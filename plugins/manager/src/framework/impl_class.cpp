@@ -28,7 +28,6 @@ namespace OHOS {
 namespace MultimediaPlugin {
 using nlohmann::json;
 using std::map;
-using std::recursive_mutex;
 using std::set;
 using std::shared_ptr;
 using std::size_t;
@@ -102,40 +101,35 @@ PluginClassBase *ImplClass::CreateObject(uint32_t &errorCode)
 
     HiLog::Debug(LABEL, "create object, className: %{public}s.", className_.c_str());
 
-    std::unique_lock<std::recursive_mutex> guard(dynDataLock_);
-    if (maxInstance_ != INSTANCE_NO_LIMIT_NUM && instanceNum_ >= maxInstance_) {
-        HiLog::Error(LABEL, "failed to create for limit, currentNum: %{public}u, maxNum: %{public}u, \
-                     className: %{public}s.",
-                     instanceNum_, maxInstance_, className_.c_str());
-        guard.unlock();
-        errorCode = ERR_INSTANCE_LIMIT;
-        return nullptr;
-    }
-
-    if (instanceNum_ == 0) {
-        if (sharedPlugin->Ref() != SUCCESS) {
+    // reserve an instance slot first, the limit is kept without serializing the creation.
+    uint16_t instanceNum = instanceNum_.load(std::memory_order_relaxed);
+    do {
+        if (maxInstance_ != INSTANCE_NO_LIMIT_NUM && instanceNum >= maxInstance_) {
+            HiLog::Error(LABEL, "failed to create for limit, currentNum: %{public}u, maxNum: %{public}u, \
+                         className: %{public}s.",
+                         instanceNum, maxInstance_, className_.c_str());
+            errorCode = ERR_INSTANCE_LIMIT;
             return nullptr;
         }
+    } while (!instanceNum_.compare_exchange_weak(instanceNum, instanceNum + 1, std::memory_order_relaxed));
+
+    // each object holds a ref of the plugin, which is a lock free increment once the plugin is active.
+    if (sharedPlugin->Ref() != SUCCESS) {
+        instanceNum_.fetch_sub(1, std::memory_order_relaxed);
+        return nullptr;
     }
 
     PluginClassBase *object = DoCreateObject(sharedPlugin);
     if (object == nullptr) {
         HiLog::Error(LABEL, "create object result null, className: %{public}s.", className_.c_str());
-        goto CREATE_INTERNAL_ERROR_EXIT;
+        sharedPlugin->DeRef();
+        instanceNum_.fetch_sub(1, std::memory_order_relaxed);
+        return nullptr;
     }
 
-    ++instanceNum_;
-    HiLog::Debug(LABEL, "create object success, InstanceNum: %{public}u.", instanceNum_);
-    guard.unlock();
-
+    HiLog::Debug(LABEL, "create object success, InstanceNum: %{public}u.", instanceNum + 1);
     errorCode = SUCCESS;
     return object;
-
-CREATE_INTERNAL_ERROR_EXIT:
-    if (instanceNum_ == 0) {
-        sharedPlugin->DeRef();
-    }
-    return nullptr;
 }
 
 weak_ptr<Plugin> ImplClass::GetPluginRef() const
@@ -194,31 +188,26 @@ void ImplClass::OnObjectDestroy()
         return;
     }
 
-    std::unique_lock<std::recursive_mutex> guard(dynDataLock_);
-    // this situation does not happen in design.
-    if (instanceNum_ == 0) {
-        guard.unlock();
-        HiLog::Error(LABEL, "destroy object while instanceNum is zero.");
-        return;
-    }
-
-    --instanceNum_;
+    uint16_t instanceNum = instanceNum_.load(std::memory_order_relaxed);
+    do {
+        // this situation does not happen in design.
+        if (instanceNum == 0) {
+            HiLog::Error(LABEL, "destroy object while instanceNum is zero.");
+            return;
+        }
+    } while (!instanceNum_.compare_exchange_weak(instanceNum, instanceNum - 1, std::memory_order_relaxed));
 
     auto sharedPlugin = pluginRef_.lock();
     // this situation does not happen in design.
     if (sharedPlugin == nullptr) {
-        guard.unlock();
         HiLog::Error(LABEL, "destroy object failed because failed to dereference Plugin, className: %{public}s.",
                      className_.c_str());
         return;
     }
 
     HiLog::Debug(LABEL, "destroy object: className: %{public}s", className_.c_str());
-    if (instanceNum_ == 0) {
-        sharedPlugin->DeRef();
-    }
-
-    HiLog::Debug(LABEL, "destroy object success, InstanceNum: %{public}u.", instanceNum_);
+    sharedPlugin->DeRef();
+    HiLog::Debug(LABEL, "destroy object success, InstanceNum: %{public}u.", instanceNum - 1);
 }
 
 const set<uint32_t> &ImplClass::GetServices() const
@@ -231,6 +220,11 @@ bool ImplClass::IsCompatible(const map<string, AttrData> &caps) const
     return capability_.IsCompatible(caps);
 }
 
+bool ImplClass::IsCompatible(const Capability::InternedCaps &caps) const
+{
+    return capability_.IsCompatible(caps);
+}
+
 const AttrData *ImplClass::GetCapability(const string &key) const
 {
     if (state_ != ClassState::CLASS_STATE_REGISTERED) {
@@ -16,8 +16,8 @@
 #ifndef IMPL_CLASS_H
 #define IMPL_CLASS_H
 
+#include <atomic>
 #include <map>
-#include <mutex>
 #include <set>
 #include <string>
 #include "json.hpp"
@@ -57,6 +57,7 @@ public:
     void OnObjectDestroy();
     const std::set<uint32_t> &GetServices() const;
     bool IsCompatible(const std::map<std::string, AttrData> &caps) const;
+    bool IsCompatible(const Capability::InternedCaps &caps) const;
 
     uint16_t GetPriority() const
     {
@@ -75,13 +76,11 @@ private:
     PluginClassBase *DoCreateObject(std::shared_ptr<Plugin> &plugin);
     static constexpr uint16_t INSTANCE_NO_LIMIT_NUM = 0;
     static std::string emptyString_;
-    // dynDataLock_:
     // for data that only changes in the register, we don't call it dynamic data.
     // non-dynamic data are protected by other means, that is: mutual exclusion between
     // the register and createObject processes.
-    // current dynamic data includes:
-    // instanceNum_.
-    std::recursive_mutex dynDataLock_;
+    // the only dynamic data is instanceNum_, which is atomic, so the objects of a class
+    // can be created and destroyed concurrently.
     ClassState state_ = ClassState::CLASS_STATE_UNREGISTER;
     std::string className_;
     std::set<uint32_t> services_;
@@ -90,7 +89,7 @@ private:
     Capability capability_;
     std::weak_ptr<Plugin> pluginRef_;
     ImplClassKey selfKey_;
-    uint16_t instanceNum_ = 0;
+    std::atomic<uint16_t> instanceNum_ { 0 };
 };
 } // namespace MultimediaPlugin
 } // namespace OHOS
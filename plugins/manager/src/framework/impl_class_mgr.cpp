@@ -34,6 +34,7 @@ using std::weak_ptr;
 using namespace OHOS::HiviewDFX;
 
 static constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "ImplClassMgr" };
+static constexpr size_t MAX_RESOLVED_CLASSES = 64;
 
 uint32_t ImplClassMgr::AddClass(weak_ptr<Plugin> &plugin, const json &classInfo)
 {
@@ -65,6 +66,7 @@ uint32_t ImplClassMgr::AddClass(weak_ptr<Plugin> &plugin, const json &classInfo)
         srvSearchMultimap_.insert(ServiceClassMultimap::value_type(srv, implClass));
     }
 
+    ClearResolvedClasses();
     return SUCCESS;
 }
 
@@ -90,6 +92,8 @@ void ImplClassMgr::DeleteClass(const weak_ptr<Plugin> &plugin)
         }
         iter = classMultimap_.erase(iter);
     }
+
+    ClearResolvedClasses();
 }
 
 PluginClassBase *ImplClassMgr::CreateObject(uint16_t interfaceID, const string &className, uint32_t &errorCode)
@@ -120,31 +124,100 @@ PluginClassBase *ImplClassMgr::CreateObject(uint16_t interfaceID, const string &
 PluginClassBase *ImplClassMgr::CreateObject(uint16_t interfaceID, uint16_t serviceType,
                                             const map<string, AttrData> &capabilities,
                                             const PriorityScheme &priorityScheme, uint32_t &errorCode)
+{
+    HiLog::Debug(LABEL, "create object iid: %{public}u, serviceType: %{public}u.", interfaceID, serviceType);
+    shared_ptr<ImplClass> target = ResolveClass(interfaceID, serviceType, capabilities, priorityScheme);
+    if (target == nullptr) {
+        HiLog::Error(LABEL, "failed to find class by priority.");
+        errorCode = ERR_MATCHING_PLUGIN;
+        return nullptr;
+    }
+
+    HiLog::Debug(LABEL, "search by priority result, className: %{public}s.", target->GetClassName().c_str());
+    return target->CreateObject(errorCode);
+}
+
+uint32_t ImplClassMgr::WarmUp(uint16_t interfaceID, uint16_t serviceType, const map<string, AttrData> &capabilities)
+{
+    PriorityScheme emptyPriScheme;
+    shared_ptr<ImplClass> target = ResolveClass(interfaceID, serviceType, capabilities, emptyPriScheme);
+    if (target == nullptr) {
+        HiLog::Error(LABEL, "failed to find class to warm up, iid: %{public}u, serviceType: %{public}u.",
+                     interfaceID, serviceType);
+        return ERR_MATCHING_PLUGIN;
+    }
+
+    auto plugin = target->GetPluginRef().lock();
+    if (plugin == nullptr) {
+        HiLog::Error(LABEL, "failed to warm up, the plugin of class %{public}s is released.",
+                     target->GetClassName().c_str());
+        return ERR_INTERNAL;
+    }
+
+    // ref loads and starts the library, and an active plugin stays active after the deref.
+    // no object is created, so the instance limit of the class is not taken.
+    uint32_t ret = plugin->Ref();
+    if (ret != SUCCESS) {
+        HiLog::Error(LABEL, "failed to ref the plugin of class %{public}s, ERRNO: %{public}u.",
+                     target->GetClassName().c_str(), ret);
+        return ret;
+    }
+    plugin->DeRef();
+    return SUCCESS;
+}
+
+bool ImplClassMgr::IsActive(uint16_t interfaceID, uint16_t serviceType, const map<string, AttrData> &capabilities)
+{
+    PriorityScheme emptyPriScheme;
+    shared_ptr<ImplClass> target = ResolveClass(interfaceID, serviceType, capabilities, emptyPriScheme);
+    if (target == nullptr) {
+        return false;
+    }
+
+    auto plugin = target->GetPluginRef().lock();
+    return (plugin != nullptr) && plugin->IsActive();
+}
+
+shared_ptr<ImplClass> ImplClassMgr::ResolveClass(uint16_t interfaceID, uint16_t serviceType,
+                                                 const map<string, AttrData> &capabilities,
+                                                 const PriorityScheme &priorityScheme)
 {
     uint32_t serviceFlag = ImplClass::MakeServiceFlag(interfaceID, serviceType);
-    list<shared_ptr<ImplClass>> candidates;
 
-    HiLog::Debug(LABEL, "create object iid: %{public}u, serviceType: %{public}u.", interfaceID, serviceType);
+    // the classes only change under the write lock, the same request always resolves to the same class.
+    string resolvedKey;
+    bool isCacheable = BuildResolvedKey(serviceFlag, capabilities, priorityScheme, resolvedKey);
+    if (isCacheable) {
+        std::lock_guard<mutex> guard(resolvedMutex_);
+        auto resolvedIter = resolvedClasses_.find(resolvedKey);
+        if (resolvedIter != resolvedClasses_.end()) {
+            return resolvedIter->second;
+        }
+    }
 
+    // intern the capabilities once, then each class is matched by comparing integers.
+    list<shared_ptr<ImplClass>> candidates;
+    Capability::InternedCaps internedCaps;
+    Capability::InternRequest(capabilities, internedCaps);
     auto iter = srvSearchMultimap_.lower_bound(serviceFlag);
     auto endIter = srvSearchMultimap_.upper_bound(serviceFlag);
     for (; iter != endIter; ++iter) {
         shared_ptr<ImplClass> &temp = iter->second;
-        if ((!capabilities.empty()) && (!temp->IsCompatible(capabilities))) {
+        if ((!capabilities.empty()) && (!temp->IsCompatible(internedCaps))) {
             continue;
         }
         candidates.push_back(temp);
     }
 
     shared_ptr<ImplClass> target = SearchByPriority(candidates, priorityScheme);
-    if (target == nullptr) {
-        HiLog::Error(LABEL, "failed to find class by priority.");
-        errorCode = ERR_MATCHING_PLUGIN;
-        return nullptr;
+    if (isCacheable) {
+        std::lock_guard<mutex> guard(resolvedMutex_);
+        if (resolvedClasses_.size() >= MAX_RESOLVED_CLASSES) {
+            resolvedClasses_.clear();
+        }
+        resolvedClasses_[resolvedKey] = target;
     }
-
-    HiLog::Debug(LABEL, "search by priority result, className: %{public}s.", target->GetClassName().c_str());
-    return target->CreateObject(errorCode);
+    return target;
 }
 
 uint32_t ImplClassMgr::ImplClassMgrGetClassInfo(uint16_t interfaceID, uint16_t serviceType,
@@ -163,9 +236,11 @@ uint32_t ImplClassMgr::ImplClassMgrGetClassInfo(uint16_t interfaceID, uint16_t s
         return ERR_MATCHING_PLUGIN;
     }
 
+    Capability::InternedCaps internedCaps;
+    Capability::InternRequest(capabilities, internedCaps);
     for (; iter != endIter; ++iter) {
         shared_ptr<ImplClass> &temp = iter->second;
-        if ((capabilities.size() != 0) && (!temp->IsCompatible(capabilities))) {
+        if ((capabilities.size() != 0) && (!temp->IsCompatible(internedCaps))) {
             continue;
         }
         // after multiple filtering, there are only a few instances here, which will not cause massive logs.
@@ -294,6 +369,53 @@ shared_ptr<ImplClass> ImplClassMgr::SearchSimplePriority(const list<shared_ptr<I
     return *targetIter;
 }
 
+// only the requests of single value capabilities are cached, the values are written with their length so that
+// different requests never share a key.
+bool ImplClassMgr::BuildResolvedKey(uint32_t serviceFlag, const map<string, AttrData> &capabilities,
+                                    const PriorityScheme &priorityScheme, string &key)
+{
+    key = std::to_string(serviceFlag) + ":" + std::to_string(static_cast<int32_t>(priorityScheme.GetPriorityType())) +
+          ":" + std::to_string(priorityScheme.GetAttrKey().size()) + ":" + priorityScheme.GetAttrKey();
+    for (const auto &capability : capabilities) {
+        const AttrData &attr = capability.second;
+        string value;
+        switch (attr.GetType()) {
+            case AttrDataType::ATTR_DATA_NULL: {
+                break;
+            }
+            case AttrDataType::ATTR_DATA_BOOL: {
+                bool boolValue = false;
+                attr.GetValue(boolValue);
+                value = boolValue ? "1" : "0";
+                break;
+            }
+            case AttrDataType::ATTR_DATA_UINT32: {
+                uint32_t uint32Value = 0;
+                attr.GetValue(uint32Value);
+                value = std::to_string(uint32Value);
+                break;
+            }
+            case AttrDataType::ATTR_DATA_STRING: {
+                attr.GetValue(value);
+                break;
+            }
+            default: {
+                return false;
+            }
+        }
+        key += ":" + std::to_string(capability.first.size()) + ":" + capability.first + ":" +
+               std::to_string(static_cast<int32_t>(attr.GetType())) + ":" + std::to_string(value.size()) + ":" +
+               value;
+    }
+    return true;
+}
+
+void ImplClassMgr::ClearResolvedClasses()
+{
+    std::lock_guard<mutex> guard(resolvedMutex_);
+    resolvedClasses_.clear();
+}
+
 uint32_t ImplClassMgr::ComparePriority(const AttrData &lhs, const AttrData &rhs, PriorityType type)
 {
     if (lhs.GetType() != rhs.GetType()) {
@@ -17,6 +17,8 @@
 #define IMPL_CLASS_MGR_H
 
 #include <list>
+#include <map>
+#include <mutex>
 #include <string>
 #include "json.hpp"
 #include "nocopyable.h"
@@ -40,12 +42,19 @@ public:
     PluginClassBase *CreateObject(uint16_t interfaceID, uint16_t serviceType,
                                   const std::map<std::string, AttrData> &capabilities,
                                   const PriorityScheme &priorityScheme, uint32_t &errorCode);
+    // load and start the plugin of the class resolved for the request, without creating an object.
+    uint32_t WarmUp(uint16_t interfaceID, uint16_t serviceType, const std::map<std::string, AttrData> &capabilities);
+    // whether the plugin of the class resolved for the request is loaded and started.
+    bool IsActive(uint16_t interfaceID, uint16_t serviceType, const std::map<std::string, AttrData> &capabilities);
     uint32_t ImplClassMgrGetClassInfo(uint16_t interfaceID, uint16_t serviceType,
                           const std::map<std::string, AttrData> &capabilities, std::vector<ClassInfo> &classesInfo);
     std::shared_ptr<ImplClass> GetImplClass(const std::string &packageName, const std::string &className);
     DECLARE_DELAYED_REF_SINGLETON(ImplClassMgr);
 
 private:
+    std::shared_ptr<ImplClass> ResolveClass(uint16_t interfaceID, uint16_t serviceType,
+                                            const std::map<std::string, AttrData> &capabilities,
+                                            const PriorityScheme &priorityScheme);
     std::shared_ptr<ImplClass> SearchByPriority(const std::list<std::shared_ptr<ImplClass>> &candidates,
                                                 const PriorityScheme &priorityScheme);
     std::shared_ptr<ImplClass> SearchSimplePriority(const std::list<std::shared_ptr<ImplClass>> &candidates);
@@ -53,11 +62,18 @@ private:
     uint32_t CompareBoolPriority(const AttrData &lhs, const AttrData &rhs, PriorityType type);
     uint32_t CompareUint32Priority(const AttrData &lhs, const AttrData &rhs, PriorityType type);
     uint32_t CompareStringPriority(const AttrData &lhs, const AttrData &rhs, PriorityType type);
+    static bool BuildResolvedKey(uint32_t serviceFlag, const std::map<std::string, AttrData> &capabilities,
+                                 const PriorityScheme &priorityScheme, std::string &key);
+    void ClearResolvedClasses();
 
     using NameClassMultimap = PointerKeyMultimap<const std::string, std::shared_ptr<ImplClass>>;
     using ServiceClassMultimap = std::multimap<uint32_t, std::shared_ptr<ImplClass>>;
     NameClassMultimap classMultimap_;
     ServiceClassMultimap srvSearchMultimap_;
+    // the class resolved by CreateObject for the service flag, capabilities and priority scheme, nullptr if no
+    // class matches. it is cleared when any class is added or deleted.
+    std::mutex resolvedMutex_;
+    std::map<std::string, std::shared_ptr<ImplClass>> resolvedClasses_;
 };
 } // namespace MultimediaPlugin
 } // namespace OHOS
@@ -21,6 +21,7 @@
 #include "json_helper.h"
 #include "log_tags.h"
 #include "platform_adp.h"
+#include "plugin_mgr.h"
 #include "singleton.h"
 #ifdef _WIN32
 #include <windows.h>
@@ -30,7 +31,6 @@ HMODULE hDll = NULL;
 namespace OHOS {
 namespace MultimediaPlugin {
 using nlohmann::json;
-using std::istream;
 using std::istringstream;
 using std::recursive_mutex;
 using std::size_t;
@@ -60,14 +60,14 @@ Plugin::~Plugin()
         // this situation does not happen in design.
         // the process context can guarantee that this will not happen.
         // the judgment statement here is for protection and positioning purposes only.
-        HiLog::Error(LABEL, "release plugin: refNum: %{public}u.", refNum_);
+        HiLog::Error(LABEL, "release plugin: refNum: %{public}u.", refNum_.load());
     }
 
     implClassMgr_.DeleteClass(plugin_);
     FreeLibrary();
 }
 
-uint32_t Plugin::Register(istream &metadata, string &&libraryPath, weak_ptr<Plugin> &plugin)
+uint32_t Plugin::Register(const json &metadata, string &&libraryPath, weak_ptr<Plugin> &plugin)
 {
     std::unique_lock<std::recursive_mutex> guard(dynDataLock_);
     if (state_ != PluginState::PLUGIN_STATE_UNREGISTER) {
@@ -93,6 +93,12 @@ uint32_t Plugin::Ref()
 {
     // once the client make a ref, it can use the plugin at any time,
     // so we do the necessary preparations here.
+    // an active plugin stays active until it is released, so the steady state needs no lock.
+    if (state_.load(std::memory_order_acquire) == PluginState::PLUGIN_STATE_ACTIVE) {
+        refNum_.fetch_add(1, std::memory_order_relaxed);
+        return SUCCESS;
+    }
+
     std::unique_lock<std::recursive_mutex> guard(dynDataLock_);
     if (state_ == PluginState::PLUGIN_STATE_REGISTERED) {
         if (ResolveLibrary() != SUCCESS) {
@@ -112,33 +118,34 @@ uint32_t Plugin::Ref()
             state_ = PluginState::PLUGIN_STATE_REGISTERED;
             return ERR_GENERAL;
         }
-        state_ = PluginState::PLUGIN_STATE_ACTIVE;
+        // publish the functions resolved above to the lock free readers.
+        state_.store(PluginState::PLUGIN_STATE_ACTIVE, std::memory_order_release);
     }
 
-    if (state_ != PluginState::PLUGIN_STATE_ACTIVE) {
-        HiLog::Error(LABEL, "plugin ref: state error, state: %{public}d.", state_);
+    PluginState state = state_.load(std::memory_order_relaxed);
+    if (state != PluginState::PLUGIN_STATE_ACTIVE) {
+        HiLog::Error(LABEL, "plugin ref: state error, state: %{public}d.", static_cast<int32_t>(state));
         return ERR_GENERAL;
     }
 
-    ++refNum_;
-    HiLog::Debug(LABEL, "plugin refNum: %{public}d.", refNum_);
+    uint32_t refNum = refNum_.fetch_add(1, std::memory_order_relaxed) + 1;
+    HiLog::Debug(LABEL, "plugin refNum: %{public}u.", refNum);
     return SUCCESS;
 }
 
 void Plugin::DeRef()
 {
-    std::unique_lock<std::recursive_mutex> guard(dynDataLock_);
-    if (refNum_ == 0) {
-        // this situation does not happen in design.
-        // the process context can guarantee that this will not happen.
-        // the judgment statement here is for protection and positioning purposes only.
-        guard.unlock();
-        HiLog::Error(LABEL, "DeRef while RefNum is zero.");
-        return;
-    }
-
-    --refNum_;
-    HiLog::Debug(LABEL, "plugin refNum: %{public}d.", refNum_);
+    uint32_t refNum = refNum_.load(std::memory_order_relaxed);
+    do {
+        if (refNum == 0) {
+            // this situation does not happen in design.
+            // the process context can guarantee that this will not happen.
+            // the judgment statement here is for protection and positioning purposes only.
+            HiLog::Error(LABEL, "DeRef while RefNum is zero.");
+            return;
+        }
+    } while (!refNum_.compare_exchange_weak(refNum, refNum - 1, std::memory_order_release,
+                                            std::memory_order_relaxed));
 }
 
 void Plugin::Block()
@@ -159,16 +166,24 @@ void Plugin::Unblock()
 
 PluginCreateFunc Plugin::GetCreateFunc()
 {
-    std::unique_lock<std::recursive_mutex> guard(dynDataLock_);
-    if ((state_ != PluginState::PLUGIN_STATE_ACTIVE) || (refNum_ == 0)) {
+    // createFunc_ is set before the state becomes active, and is kept until the plugin is released.
+    PluginState state = state_.load(std::memory_order_acquire);
+    uint32_t refNum = refNum_.load(std::memory_order_relaxed);
+    if ((state != PluginState::PLUGIN_STATE_ACTIVE) || (refNum == 0)) {
         // In this case, we can't guarantee that the pointer is lasting valid.
-        HiLog::Error(LABEL, "failed to get create func, State: %{public}d, RefNum: %{public}u.", state_, refNum_);
+        HiLog::Error(LABEL, "failed to get create func, State: %{public}d, RefNum: %{public}u.",
+                     static_cast<int32_t>(state), refNum);
         return nullptr;
     }
 
     return createFunc_;
 }
 
+bool Plugin::IsActive() const
+{
+    return state_.load(std::memory_order_acquire) == PluginState::PLUGIN_STATE_ACTIVE;
+}
+
 const string &Plugin::GetLibraryPath() const
 {
     return libraryPath_;
@@ -186,6 +201,16 @@ uint32_t Plugin::ResolveLibrary()
     std::string pluginStopSymbol = "PluginExternalStop";
     std::string pluginCreateSymbol = "PluginExternalCreate";
 
+    StaticPluginFuncs staticFuncs;
+    if (DelayedRefSingleton<PluginMgr>::GetInstance().GetStaticPlugin(packageName_, staticFuncs)) {
+        // linked into the process, there is no library to load.
+        HiLog::Debug(LABEL, "static plugin: %{public}s.", packageName_.c_str());
+        startFunc_ = staticFuncs.startFunc;
+        stopFunc_ = staticFuncs.stopFunc;
+        createFunc_ = staticFuncs.createFunc;
+        return SUCCESS;
+    }
+
 #ifdef _WIN32
     hDll = platformAdp_.AdpLoadLibrary(libraryPath_);
     if (hDll == NULL) {
@@ -258,10 +283,8 @@ void Plugin::FreeLibrary()
 #endif
 }
 
-uint32_t Plugin::RegisterMetadata(istream &metadata, weak_ptr<Plugin> &plugin)
+uint32_t Plugin::RegisterMetadata(const json &root, weak_ptr<Plugin> &plugin)
 {
-    json root;
-    metadata >> root;
     if (JsonHelper::GetStringValue(root, "packageName", packageName_) != SUCCESS) {
         HiLog::Error(LABEL, "read packageName failed.");
         return ERR_INVALID_PARAMETER;
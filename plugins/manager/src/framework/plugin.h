@@ -16,9 +16,12 @@
 #ifndef PLUGIN_H
 #define PLUGIN_H
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include "json.hpp"
 #include "nocopyable.h"
 #include "plugin_errors.h"
 #include "plugin_export.h"
@@ -43,12 +46,13 @@ class Plugin final : public NoCopyable {
 public:
     Plugin();
     ~Plugin();
-    uint32_t Register(std::istream &metadata, std::string &&libraryPath, std::weak_ptr<Plugin> &plugin);
+    uint32_t Register(const nlohmann::json &metadata, std::string &&libraryPath, std::weak_ptr<Plugin> &plugin);
     uint32_t Ref();
     void DeRef();
     void Block();
     void Unblock();
     PluginCreateFunc GetCreateFunc();
+    bool IsActive() const;
     const std::string &GetLibraryPath() const;
     const std::string &GetPackageName() const;
 
@@ -62,7 +66,7 @@ private:
 
     uint32_t ResolveLibrary();
     void FreeLibrary();
-    uint32_t RegisterMetadata(std::istream &metadata, std::weak_ptr<Plugin> &plugin);
+    uint32_t RegisterMetadata(const nlohmann::json &root, std::weak_ptr<Plugin> &plugin);
     uint32_t CheckTargetVersion(const std::string &targetVersion);
     uint32_t AnalyzeVersion(const std::string &versionInfo, VersionNum &versionNum);
     uint32_t ExecuteVersionAnalysis(const std::string &input, VersionParseStep &step,
@@ -76,12 +80,14 @@ private:
     // non-dynamic data are protected by other means, that is: mutual exclusion between
     // the register and createObject processes.
     // current dynamic data includes:
-    // state_, handle_, refNum_, startFunc_, stopFunc_, createFunc_, blocked_.
+    // state_, handle_, startFunc_, stopFunc_, createFunc_, blocked_.
+    // the lock only guards the state transitions. once the plugin is active, it stays active until
+    // it is released, so Ref, DeRef and GetCreateFunc of an active plugin only use the atomics.
     std::recursive_mutex dynDataLock_;
-    PluginState state_ = PluginState::PLUGIN_STATE_UNREGISTER;
+    std::atomic<PluginState> state_ { PluginState::PLUGIN_STATE_UNREGISTER };
     std::weak_ptr<Plugin> plugin_;
     void *handle_ = nullptr;
-    uint32_t refNum_ = 0;
+    std::atomic<uint32_t> refNum_ { 0 };
     std::string libraryPath_;
     std::string packageName_;
     std::string version_;
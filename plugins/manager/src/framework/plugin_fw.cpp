@@ -33,13 +33,26 @@ using namespace OHOS::HiviewDFX;
 
 static constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "PluginFw" };
 
-uint32_t PluginFw::Register(const vector<string> &canonicalPaths)
+uint32_t PluginFw::Register(const vector<string> &canonicalPaths, const string &cacheDir)
 {
     HiLog::Debug(LABEL, "plugin register.");
     // Use the read-write lock to mutually exclusive write plugin information and read plugin information operations,
     // where Register() plays the write role.
     UniqueWriteGuard<RWLock> lk(DelayedRefSingleton<PluginInfoLock>::GetInstance().rwLock_);
-    return pluginMgr_.Register(canonicalPaths);
+    return pluginMgr_.Register(canonicalPaths, cacheDir);
+}
+
+uint32_t PluginFw::RegisterStaticPlugin(const string &packageName, PluginStartFunc startFunc, PluginStopFunc stopFunc,
+                                        PluginCreateFunc createFunc)
+{
+    HiLog::Debug(LABEL, "static plugin register: %{public}s.", packageName.c_str());
+    // the static plugins are looked up when a plugin is resolved in CreateObject(), so it plays the write role.
+    UniqueWriteGuard<RWLock> lk(DelayedRefSingleton<PluginInfoLock>::GetInstance().rwLock_);
+    StaticPluginFuncs funcs;
+    funcs.startFunc = startFunc;
+    funcs.stopFunc = stopFunc;
+    funcs.createFunc = createFunc;
+    return pluginMgr_.RegisterStaticPlugin(packageName, funcs);
 }
 
 PluginClassBase *PluginFw::CreateObject(uint16_t interfaceID, const string &className, uint32_t &errorCode)
@@ -60,6 +73,19 @@ PluginClassBase *PluginFw::CreateObject(uint16_t interfaceID, uint16_t serviceTy
     return implClassMgr_.CreateObject(interfaceID, serviceType, capabilities, priorityScheme, errorCode);
 }
 
+uint32_t PluginFw::WarmUp(uint16_t interfaceID, uint16_t serviceType, const map<string, AttrData> &capabilities)
+{
+    // WarmUp() refs the plugin as CreateObject() does, so it plays the read role.
+    UniqueReadGuard<RWLock> lk(DelayedRefSingleton<PluginInfoLock>::GetInstance().rwLock_);
+    return implClassMgr_.WarmUp(interfaceID, serviceType, capabilities);
+}
+
+bool PluginFw::IsActive(uint16_t interfaceID, uint16_t serviceType, const map<string, AttrData> &capabilities)
+{
+    UniqueReadGuard<RWLock> lk(DelayedRefSingleton<PluginInfoLock>::GetInstance().rwLock_);
+    return implClassMgr_.IsActive(interfaceID, serviceType, capabilities);
+}
+
 uint32_t PluginFw::PluginFwGetClassInfo(uint16_t interfaceID, uint16_t serviceType,
                                         const map<std::string, AttrData> &capabilities,
                                         vector<ClassInfo> &classesInfo)
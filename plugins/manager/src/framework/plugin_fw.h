@@ -25,6 +25,7 @@
 #include "plugin_class_base.h"
 #include "plugin_common_type.h"
 #include "plugin_errors.h"
+#include "plugin_export.h"
 #include "priority_scheme.h"
 
 namespace OHOS {
@@ -34,11 +35,15 @@ class ImplClassMgr;
 
 class PluginFw final : public NoCopyable {
 public:
-    uint32_t Register(const std::vector<std::string> &canonicalPaths);
+    uint32_t Register(const std::vector<std::string> &canonicalPaths, const std::string &cacheDir);
+    uint32_t RegisterStaticPlugin(const std::string &packageName, PluginStartFunc startFunc, PluginStopFunc stopFunc,
+                                  PluginCreateFunc createFunc);
     PluginClassBase *CreateObject(uint16_t interfaceID, const std::string &className, uint32_t &errorCode);
     PluginClassBase *CreateObject(uint16_t interfaceID, uint16_t serviceType,
                                   const std::map<std::string, AttrData> &capabilities,
                                   const PriorityScheme &priorityScheme, uint32_t &errorCode);
+    uint32_t WarmUp(uint16_t interfaceID, uint16_t serviceType, const std::map<std::string, AttrData> &capabilities);
+    bool IsActive(uint16_t interfaceID, uint16_t serviceType, const std::map<std::string, AttrData> &capabilities);
     uint32_t PluginFwGetClassInfo(uint16_t interfaceID, uint16_t serviceType,
                           const std::map<std::string, AttrData> &capabilities,
                           std::vector<ClassInfo> &classesInfo);
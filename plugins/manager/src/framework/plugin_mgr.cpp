@@ -22,6 +22,7 @@
 #include "log_tags.h"
 #include "platform_adp.h"
 #include "plugin.h"
+#include "plugin_registry_cache.h"
 
 namespace OHOS {
 namespace MultimediaPlugin {
@@ -36,12 +37,12 @@ using namespace OHOS::HiviewDFX;
 static constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "PluginMgr" };
 PlatformAdp &PluginMgr::platformAdp_ = DelayedRefSingleton<PlatformAdp>::GetInstance();
 
-uint32_t PluginMgr::Register(const vector<string> &canonicalPaths)
+uint32_t PluginMgr::Register(const vector<string> &canonicalPaths, const string &cacheDir)
 {
     bool pathTraversed = false;
     uint32_t errorCode = SUCCESS;
     for (const string &path : canonicalPaths) {
-        uint32_t result = TraverseFiles(path);
+        uint32_t result = TraverseFiles(path, cacheDir);
         if (result == SUCCESS) {
             pathTraversed = true;
         } else {
@@ -59,6 +60,34 @@ uint32_t PluginMgr::Register(const vector<string> &canonicalPaths)
     return SUCCESS;
 }
 
+uint32_t PluginMgr::RegisterStaticPlugin(const string &packageName, const StaticPluginFuncs &funcs)
+{
+    if (packageName.empty() || funcs.startFunc == nullptr || funcs.stopFunc == nullptr ||
+        funcs.createFunc == nullptr) {
+        HiLog::Error(LABEL, "invalid static plugin.");
+        return ERR_INVALID_PARAMETER;
+    }
+
+    auto insertRet = staticPlugins_.insert(std::make_pair(packageName, funcs));
+    if (!insertRet.second) {
+        HiLog::Error(LABEL, "static plugin %{public}s already registered.", packageName.c_str());
+        return ERR_GENERAL;
+    }
+
+    return SUCCESS;
+}
+
+bool PluginMgr::GetStaticPlugin(const string &packageName, StaticPluginFuncs &funcs) const
+{
+    auto iter = staticPlugins_.find(packageName);
+    if (iter == staticPlugins_.end()) {
+        return false;
+    }
+
+    funcs = iter->second;
+    return true;
+}
+
 // ------------------------------- private method -------------------------------
 PluginMgr::PluginMgr()
 {}
@@ -66,26 +95,34 @@ PluginMgr::PluginMgr()
 PluginMgr::~PluginMgr()
 {}
 
-uint32_t PluginMgr::TraverseFiles(const string &canonicalPath)
+uint32_t PluginMgr::TraverseFiles(const string &canonicalPath, const string &cacheDir)
 {
-    bool noTarget = true;
-    vector<string> strFiles;
-    GetDirFiles(canonicalPath, strFiles);
-    if (strFiles.empty()) {
-        HiLog::Error(LABEL, "failed to get dir files.");
-        return ERR_GENERAL;
-    }
+    PluginRegistryCache registryCache(canonicalPath, cacheDir);
+    vector<PluginRegistryEntry> entries;
+    if (!registryCache.Load(entries)) {
+        vector<string> strFiles;
+        GetDirFiles(canonicalPath, strFiles);
+        if (strFiles.empty()) {
+            HiLog::Error(LABEL, "failed to get dir files.");
+            return ERR_GENERAL;
+        }
 
-    string libraryPath;
-    for (const auto &file : strFiles) {
-        if (!CheckPluginMetaFile(file, libraryPath)) {
-            continue;
+        for (const auto &file : strFiles) {
+            PluginRegistryEntry entry;
+            if (!CheckPluginMetaFile(file, entry.metadata, entry.libraryPath)) {
+                continue;
+            }
+            entry.metadataPath = file;
+            entries.push_back(std::move(entry));
         }
-        noTarget = false;
-        RegisterPlugin(file, std::move(libraryPath));
+        registryCache.Save(strFiles, entries);
     }
 
-    if (noTarget) {
+    for (auto &entry : entries) {
+        RegisterPlugin(entry.metadata, std::move(entry.libraryPath));
+    }
+
+    if (entries.empty()) {
         HiLog::Warn(LABEL, "there is no plugin meta file in path.");
         return ERR_NO_TARGET;
     }
@@ -93,7 +130,7 @@ uint32_t PluginMgr::TraverseFiles(const string &canonicalPath)
     return SUCCESS;
 }
 
-bool PluginMgr::CheckPluginMetaFile(const string &candidateFile, string &libraryPath)
+bool PluginMgr::CheckPluginMetaFile(const string &candidateFile, json &metadata, string &libraryPath)
 {
     const string meatedataFileSuffix = "pluginmeta";
     const string dirSeparator = "/";
@@ -112,15 +149,14 @@ bool PluginMgr::CheckPluginMetaFile(const string &candidateFile, string &library
         return false;
     }
 
-    ifstream metadata(candidateFile);
-    if (!metadata) {
+    ifstream metadataFile(candidateFile);
+    if (!metadataFile) {
         HiLog::Error(LABEL, "failed to open metadata file.");
         return false;
     }
 
-    json root;
-    metadata >> root;
-    if (JsonHelper::GetStringValue(root, "libraryPath", libraryPath) != SUCCESS) {
+    metadataFile >> metadata;
+    if (JsonHelper::GetStringValue(metadata, "libraryPath", libraryPath) != SUCCESS) {
         HiLog::Error(LABEL, "read libraryPath failed.");
         return false;
     }
@@ -153,7 +189,7 @@ bool PluginMgr::CheckPluginMetaFile(const string &candidateFile, string &library
     return true;
 }
 
-uint32_t PluginMgr::RegisterPlugin(const string &metadataPath, string &&libraryPath)
+uint32_t PluginMgr::RegisterPlugin(const json &metadata, string &&libraryPath)
 {
     auto iter = plugins_.find(&libraryPath);
     if (iter != plugins_.end()) {
@@ -162,12 +198,6 @@ uint32_t PluginMgr::RegisterPlugin(const string &metadataPath, string &&libraryP
         return ERR_GENERAL;
     }
 
-    ifstream metadata(metadataPath);
-    if (!metadata) {
-        HiLog::Error(LABEL, "failed to open metadata file.");
-        return ERR_GENERAL;
-    }
-
     auto plugin = std::make_shared<Plugin>();
     if (plugin == nullptr) {
         HiLog::Error(LABEL, "failed to create Plugin.");
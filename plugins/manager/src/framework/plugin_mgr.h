@@ -16,11 +16,14 @@
 #ifndef PLUGIN_MGR_H
 #define PLUGIN_MGR_H
 
+#include <map>
 #include <string>
 #include <vector>
+#include "json.hpp"
 #include "nocopyable.h"
 #include "singleton.h"
 #include "plugin_errors.h"
+#include "plugin_export.h"
 #include "pointer_key_map.h"
 
 namespace OHOS {
@@ -28,19 +31,29 @@ namespace MultimediaPlugin {
 class PlatformAdp;
 class Plugin;
 
+struct StaticPluginFuncs {
+    PluginStartFunc startFunc = nullptr;
+    PluginStopFunc stopFunc = nullptr;
+    PluginCreateFunc createFunc = nullptr;
+};
+
 class PluginMgr final : public NoCopyable {
 public:
-    uint32_t Register(const std::vector<std::string> &canonicalPaths);
+    uint32_t Register(const std::vector<std::string> &canonicalPaths, const std::string &cacheDir);
+    uint32_t RegisterStaticPlugin(const std::string &packageName, const StaticPluginFuncs &funcs);
+    bool GetStaticPlugin(const std::string &packageName, StaticPluginFuncs &funcs) const;
     DECLARE_DELAYED_REF_SINGLETON(PluginMgr);
 
 private:
-    uint32_t TraverseFiles(const std::string &canonicalPath);
-    bool CheckPluginMetaFile(const std::string &candidateFile, std::string &libraryPath);
-    uint32_t RegisterPlugin(const std::string &metadataPath, std::string &&libraryPath);
+    uint32_t TraverseFiles(const std::string &canonicalPath, const std::string &cacheDir);
+    bool CheckPluginMetaFile(const std::string &candidateFile, nlohmann::json &metadata, std::string &libraryPath);
+    uint32_t RegisterPlugin(const nlohmann::json &metadata, std::string &&libraryPath);
 
     static PlatformAdp &platformAdp_;
     using PluginMap = PointerKeyMap<const std::string, std::shared_ptr<Plugin>>;
     PluginMap plugins_;
+    // the interface functions of the packages linked into the process, used instead of loading their libraries.
+    std::map<std::string, StaticPluginFuncs> staticPlugins_;
 };
 } // namespace MultimediaPlugin
 } // namespace OHOS
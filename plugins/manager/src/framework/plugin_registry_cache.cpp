@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin_registry_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <set>
+#include "directory_ex.h"
+#include "hilog/log.h"
+#include "log_tags.h"
+#if !defined(_WIN32) && !defined(_APPLE)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace OHOS {
+namespace MultimediaPlugin {
+using nlohmann::json;
+using std::set;
+using std::string;
+using std::vector;
+using namespace OHOS::HiviewDFX;
+
+static constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "PluginRegistryCache" };
+
+namespace {
+constexpr uint32_t CACHE_MAGIC = 0x50524743;  // "PRGC"
+constexpr uint32_t CACHE_VERSION = 2;
+constexpr uint32_t MAX_TEMP_FILE_ATTEMPTS = 8;
+// created in the cache dir of the caller, only accessible to the effective user.
+const string REGISTRY_CACHE_SUBDIR = "multimediaplugin/";
+const string REGISTRY_CACHE_SUFFIX = ".regcache";
+std::atomic<uint32_t> g_tempFileCounter { 0 };
+std::atomic<bool> g_unwritableLogged { false };
+
+class CacheWriter {
+public:
+    void WriteUint32(uint32_t value)
+    {
+        buffer_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    void WriteUint64(uint64_t value)
+    {
+        buffer_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    void WriteBlob(const void *data, size_t size)
+    {
+        WriteUint32(static_cast<uint32_t>(size));
+        buffer_.append(static_cast<const char *>(data), size);
+    }
+    void WriteString(const string &value)
+    {
+        WriteBlob(value.data(), value.size());
+    }
+    const string &GetBuffer() const
+    {
+        return buffer_;
+    }
+
+private:
+    string buffer_;
+};
+
+class CacheReader {
+public:
+    CacheReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+    bool ReadUint32(uint32_t &value)
+    {
+        return ReadRaw(&value, sizeof(value));
+    }
+    bool ReadUint64(uint64_t &value)
+    {
+        return ReadRaw(&value, sizeof(value));
+    }
+    bool ReadBlob(const uint8_t *&data, size_t &size)
+    {
+        uint32_t blobSize = 0;
+        if (!ReadUint32(blobSize) || blobSize > size_ - offset_) {
+            return false;
+        }
+        data = data_ + offset_;
+        size = blobSize;
+        offset_ += blobSize;
+        return true;
+    }
+    bool ReadString(string &value)
+    {
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+        if (!ReadBlob(data, size)) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char *>(data), size);
+        return true;
+    }
+
+private:
+    bool ReadRaw(void *value, size_t size)
+    {
+        if (size > size_ - offset_) {
+            return false;
+        }
+        std::copy(data_ + offset_, data_ + offset_ + size, static_cast<uint8_t *>(value));
+        offset_ += size;
+        return true;
+    }
+
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+};
+} // namespace
+
+#if !defined(_WIN32) && !defined(_APPLE)
+static bool IsPrivate(const struct stat &fileStat)
+{
+    return (fileStat.st_uid == geteuid()) && ((fileStat.st_mode & (S_IRWXG | S_IRWXO)) == 0);
+}
+#endif
+
+PluginRegistryCache::PluginRegistryCache(const string &canonicalPath, const string &cacheDir)
+    : canonicalPath_(canonicalPath), cacheDir_(cacheDir)
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    if (cacheDir_.empty()) {
+        return;
+    }
+    // one cache per directory in a dir of the user, a cache of another user is never trusted.
+    cacheDir_ = IncludeTrailingPathDelimiter(cacheDir_) + REGISTRY_CACHE_SUBDIR;
+    string name = canonicalPath;
+    for (char &c : name) {
+        if (c == '/') {
+            c = '_';
+        }
+    }
+    cachePath_ = cacheDir_ + name + REGISTRY_CACHE_SUFFIX;
+#endif
+}
+
+bool PluginRegistryCache::Load(vector<PluginRegistryEntry> &entries)
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    if (cachePath_.empty() || !CheckCacheDir(false)) {
+        return false;
+    }
+    int fd = open(cachePath_.c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) {
+        HiLog::Debug(LABEL, "no registry cache.");
+        return false;
+    }
+    struct stat cacheStat;
+    if (fstat(fd, &cacheStat) != 0 || !S_ISREG(cacheStat.st_mode) || !IsPrivate(cacheStat) ||
+        cacheStat.st_size <= 0) {
+        HiLog::Error(LABEL, "untrusted registry cache.");
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(cacheStat.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        HiLog::Error(LABEL, "failed to map registry cache.");
+        return false;
+    }
+    bool ret = ParseCache(static_cast<const uint8_t *>(data), size, entries);
+    munmap(data, size);
+    if (!ret) {
+        entries.clear();
+    }
+    return ret;
+#else
+    return false;
+#endif
+}
+
+void PluginRegistryCache::Save(const vector<string> &dirFiles, const vector<PluginRegistryEntry> &entries)
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    if (cachePath_.empty()) {
+        return;
+    }
+    set<string> dirs = { canonicalPath_ };
+    for (const string &file : dirFiles) {
+        dirs.insert(ExtractFilePath(file));
+    }
+    CacheWriter writer;
+    writer.WriteUint32(CACHE_MAGIC);
+    writer.WriteUint32(CACHE_VERSION);
+    writer.WriteUint32(static_cast<uint32_t>(dirs.size()));
+    writer.WriteUint32(static_cast<uint32_t>(entries.size()));
+    FileStamp stamp;
+    for (const string &dir : dirs) {
+        if (!GetFileStamp(dir, stamp)) {
+            return;
+        }
+        writer.WriteString(dir);
+        writer.WriteUint64(static_cast<uint64_t>(stamp.mtimeSec));
+        writer.WriteUint64(static_cast<uint64_t>(stamp.mtimeNsec));
+        writer.WriteUint64(stamp.size);
+    }
+    for (const PluginRegistryEntry &entry : entries) {
+        if (!GetFileStamp(entry.metadataPath, stamp)) {
+            return;
+        }
+        writer.WriteString(entry.metadataPath);
+        writer.WriteUint64(static_cast<uint64_t>(stamp.mtimeSec));
+        writer.WriteUint64(static_cast<uint64_t>(stamp.mtimeNsec));
+        writer.WriteUint64(stamp.size);
+        // the library is loaded later by the registered path, so a replaced library rebuilds the cache too.
+        if (!GetFileStamp(entry.libraryPath, stamp)) {
+            return;
+        }
+        writer.WriteString(entry.libraryPath);
+        writer.WriteUint64(static_cast<uint64_t>(stamp.mtimeSec));
+        writer.WriteUint64(static_cast<uint64_t>(stamp.mtimeNsec));
+        writer.WriteUint64(stamp.size);
+        vector<uint8_t> metadata = json::to_cbor(entry.metadata);
+        writer.WriteBlob(metadata.data(), metadata.size());
+    }
+
+    // write a new temp file and rename it, so the other processes never map a partial cache.
+    if (!CheckCacheDir(true)) {
+        return;
+    }
+    string tempPath;
+    int fd = -1;
+    for (uint32_t i = 0; i < MAX_TEMP_FILE_ATTEMPTS && fd < 0; i++) {
+        tempPath = cachePath_ + "." + std::to_string(getpid()) + "." + std::to_string(g_tempFileCounter++);
+        fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (fd < 0 && errno != EEXIST) {
+            break;
+        }
+    }
+    if (fd < 0) {
+        LogUnwritable();
+        return;
+    }
+    const string &buffer = writer.GetBuffer();
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t ret = write(fd, buffer.data() + written, buffer.size() - written);
+        if (ret <= 0) {
+            break;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    close(fd);
+    if (written != buffer.size() || rename(tempPath.c_str(), cachePath_.c_str()) != 0) {
+        HiLog::Error(LABEL, "failed to write registry cache.");
+        unlink(tempPath.c_str());
+    }
+#endif
+}
+
+bool PluginRegistryCache::GetFileStamp(const string &path, FileStamp &stamp)
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    struct stat fileStat;
+    if (stat(path.c_str(), &fileStat) != 0) {
+        return false;
+    }
+    stamp.mtimeSec = static_cast<int64_t>(fileStat.st_mtim.tv_sec);
+    stamp.mtimeNsec = static_cast<int64_t>(fileStat.st_mtim.tv_nsec);
+    stamp.size = static_cast<uint64_t>(fileStat.st_size);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PluginRegistryCache::IsSameStamp(const FileStamp &lhs, const FileStamp &rhs)
+{
+    return (lhs.mtimeSec == rhs.mtimeSec) && (lhs.mtimeNsec == rhs.mtimeNsec) && (lhs.size == rhs.size);
+}
+
+void PluginRegistryCache::LogUnwritable() const
+{
+    // the plugins still work without the cache, so it is only told once.
+    if (!g_unwritableLogged.exchange(true)) {
+        HiLog::Info(LABEL, "registry cache dir %{public}s is not writable, the plugins are not cached.",
+                    cacheDir_.c_str());
+    }
+}
+
+bool PluginRegistryCache::CheckCacheDir(bool create) const
+{
+#if !defined(_WIN32) && !defined(_APPLE)
+    if (create && mkdir(cacheDir_.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+        LogUnwritable();
+        return false;
+    }
+    // the dir may be created by another user before, then it is not used.
+    struct stat dirStat;
+    if (lstat(cacheDir_.c_str(), &dirStat) != 0) {
+        return false;
+    }
+    if (!S_ISDIR(dirStat.st_mode) || !IsPrivate(dirStat)) {
+        HiLog::Error(LABEL, "untrusted registry cache dir.");
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PluginRegistryCache::ParseCache(const uint8_t *data, size_t size, vector<PluginRegistryEntry> &entries)
+{
+    CacheReader reader(data, size);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t dirNum = 0;
+    uint32_t entryNum = 0;
+    if (!reader.ReadUint32(magic) || magic != CACHE_MAGIC || !reader.ReadUint32(version) ||
+        version != CACHE_VERSION || !reader.ReadUint32(dirNum) || !reader.ReadUint32(entryNum)) {
+        HiLog::Error(LABEL, "invalid registry cache header.");
+        return false;
+    }
+
+    string path;
+    FileStamp cached;
+    FileStamp current;
+    uint64_t mtimeSec = 0;
+    uint64_t mtimeNsec = 0;
+    for (uint32_t i = 0; i < dirNum + entryNum; i++) {
+        if (!reader.ReadString(path) || !reader.ReadUint64(mtimeSec) || !reader.ReadUint64(mtimeNsec) ||
+            !reader.ReadUint64(cached.size)) {
+            HiLog::Error(LABEL, "broken registry cache.");
+            return false;
+        }
+        cached.mtimeSec = static_cast<int64_t>(mtimeSec);
+        cached.mtimeNsec = static_cast<int64_t>(mtimeNsec);
+        if (!GetFileStamp(path, current) || !IsSameStamp(cached, current)) {
+            HiLog::Debug(LABEL, "stale registry cache.");
+            return false;
+        }
+        if (i < dirNum) {
+            continue;
+        }
+
+        PluginRegistryEntry entry;
+        const uint8_t *metadata = nullptr;
+        size_t metadataSize = 0;
+        if (!reader.ReadString(entry.libraryPath) || !reader.ReadUint64(mtimeSec) || !reader.ReadUint64(mtimeNsec) ||
+            !reader.ReadUint64(cached.size) || !reader.ReadBlob(metadata, metadataSize)) {
+            HiLog::Error(LABEL, "broken registry cache entry.");
+            return false;
+        }
+        cached.mtimeSec = static_cast<int64_t>(mtimeSec);
+        cached.mtimeNsec = static_cast<int64_t>(mtimeNsec);
+        if (!GetFileStamp(entry.libraryPath, current) || !IsSameStamp(cached, current)) {
+            HiLog::Debug(LABEL, "stale registry cache library.");
+            return false;
+        }
+        entry.metadata = json::from_cbor(metadata, metadata + metadataSize, true, false);
+        if (entry.metadata.is_discarded()) {
+            HiLog::Error(LABEL, "broken registry cache metadata.");
+            return false;
+        }
+        entry.metadataPath = std::move(path);
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+} // namespace MultimediaPlugin
+} // namespace OHOS
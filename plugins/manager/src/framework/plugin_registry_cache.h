@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PLUGIN_REGISTRY_CACHE_H
+#define PLUGIN_REGISTRY_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace MultimediaPlugin {
+struct PluginRegistryEntry {
+    std::string metadataPath;
+    std::string libraryPath;  // checked by the plugin manager when the cache was built.
+    nlohmann::json metadata;
+};
+
+// binary cache of the plugin metadata files in a plugin directory, so the registration of a process doesn't walk
+// the directory and parse the json text again. the cache is validated against the mtime of the directories and
+// the mtime and size of the metadata files and plugin libraries, and rebuilt by the plugin manager if it doesn't
+// match. the cache is kept in a directory private to the effective user, created in the cacheDir writable by the
+// process, an empty cacheDir disables the cache.
+class PluginRegistryCache final : public NoCopyable {
+public:
+    PluginRegistryCache(const std::string &canonicalPath, const std::string &cacheDir);
+    ~PluginRegistryCache() = default;
+    // return false if the cache is missing, broken, stale or not owned by the effective user.
+    bool Load(std::vector<PluginRegistryEntry> &entries);
+    // dirFiles are all files found in the directory, the directories they are in are checked by Load.
+    void Save(const std::vector<std::string> &dirFiles, const std::vector<PluginRegistryEntry> &entries);
+    const std::string &GetCachePath() const
+    {
+        return cachePath_;
+    }
+
+private:
+    struct FileStamp {
+        int64_t mtimeSec = 0;
+        int64_t mtimeNsec = 0;
+        uint64_t size = 0;
+    };
+    static bool GetFileStamp(const std::string &path, FileStamp &stamp);
+    static bool IsSameStamp(const FileStamp &lhs, const FileStamp &rhs);
+    void LogUnwritable() const;
+    bool CheckCacheDir(bool create) const;
+    bool ParseCache(const uint8_t *data, size_t size, std::vector<PluginRegistryEntry> &entries);
+
+    std::string canonicalPath_;
+    std::string cacheDir_;
+    std::string cachePath_;
+};
+} // namespace MultimediaPlugin
+} // namespace OHOS
+
+#endif // PLUGIN_REGISTRY_CACHE_H
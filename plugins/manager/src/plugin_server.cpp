@@ -14,6 +14,8 @@
  */
 
 #include "plugin_server.h"
+#include <chrono>
+#include <thread>
 #include "hilog/log.h"
 #include "singleton.h"
 #include "log_tags.h"
@@ -23,14 +25,17 @@
 
 namespace OHOS {
 namespace MultimediaPlugin {
+using std::lock_guard;
 using std::map;
+using std::mutex;
 using std::string;
+using std::unique_lock;
 using std::vector;
 using namespace OHOS::HiviewDFX;
 
 static constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "PluginServer" };
 
-uint32_t PluginServer::Register(vector<string> &&pluginPaths)
+uint32_t PluginServer::Register(vector<string> &&pluginPaths, const string &cacheDir)
 {
     vector<string> canonicalPaths;
     vector<string> gstCanonicalPaths;
@@ -74,7 +79,7 @@ uint32_t PluginServer::Register(vector<string> &&pluginPaths)
     }
 
     if (!canonicalPaths.empty()) {
-        uint32_t result = pluginFw_.Register(canonicalPaths);
+        uint32_t result = pluginFw_.Register(canonicalPaths, cacheDir);
         if (result != SUCCESS) {
             HiLog::Error(LABEL, "failed to register plugin path, ERRNO: %{public}u.", result);
             return result;
@@ -84,6 +89,24 @@ uint32_t PluginServer::Register(vector<string> &&pluginPaths)
     return SUCCESS;
 }
 
+uint32_t PluginServer::RegisterStaticPlugin(const string &packageName, StaticStartFunc startFunc,
+                                            StaticStopFunc stopFunc, StaticCreateFunc createFunc)
+{
+    return pluginFw_.RegisterStaticPlugin(packageName, startFunc, stopFunc, createFunc);
+}
+
+bool PluginServer::IsWarmUpDone()
+{
+    lock_guard<mutex> guard(warmUpMutex_);
+    return !isWarmingUp_;
+}
+
+bool PluginServer::WaitWarmUp(uint32_t timeoutMs)
+{
+    unique_lock<mutex> guard(warmUpMutex_);
+    return warmUpCond_.wait_for(guard, std::chrono::milliseconds(timeoutMs), [this] { return !isWarmingUp_; });
+}
+
 // ------------------------------- private method -------------------------------
 PluginServer::PluginServer()
     : platformAdp_(DelayedRefSingleton<PlatformAdp>::GetInstance()),
@@ -155,6 +178,55 @@ uint32_t PluginServer::PluginServerGetClassInfo(uint16_t interfaceID, uint16_t s
     return SUCCESS;
 }
 
+uint32_t PluginServer::WarmUp(uint16_t interfaceID, uint16_t serviceType,
+                              const vector<map<string, AttrData>> &capabilitiesList)
+{
+    WarmUpTask task;
+    task.interfaceID = interfaceID;
+    task.serviceType = serviceType;
+    lock_guard<mutex> guard(warmUpMutex_);
+    if (capabilitiesList.empty()) {
+        warmUpTasks_.push_back(task);
+    }
+    for (const auto &capabilities : capabilitiesList) {
+        task.capabilities = capabilities;
+        warmUpTasks_.push_back(task);
+    }
+    if (isWarmingUp_) {
+        return SUCCESS;
+    }
+
+    // the thread exits when the tasks run out, the server is a singleton lives until the process exits.
+    isWarmingUp_ = true;
+    std::thread(&PluginServer::WarmUpLoop, this).detach();
+    return SUCCESS;
+}
+
+bool PluginServer::IsPluginActive(uint16_t interfaceID, uint16_t serviceType,
+                                  const map<string, AttrData> &capabilities)
+{
+    return pluginFw_.IsActive(interfaceID, serviceType, capabilities);
+}
+
+void PluginServer::WarmUpLoop()
+{
+    unique_lock<mutex> guard(warmUpMutex_);
+    while (!warmUpTasks_.empty()) {
+        WarmUpTask task = std::move(warmUpTasks_.front());
+        warmUpTasks_.pop_front();
+        guard.unlock();
+        // only the plugin is loaded and started, no object is created to take an instance of the class.
+        uint32_t errorCode = pluginFw_.WarmUp(task.interfaceID, task.serviceType, task.capabilities);
+        if (errorCode != SUCCESS) {
+            HiLog::Error(LABEL, "failed to warm up iid: %{public}hu, service type: %{public}hu, ERRNO: %{public}u.",
+                         task.interfaceID, task.serviceType, errorCode);
+        }
+        guard.lock();
+    }
+    isWarmingUp_ = false;
+    warmUpCond_.notify_all();
+}
+
 PluginFWType PluginServer::AnalyzeFWType(const string &canonicalPath)
 {
     // for the current rule, contains the word "/gstreamer" is considered to be the gstreamer plugin directory.
@@ -14,7 +14,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
 #include "abs_image_detector.h"
 #include "hilog/log.h"
 #include "log_tags.h"
@@ -55,6 +58,12 @@ void PluginManagerTest::SetUp(void)
 void PluginManagerTest::TearDown(void)
 {}
 
+static bool HasClass(const vector<ClassInfo> &classesInfo, const string &className)
+{
+    return std::any_of(classesInfo.begin(), classesInfo.end(),
+                       [&className](const ClassInfo &info) { return info.className == className; });
+}
+
 /**
  * @tc.name: TestRegister001
  * @tc.desc: Verify that the plugin management module supports the basic scenario of
@@ -439,6 +448,59 @@ HWTEST_F(PluginManagerTest, TestCreateByCapabilities002, TestSize.Level3)
     EXPECT_EQ(errorCode, ERR_MATCHING_PLUGIN);
 }
 
+/**
+ * @tc.name: TestCreateByCapabilities003
+ * @tc.desc: Verify that the repeated creations by the same capabilities resolve to the same class,
+ *           and the resolved classes are refreshed after registering.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManagerTest, TestCreateByCapabilities003, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. Register multiple plugin directories with multiple valid plugin packages.
+     * @tc.expected: step1. The directories were registered successfully.
+     */
+    PluginServer &pluginServer = DelayedRefSingleton<PluginServer>::GetInstance();
+    vector<string> pluginPaths = { "/system/etc/multimediaplugin", "/system/etc/multimediaplugin/testplugins2" };
+    uint32_t ret = pluginServer.Register(std::move(pluginPaths));
+    ASSERT_EQ(ret, SUCCESS);
+
+    /**
+     * @tc.steps: step2. Create plugin objects by the same capabilities several times.
+     * @tc.expected: step2. All the plugin objects are of the same class.
+     */
+    uint32_t errorCode;
+    // "labelNum" means capability name, 10000 means capability value, exist in metadata.
+    map<string, AttrData> capabilities = { { "labelNum", AttrData(static_cast<uint32_t>(10000)) } };
+    for (uint32_t i = 0; i < 3; i++) {
+        AbsImageDetector *labelDetector =
+            pluginServer.CreateObject<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilities, errorCode);
+        ASSERT_NE(labelDetector, nullptr);
+        labelDetector->Prepare();
+        string result = labelDetector->Process();
+        delete labelDetector;
+        ASSERT_EQ(result, "CloudLabelDetector");
+    }
+
+    /**
+     * @tc.steps: step3. Create a plugin object by unmatched capabilities before and after registering again.
+     * @tc.expected: step3. Creation failed both times with the error code indicating the reason.
+     */
+    // "labelNum" means capability name, 128 means capability value, not exist in metadata.
+    map<string, AttrData> unknownCapabilities = { { "labelNum", AttrData(static_cast<uint32_t>(128)) } };
+    AbsImageDetector *unknownDetector =
+        pluginServer.CreateObject<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, unknownCapabilities, errorCode);
+    EXPECT_EQ(unknownDetector, nullptr);
+    EXPECT_EQ(errorCode, ERR_MATCHING_PLUGIN);
+    pluginPaths = { "/system/etc/multimediaplugin/testplugins" };
+    ret = pluginServer.Register(std::move(pluginPaths));
+    ASSERT_EQ(ret, SUCCESS);
+    unknownDetector =
+        pluginServer.CreateObject<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, unknownCapabilities, errorCode);
+    EXPECT_EQ(unknownDetector, nullptr);
+    EXPECT_EQ(errorCode, ERR_MATCHING_PLUGIN);
+}
+
 /**
  * @tc.name: TestPluginPriority001
  * @tc.desc: Verify that the plugin class static priority function is correct.
@@ -641,6 +703,79 @@ HWTEST_F(PluginManagerTest, TestGetClassByCapbility002, TestSize.Level3)
     ASSERT_NE(errorCode, SUCCESS);
 }
 
+/**
+ * @tc.name: TestGetClassByCapbility003
+ * @tc.desc: Verify that the capabilities registered with the plugin packages are matched by their interned ids,
+ *           and the capability names or string values which are never registered match nothing.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManagerTest, TestGetClassByCapbility003, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. Register a directory with the plugin packages of string, string set, uint32 set and
+     *                   uint32 range capabilities.
+     * @tc.expected: step1. The directory was registered successfully.
+     */
+    PluginServer &pluginServer = DelayedRefSingleton<PluginServer>::GetInstance();
+    vector<string> pluginPaths = { "/system/etc/multimediaplugin/testplugins2" };
+    uint32_t ret = pluginServer.Register(std::move(pluginPaths));
+    ASSERT_EQ(ret, SUCCESS);
+
+    /**
+     * @tc.steps: step2. Get classes information by the string values registered in the metadata.
+     * @tc.expected: step2. The string value matches the class of the same string and the class of the string
+     *                      set containing it.
+     */
+    vector<ClassInfo> classesInfo;
+    map<string, AttrData> capabilities = { { "labelNum", AttrData(string("256")) } };
+    uint32_t errorCode = pluginServer.PluginServerGetClassInfo<AbsImageDetector>(AbsImageDetector::SERVICE_LANDMARK,
+                                                                                 capabilities, classesInfo);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_EQ(HasClass(classesInfo, "OHOS::PluginExample::LabelDetector2"), true);
+    ASSERT_EQ(HasClass(classesInfo, "OHOS::PluginExample::CloudLabelDetector2"), true);
+    classesInfo.clear();
+    capabilities = { { "labelNum", AttrData(string("512")) } };
+    errorCode = pluginServer.PluginServerGetClassInfo<AbsImageDetector>(AbsImageDetector::SERVICE_LANDMARK,
+                                                                        capabilities, classesInfo);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_EQ(HasClass(classesInfo, "OHOS::PluginExample::LabelDetector2"), false);
+    ASSERT_EQ(HasClass(classesInfo, "OHOS::PluginExample::CloudLabelDetector2"), true);
+
+    /**
+     * @tc.steps: step3. Get classes information by the uint32 values in the registered set and range.
+     * @tc.expected: step3. The classes of the set and the range are found.
+     */
+    classesInfo.clear();
+    capabilities = { { "labelNum", AttrData(static_cast<uint32_t>(512)) } };
+    errorCode = pluginServer.PluginServerGetClassInfo<AbsImageDetector>(AbsImageDetector::SERVICE_FACE,
+                                                                        capabilities, classesInfo);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_EQ(HasClass(classesInfo, "OHOS::PluginExample::LabelDetector3"), true);
+    classesInfo.clear();
+    capabilities = { { "labelNum", AttrData(static_cast<uint32_t>(120), static_cast<uint32_t>(150)) } };
+    errorCode = pluginServer.PluginServerGetClassInfo<AbsImageDetector>(AbsImageDetector::SERVICE_TEXT,
+                                                                        capabilities, classesInfo);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_EQ(HasClass(classesInfo, "OHOS::PluginExample::CloudLabelDetector3"), true);
+
+    /**
+     * @tc.steps: step4. Get classes information by a string value and a capability name never registered,
+     *                   which are interned to the unknown id.
+     * @tc.expected: step4. No class is found.
+     */
+    classesInfo.clear();
+    capabilities = { { "labelNum", AttrData(string("2048")) } };
+    errorCode = pluginServer.PluginServerGetClassInfo<AbsImageDetector>(AbsImageDetector::SERVICE_LANDMARK,
+                                                                        capabilities, classesInfo);
+    ASSERT_NE(errorCode, SUCCESS);
+    ASSERT_EQ(classesInfo.size(), 0UL);
+    capabilities = { { "labelNumUnregistered", AttrData(string("256")) } };
+    errorCode = pluginServer.PluginServerGetClassInfo<AbsImageDetector>(AbsImageDetector::SERVICE_LANDMARK,
+                                                                        capabilities, classesInfo);
+    ASSERT_NE(errorCode, SUCCESS);
+    ASSERT_EQ(classesInfo.size(), 0UL);
+}
+
 /**
  * @tc.name: TestInstanceLimit001
  * @tc.desc: Verify cross-create multiple plugin objects within the limit of the number of instances.
@@ -722,6 +857,124 @@ HWTEST_F(PluginManagerTest, TestInstanceLimit003, TestSize.Level3)
     ASSERT_EQ(DoTestInstanceLimit003(pluginServer), SUCCESS);
 }
 
+/**
+ * @tc.name: TestWarmUp001
+ * @tc.desc: Verify that the plugins are resolved in the background and can be created after warming up.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManagerTest, TestWarmUp001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. Register multiple plugin directories with multiple valid plugin packages.
+     * @tc.expected: step1. The directories were registered successfully.
+     */
+    PluginServer &pluginServer = DelayedRefSingleton<PluginServer>::GetInstance();
+    vector<string> pluginPaths = { "/system/etc/multimediaplugin", "/system/etc/multimediaplugin/testplugins2" };
+    uint32_t ret = pluginServer.Register(std::move(pluginPaths));
+    ASSERT_EQ(ret, SUCCESS);
+
+    /**
+     * @tc.steps: step2. Warm up the plugins by matched and unmatched capabilities, and wait for them.
+     * @tc.expected: step2. The warm up is done in time, and an unmatched capability doesn't block it.
+     */
+    // "labelNum" means capability name, 10000 exists in metadata while 128 doesn't.
+    vector<map<string, AttrData>> capabilitiesList = {
+        { { "labelNum", AttrData(static_cast<uint32_t>(10000)) } },
+        { { "labelNum", AttrData(static_cast<uint32_t>(128)) } },
+    };
+    ret = pluginServer.WarmUp<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilitiesList);
+    ASSERT_EQ(ret, SUCCESS);
+    ASSERT_EQ(pluginServer.WaitWarmUp(1000), true);
+    ASSERT_EQ(pluginServer.IsWarmUpDone(), true);
+
+    /**
+     * @tc.steps: step3. Check the plugins of the warmed up capabilities before any object is created.
+     * @tc.expected: step3. The matched plugin is loaded and started, no plugin matches the unmatched capability.
+     */
+    ASSERT_EQ(pluginServer.IsPluginActive<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilitiesList[0]),
+              true);
+    ASSERT_EQ(pluginServer.IsPluginActive<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilitiesList[1]),
+              false);
+
+    /**
+     * @tc.steps: step4. Create a plugin object by the warmed up capabilities.
+     * @tc.expected: step4. The plugin object was created successfully.
+     */
+    uint32_t errorCode;
+    AbsImageDetector *labelDetector =
+        pluginServer.CreateObject<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilitiesList[0], errorCode);
+    ASSERT_NE(labelDetector, nullptr);
+    labelDetector->Prepare();
+    string result = labelDetector->Process();
+    delete labelDetector;
+    ASSERT_EQ(result, "CloudLabelDetector");
+}
+
+/**
+ * @tc.name: TestConcurrentCreate001
+ * @tc.desc: Verify that the objects of a class are created and destroyed concurrently within the instance limit.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManagerTest, TestConcurrentCreate001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. Register a directory with some valid plugin packages.
+     * @tc.expected: step1. The directory was registered successfully.
+     */
+    PluginServer &pluginServer = DelayedRefSingleton<PluginServer>::GetInstance();
+    vector<string> pluginPaths = { "/system/etc/multimediaplugin/testplugins" };
+    uint32_t ret = pluginServer.Register(std::move(pluginPaths));
+    ASSERT_EQ(ret, SUCCESS);
+
+    /**
+     * @tc.steps: step2. Create and destroy the objects of a class with the max instance 3 in several threads.
+     * @tc.expected: step2. Each creation either succeeds or fails for the limit.
+     */
+    const string implClassName = "OHOS::PluginExample::CloudLabelDetector";
+    const uint32_t threadCount = 4;
+    const uint32_t loopCount = 200;
+    std::atomic<uint32_t> createdCount(0);
+    std::atomic<uint32_t> errorCount(0);
+    vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&pluginServer, &implClassName, &createdCount, &errorCount]() {
+            for (uint32_t j = 0; j < loopCount; j++) {
+                uint32_t errorCode;
+                AbsImageDetector *detector = pluginServer.CreateObject<AbsImageDetector>(implClassName, errorCode);
+                if (detector != nullptr) {
+                    createdCount++;
+                    delete detector;
+                } else if (errorCode != ERR_INSTANCE_LIMIT) {
+                    errorCount++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(errorCount, 0u);
+    ASSERT_NE(createdCount, 0u);
+
+    /**
+     * @tc.steps: step3. Create the objects of the class up to the limit again.
+     * @tc.expected: step3. All the slots were released, and the limit is still kept.
+     */
+    uint32_t errorCode;
+    vector<AbsImageDetector *> detectors;
+    for (uint32_t i = 0; i < 3; i++) {
+        detectors.push_back(pluginServer.CreateObject<AbsImageDetector>(implClassName, errorCode));
+        EXPECT_NE(detectors.back(), nullptr);
+    }
+    AbsImageDetector *overLimit = pluginServer.CreateObject<AbsImageDetector>(implClassName, errorCode);
+    EXPECT_EQ(overLimit, nullptr);
+    EXPECT_EQ(errorCode, ERR_INSTANCE_LIMIT);
+    delete overLimit;
+    for (auto detector : detectors) {
+        delete detector;
+    }
+}
+
 // ------------------------------- private method -------------------------------
 /*
  * Feature: MultiMedia
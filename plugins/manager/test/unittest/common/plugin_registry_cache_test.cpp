@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "directory_ex.h"
+#include "plugin_registry_cache.h"
+
+using std::string;
+using std::vector;
+using namespace testing::ext;
+using namespace OHOS::MultimediaPlugin;
+
+static const string TEST_ROOT_DIR = "/data/test/plugin_registry_cache_test/";
+static const string TEST_PLUGIN_DIR = TEST_ROOT_DIR + "plugins";
+static const string TEST_CACHE_DIR = TEST_ROOT_DIR + "cache";
+static const string TEST_PRIVATE_CACHE_DIR = TEST_CACHE_DIR + "/multimediaplugin";  // created by the cache.
+static const string TEST_METADATA_PATH = TEST_PLUGIN_DIR + "/libtestplugin.pluginmeta";
+static const string TEST_LIBRARY_PATH = TEST_PLUGIN_DIR + "/libtestplugin.z.so";
+static const string TEST_METADATA = "{\"packageName\":\"LibTestPlugin\",\"version\":\"1.0.0.0\","
+                                    "\"targetVersion\":\"1.0.0.0\",\"libraryPath\":\"libtestplugin.z.so\"}";
+static constexpr uid_t FOREIGN_UID = 1;  // the daemon user, any user other than the test one.
+
+class PluginRegistryCacheTest : public testing::Test {
+public:
+    PluginRegistryCacheTest() {}
+    ~PluginRegistryCacheTest() {}
+    void SetUp();
+    void TearDown();
+
+    static bool WriteFile(const string &path, const string &content, bool append = false);
+    static void SaveTestCache(PluginRegistryCache &cache);
+};
+
+void PluginRegistryCacheTest::SetUp(void)
+{
+    OHOS::ForceRemoveDirectory(TEST_ROOT_DIR);
+    OHOS::ForceCreateDirectory(TEST_PLUGIN_DIR);
+    OHOS::ForceCreateDirectory(TEST_CACHE_DIR);
+    WriteFile(TEST_METADATA_PATH, TEST_METADATA);
+    WriteFile(TEST_LIBRARY_PATH, "library");
+}
+
+void PluginRegistryCacheTest::TearDown(void)
+{
+    OHOS::ForceRemoveDirectory(TEST_ROOT_DIR);
+}
+
+bool PluginRegistryCacheTest::WriteFile(const string &path, const string &content, bool append)
+{
+    std::ofstream file(path, append ? (std::ios::binary | std::ios::app) : (std::ios::binary | std::ios::trunc));
+    if (!file.is_open()) {
+        return false;
+    }
+    file << content;
+    return file.good();
+}
+
+void PluginRegistryCacheTest::SaveTestCache(PluginRegistryCache &cache)
+{
+    PluginRegistryEntry entry;
+    entry.metadataPath = TEST_METADATA_PATH;
+    entry.libraryPath = TEST_LIBRARY_PATH;
+    entry.metadata = nlohmann::json::parse(TEST_METADATA);
+    cache.Save({ TEST_METADATA_PATH, TEST_LIBRARY_PATH }, { entry });
+}
+
+/**
+ * @tc.name: RegistryCacheHit001
+ * @tc.desc: Load the registry cache saved before, the directory and its files are not changed.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginRegistryCacheTest, RegistryCacheHit001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. load the cache before it is saved.
+     * @tc.expected: step1. no cache.
+     */
+    PluginRegistryCache cache(TEST_PLUGIN_DIR, TEST_CACHE_DIR);
+    vector<PluginRegistryEntry> entries;
+    ASSERT_EQ(cache.Load(entries), false);
+    /**
+     * @tc.steps: step2. save the cache, then load it.
+     * @tc.expected: step2. the cache is private to the user, the loaded entry is the same as the saved one.
+     */
+    SaveTestCache(cache);
+    struct stat dirStat;
+    ASSERT_EQ(lstat(TEST_PRIVATE_CACHE_DIR.c_str(), &dirStat), 0);
+    ASSERT_EQ(dirStat.st_uid, geteuid());
+    ASSERT_EQ(dirStat.st_mode & (S_IRWXG | S_IRWXO), 0u);
+    ASSERT_EQ(cache.Load(entries), true);
+    ASSERT_EQ(entries.size(), 1u);
+    ASSERT_EQ(entries[0].metadataPath, TEST_METADATA_PATH);
+    ASSERT_EQ(entries[0].libraryPath, TEST_LIBRARY_PATH);
+    ASSERT_EQ(entries[0].metadata, nlohmann::json::parse(TEST_METADATA));
+    /**
+     * @tc.steps: step3. load the cache by another cache object of the same directory.
+     * @tc.expected: step3. the cache is hit.
+     */
+    PluginRegistryCache otherCache(TEST_PLUGIN_DIR, TEST_CACHE_DIR);
+    vector<PluginRegistryEntry> otherEntries;
+    ASSERT_EQ(otherCache.Load(otherEntries), true);
+    ASSERT_EQ(otherEntries.size(), 1u);
+}
+
+/**
+ * @tc.name: RegistryCacheStale001
+ * @tc.desc: The registry cache is stale once the plugin library or the metadata file is changed.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginRegistryCacheTest, RegistryCacheStale001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. save the cache, then replace the plugin library.
+     * @tc.expected: step1. the cache is stale.
+     */
+    PluginRegistryCache cache(TEST_PLUGIN_DIR, TEST_CACHE_DIR);
+    SaveTestCache(cache);
+    ASSERT_EQ(WriteFile(TEST_LIBRARY_PATH, "replaced", true), true);
+    vector<PluginRegistryEntry> entries;
+    ASSERT_EQ(cache.Load(entries), false);
+    ASSERT_EQ(entries.empty(), true);
+    /**
+     * @tc.steps: step2. save the cache again, then change the metadata file.
+     * @tc.expected: step2. the cache is hit before the change and stale after it.
+     */
+    SaveTestCache(cache);
+    ASSERT_EQ(cache.Load(entries), true);
+    entries.clear();
+    ASSERT_EQ(WriteFile(TEST_METADATA_PATH, " ", true), true);
+    ASSERT_EQ(cache.Load(entries), false);
+    /**
+     * @tc.steps: step3. save the cache again, then remove the plugin library.
+     * @tc.expected: step3. the cache is stale.
+     */
+    SaveTestCache(cache);
+    ASSERT_EQ(unlink(TEST_LIBRARY_PATH.c_str()), 0);
+    ASSERT_EQ(cache.Load(entries), false);
+}
+
+/**
+ * @tc.name: RegistryCacheCorrupt001
+ * @tc.desc: The corrupted registry cache is not loaded, and is replaced by the next saving.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginRegistryCacheTest, RegistryCacheCorrupt001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. save the cache, then truncate it.
+     * @tc.expected: step1. the cache is not loaded.
+     */
+    PluginRegistryCache cache(TEST_PLUGIN_DIR, TEST_CACHE_DIR);
+    SaveTestCache(cache);
+    struct stat cacheStat;
+    ASSERT_EQ(stat(cache.GetCachePath().c_str(), &cacheStat), 0);
+    ASSERT_EQ(truncate(cache.GetCachePath().c_str(), cacheStat.st_size / 2), 0);
+    vector<PluginRegistryEntry> entries;
+    ASSERT_EQ(cache.Load(entries), false);
+    ASSERT_EQ(entries.empty(), true);
+    /**
+     * @tc.steps: step2. overwrite the cache by garbage.
+     * @tc.expected: step2. the cache is not loaded.
+     */
+    ASSERT_EQ(WriteFile(cache.GetCachePath(), string(static_cast<size_t>(cacheStat.st_size), '\xff')), true);
+    ASSERT_EQ(cache.Load(entries), false);
+    /**
+     * @tc.steps: step3. save the cache again.
+     * @tc.expected: step3. the cache is hit.
+     */
+    SaveTestCache(cache);
+    ASSERT_EQ(cache.Load(entries), true);
+    ASSERT_EQ(entries.size(), 1u);
+}
+
+/**
+ * @tc.name: RegistryCacheForeign001
+ * @tc.desc: The registry cache in a directory or a file accessible to the other users is not trusted.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginRegistryCacheTest, RegistryCacheForeign001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. save the cache, then open the cache directory to the other users.
+     * @tc.expected: step1. the cache is not loaded, and not saved into that directory.
+     */
+    PluginRegistryCache cache(TEST_PLUGIN_DIR, TEST_CACHE_DIR);
+    SaveTestCache(cache);
+    ASSERT_EQ(chmod(TEST_PRIVATE_CACHE_DIR.c_str(), S_IRWXU | S_IRWXG | S_IRWXO | S_ISVTX), 0);
+    vector<PluginRegistryEntry> entries;
+    ASSERT_EQ(cache.Load(entries), false);
+    ASSERT_EQ(unlink(cache.GetCachePath().c_str()), 0);
+    SaveTestCache(cache);
+    ASSERT_EQ(access(cache.GetCachePath().c_str(), F_OK), -1);
+    /**
+     * @tc.steps: step2. make the cache directory private again, then open the cache file to the other users.
+     * @tc.expected: step2. the cache is not loaded.
+     */
+    ASSERT_EQ(chmod(TEST_PRIVATE_CACHE_DIR.c_str(), S_IRWXU), 0);
+    SaveTestCache(cache);
+    ASSERT_EQ(cache.Load(entries), true);
+    entries.clear();
+    ASSERT_EQ(chmod(cache.GetCachePath().c_str(), S_IRUSR | S_IWUSR | S_IWOTH), 0);
+    ASSERT_EQ(cache.Load(entries), false);
+    /**
+     * @tc.steps: step3. replace the cache file by a symbolic link to a cache saved by the user.
+     * @tc.expected: step3. the link is not followed.
+     */
+    ASSERT_EQ(unlink(cache.GetCachePath().c_str()), 0);
+    ASSERT_EQ(OHOS::ForceCreateDirectory(TEST_ROOT_DIR + "linked"), true);
+    PluginRegistryCache linkedCache(TEST_PLUGIN_DIR, TEST_ROOT_DIR + "linked");
+    SaveTestCache(linkedCache);
+    ASSERT_EQ(linkedCache.Load(entries), true);
+    entries.clear();
+    ASSERT_EQ(symlink(linkedCache.GetCachePath().c_str(), cache.GetCachePath().c_str()), 0);
+    ASSERT_EQ(cache.Load(entries), false);
+    /**
+     * @tc.steps: step4. give the cache directory and then the cache file to another user, only root can do that.
+     * @tc.expected: step4. the cache is not loaded.
+     */
+    if (geteuid() != 0) {
+        return;
+    }
+    ASSERT_EQ(unlink(cache.GetCachePath().c_str()), 0);
+    SaveTestCache(cache);
+    ASSERT_EQ(cache.Load(entries), true);
+    entries.clear();
+    ASSERT_EQ(chown(TEST_PRIVATE_CACHE_DIR.c_str(), FOREIGN_UID, static_cast<gid_t>(-1)), 0);
+    ASSERT_EQ(cache.Load(entries), false);
+    ASSERT_EQ(chown(TEST_PRIVATE_CACHE_DIR.c_str(), geteuid(), static_cast<gid_t>(-1)), 0);
+    ASSERT_EQ(cache.Load(entries), true);
+    entries.clear();
+    ASSERT_EQ(chown(cache.GetCachePath().c_str(), FOREIGN_UID, static_cast<gid_t>(-1)), 0);
+    ASSERT_EQ(cache.Load(entries), false);
+}
+
+/**
+ * @tc.name: RegistryCacheDir001
+ * @tc.desc: The registry cache is only kept in the cache dir given by the caller when it is writable.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginRegistryCacheTest, RegistryCacheDir001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. save and load the cache without a cache dir.
+     * @tc.expected: step1. the cache is disabled.
+     */
+    PluginRegistryCache noDirCache(TEST_PLUGIN_DIR, "");
+    SaveTestCache(noDirCache);
+    vector<PluginRegistryEntry> entries;
+    ASSERT_EQ(noDirCache.GetCachePath().empty(), true);
+    ASSERT_EQ(noDirCache.Load(entries), false);
+    /**
+     * @tc.steps: step2. save and load the cache in a cache dir which doesn't exist.
+     * @tc.expected: step2. nothing is written and the cache is not loaded.
+     */
+    const string missingDir = TEST_ROOT_DIR + "missing";
+    PluginRegistryCache missingDirCache(TEST_PLUGIN_DIR, missingDir);
+    SaveTestCache(missingDirCache);
+    ASSERT_EQ(access(missingDir.c_str(), F_OK), -1);
+    ASSERT_EQ(missingDirCache.Load(entries), false);
+    /**
+     * @tc.steps: step3. open the cache dir to the group like an application cache dir, then save and load the cache.
+     * @tc.expected: step3. the cache is kept in a private dir in it, and is hit.
+     */
+    ASSERT_EQ(chmod(TEST_CACHE_DIR.c_str(), S_IRWXU | S_IRWXG | S_IXOTH), 0);
+    PluginRegistryCache cache(TEST_PLUGIN_DIR, TEST_CACHE_DIR);
+    SaveTestCache(cache);
+    ASSERT_EQ(cache.GetCachePath().compare(0, TEST_PRIVATE_CACHE_DIR.size(), TEST_PRIVATE_CACHE_DIR), 0);
+    ASSERT_EQ(cache.Load(entries), true);
+    ASSERT_EQ(entries.size(), 1u);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "abs_image_detector.h"
+#include "plugin_errors.h"
+#include "plugin_server.h"
+
+// the interface functions of plugin_example3 linked into the test, renamed by the static plugin build.
+extern "C" {
+bool PluginStaticExternalStart();
+void PluginStaticExternalStop();
+OHOS::MultimediaPlugin::PluginClassBase *PluginStaticExternalCreate(const std::string &className);
+}
+
+using OHOS::DelayedRefSingleton;
+using std::map;
+using std::string;
+using std::vector;
+using namespace testing::ext;
+using namespace OHOS::MultimediaPlugin;
+using namespace OHOS::PluginExample;
+
+// the metadata of the package names a library which is not installed, so it can only be created statically.
+static const string STATIC_PACKAGE_NAME = "plugin_static";
+static const string STATIC_PLUGIN_PATH = "/system/etc/multimediaplugin/teststaticplugins";
+
+class PluginStaticTest : public testing::Test {
+public:
+    PluginStaticTest() {}
+    ~PluginStaticTest() {}
+};
+
+/**
+ * @tc.name: TestStaticPlugin001
+ * @tc.desc: Verify that the objects of a static plugin are created by its registered functions without its library.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginStaticTest, TestStaticPlugin001, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. Register the functions of the static plugin, then register them again and invalid ones.
+     * @tc.expected: step1. The first registration succeeds, the others fail.
+     */
+    PluginServer &pluginServer = DelayedRefSingleton<PluginServer>::GetInstance();
+    uint32_t ret = pluginServer.RegisterStaticPlugin(STATIC_PACKAGE_NAME, PluginStaticExternalStart,
+                                                     PluginStaticExternalStop, PluginStaticExternalCreate);
+    ASSERT_EQ(ret, SUCCESS);
+    ret = pluginServer.RegisterStaticPlugin(STATIC_PACKAGE_NAME, PluginStaticExternalStart,
+                                            PluginStaticExternalStop, PluginStaticExternalCreate);
+    ASSERT_EQ(ret, ERR_GENERAL);
+    ret = pluginServer.RegisterStaticPlugin("plugin_static_invalid", PluginStaticExternalStart,
+                                            PluginStaticExternalStop, nullptr);
+    ASSERT_EQ(ret, ERR_INVALID_PARAMETER);
+
+    /**
+     * @tc.steps: step2. Register the directory with the metadata of the static plugin.
+     * @tc.expected: step2. The directory is registered, and the plugin is not started before it is used.
+     */
+    vector<string> pluginPaths = { STATIC_PLUGIN_PATH };
+    ret = pluginServer.Register(std::move(pluginPaths));
+    ASSERT_EQ(ret, SUCCESS);
+    // "labelNum" means capability name, 256 exists in the metadata of the static plugin.
+    map<string, AttrData> capabilities = { { "labelNum", AttrData(static_cast<uint32_t>(256)) } };
+    ASSERT_EQ(pluginServer.IsPluginActive<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilities), false);
+
+    /**
+     * @tc.steps: step3. Create an object of the static plugin by service type and capabilities.
+     * @tc.expected: step3. The object is created by the linked functions, and the plugin is started.
+     */
+    uint32_t errorCode = ERR_GENERAL;
+    AbsImageDetector *labelDetector =
+        pluginServer.CreateObject<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilities, errorCode);
+    ASSERT_NE(labelDetector, nullptr);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_EQ(pluginServer.IsPluginActive<AbsImageDetector>(AbsImageDetector::SERVICE_LABEL, capabilities), true);
+    labelDetector->Prepare();
+    string result = labelDetector->Process();
+    delete labelDetector;
+    ASSERT_EQ(result, "LabelDetector3");
+
+    /**
+     * @tc.steps: step4. Create an object of the static plugin by class name.
+     * @tc.expected: step4. The object is created.
+     */
+    labelDetector = pluginServer.CreateObject<AbsImageDetector>("OHOS::PluginExample::LabelDetector3", errorCode);
+    ASSERT_NE(labelDetector, nullptr);
+    result = labelDetector->Process();
+    delete labelDetector;
+    ASSERT_EQ(result, "LabelDetector3");
+}